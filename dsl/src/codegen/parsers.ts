@@ -506,6 +506,26 @@ function parseEndpointFile(tomlPath: string, env: string): EndpointEntry[] {
 
     const resolver: StaticResolver = { type: "static", host, port };
 
+    // Read replicas (optional)
+    const rawReplicas = resolverObj["replicas"];
+    if (rawReplicas !== undefined) {
+      if (!Array.isArray(rawReplicas)) {
+        throw new Error(`endpoint ${endpoint_id}: resolver.replicas must be an array`);
+      }
+      resolver.replicas = rawReplicas.map((raw, i) => {
+        if (typeof raw !== "object" || raw === null) {
+          throw new Error(`endpoint ${endpoint_id}: resolver.replicas[${i}] must be an object`);
+        }
+        const replicaObj = raw as Record<string, unknown>;
+        const replicaHost = assertString(replicaObj["host"], `resolver.replicas[${i}].host`);
+        const replicaPort = assertInteger(replicaObj["port"], `resolver.replicas[${i}].port`);
+        if (replicaPort < 1 || replicaPort > 65535) {
+          throw new Error(`endpoint ${endpoint_id}: invalid replica port ${replicaPort} (must be 1-65535)`);
+        }
+        return { host: replicaHost, port: replicaPort };
+      });
+    }
+
     // Parse policy (optional fields)
     const policy: EndpointPolicy = {};
     const rawPolicy = r["policy"];
@@ -523,6 +543,27 @@ function parseEndpointFile(tomlPath: string, env: string): EndpointEntry[] {
       if (policyObj["request_timeout_ms"] !== undefined) {
         policy.request_timeout_ms = assertInteger(policyObj["request_timeout_ms"], "policy.request_timeout_ms");
       }
+      if (policyObj["batch_window_us"] !== undefined) {
+        policy.batch_window_us = assertInteger(policyObj["batch_window_us"], "policy.batch_window_us");
+      }
+      if (policyObj["batch_max_ops"] !== undefined) {
+        policy.batch_max_ops = assertInteger(policyObj["batch_max_ops"], "policy.batch_max_ops");
+      }
+      if (policyObj["pool_size"] !== undefined) {
+        policy.pool_size = assertInteger(policyObj["pool_size"], "policy.pool_size");
+      }
+      if (policyObj["adaptive_inflight"] !== undefined) {
+        policy.adaptive_inflight = assertBoolean(policyObj["adaptive_inflight"], "policy.adaptive_inflight");
+      }
+      if (policyObj["min_inflight"] !== undefined) {
+        policy.min_inflight = assertInteger(policyObj["min_inflight"], "policy.min_inflight");
+      }
+      if (policyObj["hedge_percentile"] !== undefined) {
+        policy.hedge_percentile = assertInteger(policyObj["hedge_percentile"], "policy.hedge_percentile");
+      }
+      if (policyObj["hedge_budget_pct"] !== undefined) {
+        policy.hedge_budget_pct = assertInteger(policyObj["hedge_budget_pct"], "policy.hedge_budget_pct");
+      }
     }
 
     // Uniqueness checks
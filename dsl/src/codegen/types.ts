@@ -95,16 +95,29 @@ export interface TaskRegistry {
 }
 
 // Endpoint types
+export interface ReplicaAddress {
+  host: string;
+  port: number;
+}
+
 export interface StaticResolver {
   type: "static";
   host: string;
   port: number;
+  replicas?: ReplicaAddress[];  // read replicas for hedged reads
 }
 
 export interface EndpointPolicy {
   max_inflight?: number;
   connect_timeout_ms?: number;
   request_timeout_ms?: number;
+  batch_window_us?: number;   // async micro-batching window (0 = off)
+  batch_max_ops?: number;     // flush the window early at this many ops
+  pool_size?: number;         // async connections per endpoint per loop
+  adaptive_inflight?: boolean;  // async limit adapts to RTT/errors
+  min_inflight?: number;      // floor for the adaptive limit
+  hedge_percentile?: number;  // hedge reads slower than this RTT percentile
+  hedge_budget_pct?: number;  // max hedged reads, % of all reads
 }
 
 export interface EndpointEntry {
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "async_io_clients.h"
+#include "cancellation.h"
 #include "coro_task.h"
 #include "dag_scheduler.h"  // For ExecutionResult
 #include "deadline.h"
@@ -49,12 +53,35 @@ struct ExecCtxAsync {
   // Endpoint registry for IO configuration lookup
   const rankd::EndpointRegistry* endpoints = nullptr;
 
+  // Per-request arena (RequestArena) for column storage; null = heap
+  std::shared_ptr<std::pmr::memory_resource> arena;
+
+  // Keys descendants may read from this node's output; null = all
+  std::shared_ptr<const std::vector<uint32_t>> live_keys;
+
+  // Per-node IO counters (nullable)
+  rankd::NodeIoStats* io_stats = nullptr;
+
   // Async-specific: EventLoop for coroutine scheduling
   EventLoop* loop = nullptr;
 
   // Async-specific: Process-level async client cache
   // Shared across all requests on this EventLoop for proper inflight limiting
   AsyncIoClients* async_clients = nullptr;
+
+  // Cancelled once the request fails or times out. Pass it to Redis commands
+  // and sleeps so they complete early instead of at the slowest IO.
+  CancellationToken cancel;
+
+  bool isKeyLive(uint32_t key_id) const {
+    return !live_keys ||
+           std::binary_search(live_keys->begin(), live_keys->end(), key_id);
+  }
+  void addBytesReceived(uint64_t bytes) const {
+    if (io_stats) {
+      io_stats->bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
 };
 
 /**
@@ -88,11 +115,16 @@ using AsyncTaskFn = std::function<Task<rankd::RowSet>(
  * - request_deadline: Global deadline for entire request
  * - node_timeout: Per-node timeout applied to each node
  * - If either is exceeded, nodes fail with timeout error
+ * - The first failure (error or timeout) cancels ctx.cancel for all nodes,
+ *   so their pending Redis commands and sleeps complete right away
  *
  * @param plan The DAG plan to execute
  * @param ctx Async execution context with EventLoop and AsyncIoClients
  * @param request_deadline Optional request-level deadline
  * @param node_timeout Optional per-node timeout
+ * @param max_nodes_inflight Max concurrently running sync (CPU) nodes
+ *        (0 = default based on CPU pool size). When more are ready, the
+ *        critical path starts first. Async/IO nodes are not capped.
  * @return ExecutionResult with outputs and schema deltas
  *
  * MUST be co_awaited from a coroutine running on the EventLoop.
@@ -101,7 +133,8 @@ Task<rankd::ExecutionResult> execute_plan_async(
     const rankd::Plan& plan,
     const ExecCtxAsync& ctx,
     OptionalDeadline request_deadline = std::nullopt,
-    std::optional<std::chrono::milliseconds> node_timeout = std::nullopt);
+    std::optional<std::chrono::milliseconds> node_timeout = std::nullopt,
+    int max_nodes_inflight = 0);
 
 /**
  * Blocking wrapper for execute_plan_async.
@@ -120,6 +153,9 @@ Task<rankd::ExecutionResult> execute_plan_async(
  * @param stats Optional execution stats
  * @param request_deadline Optional request-level deadline
  * @param node_timeout Optional per-node timeout
+ * @param arena Optional per-request arena for column storage
+ * @param max_nodes_inflight Max concurrently running sync (CPU) nodes
+ *        (0 = default based on CPU pool size)
  * @return ExecutionResult with outputs and schema deltas
  */
 rankd::ExecutionResult execute_plan_async_blocking(
@@ -133,6 +169,8 @@ rankd::ExecutionResult execute_plan_async_blocking(
     const rankd::RequestContext& request,
     rankd::ExecStats* stats = nullptr,
     OptionalDeadline request_deadline = std::nullopt,
-    std::optional<std::chrono::milliseconds> node_timeout = std::nullopt);
+    std::optional<std::chrono::milliseconds> node_timeout = std::nullopt,
+    std::shared_ptr<std::pmr::memory_resource> arena = nullptr,
+    int max_nodes_inflight = 0);
 
 }  // namespace ranking
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <coroutine>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <queue>
 
 #include "event_loop.h"
@@ -20,6 +24,17 @@ namespace ranking {
  * from the EventLoop thread. The design assumes coroutines using this limiter
  * are driven by the event loop, so no locks are needed.
  *
+ * Adaptive mode (enable_adaptive): the permit count moves between a floor and
+ * the constructor's max_permits, driven by on_sample() reports of each
+ * operation's round trip (AIMD on RTT, Vegas-style congestion signal):
+ *   - congestion = a dropped op (timeout / connection error) or an RTT above
+ *     kRttTolerance x the windowed minimum RTT. The limit is multiplied by
+ *     kBackoffRatio, at most once per RTT so one slow burst does not compound.
+ *   - otherwise the limit grows by 1/limit per sample (about +1 per round
+ *     trip of a full window), but only while at least half of it is in use.
+ * Shrinking never revokes permits: releases above the new limit are simply
+ * not handed on. Waiters stay strictly FIFO in both modes.
+ *
  * Usage:
  *   AsyncInflightLimiter limiter(64);  // max 64 concurrent ops
  *
@@ -70,6 +85,9 @@ class AsyncInflightLimiter {
     // Check if guard holds a permit
     explicit operator bool() const { return limiter_ != nullptr; }
 
+    // Limiter the permit belongs to (nullptr if none)
+    AsyncInflightLimiter* limiter() const { return limiter_; }
+
    private:
     AsyncInflightLimiter* limiter_;
   };
@@ -102,7 +120,15 @@ class AsyncInflightLimiter {
    *
    * @param max_permits Maximum number of concurrent operations (must be > 0)
    */
-  explicit AsyncInflightLimiter(size_t max_permits) : max_permits_(max_permits), current_(0) {}
+  explicit AsyncInflightLimiter(size_t max_permits)
+      : max_permits_(max_permits), current_(0), ceiling_(max_permits) {}
+
+  using Clock = std::chrono::steady_clock;
+
+  // Adaptive mode tuning
+  static constexpr double kRttTolerance = 2.0;  // RTT over this x min RTT = congested
+  static constexpr double kBackoffRatio = 0.9;  // Multiplicative decrease
+  static constexpr size_t kRttWindowSamples = 500;  // Min-RTT window length
 
   /**
    * Destructor - asserts no pending waiters or active permits.
@@ -140,7 +166,8 @@ class AsyncInflightLimiter {
    * @return true if permit acquired, false if at limit
    */
   bool try_acquire() {
-    if (current_ < max_permits_) {
+    // Queued waiters go first (FIFO), even if the limit just grew
+    if (current_ < max_permits_ && waiters_.empty()) {
       ++current_;
       return true;
     }
@@ -154,27 +181,108 @@ class AsyncInflightLimiter {
    * Called automatically by Guard destructor.
    */
   void release() {
-    if (!waiters_.empty()) {
+    if (!waiters_.empty() && current_ <= max_permits_) {
       // Grant permit directly to next waiter (no decrement/increment dance)
-      auto h = waiters_.front();
-      waiters_.pop();
-      h.resume();
+      resume_next();
     } else {
-      --current_;
+      --current_;  // Over a shrunk limit, or nobody waiting
     }
   }
 
-  // Accessors for testing
+  /**
+   * Switch to adaptive mode: the limit starts at max_permits and moves
+   * within [min_permits, max_permits] as on_sample() reports arrive.
+   */
+  void enable_adaptive(size_t min_permits) {
+    adaptive_ = true;
+    floor_ = std::clamp<size_t>(min_permits, 1, ceiling_);
+    limit_ = static_cast<double>(max_permits_);
+  }
+
+  /**
+   * Report one completed operation (no-op unless adaptive).
+   *
+   * @param rtt Time from issuing the operation to its reply
+   * @param dropped The operation timed out or lost its connection
+   */
+  void on_sample(std::chrono::nanoseconds rtt, bool dropped) {
+    if (!adaptive_) return;
+    auto now = Clock::now();
+    int64_t rtt_ns = rtt.count();
+
+    if (!dropped) {
+      // Windowed minimum, so the baseline follows slow shifts in the backend
+      rtt_min_ns_ = std::min(rtt_min_ns_, rtt_ns);
+      window_min_ns_ = std::min(window_min_ns_, rtt_ns);
+      if (++window_samples_ >= kRttWindowSamples) {
+        rtt_min_ns_ = window_min_ns_;
+        window_min_ns_ = std::numeric_limits<int64_t>::max();
+        window_samples_ = 0;
+      }
+    }
+
+    bool congested =
+        dropped || static_cast<double>(rtt_ns) > kRttTolerance * static_cast<double>(rtt_min_ns_);
+    if (congested) {
+      if (now - last_decrease_ >= rtt) {
+        limit_ = std::max(static_cast<double>(floor_), limit_ * kBackoffRatio);
+        last_decrease_ = now;
+      }
+    } else if (static_cast<double>(current_) * 2 >= limit_) {
+      limit_ = std::min(static_cast<double>(ceiling_), limit_ + 1.0 / limit_);
+    }
+
+    max_permits_ = static_cast<size_t>(limit_);
+    // A raised limit admits queued waiters right away
+    while (!waiters_.empty() && current_ < max_permits_) {
+      ++current_;
+      resume_next();
+    }
+  }
+
+  // Current permit limit (moves in adaptive mode)
   size_t max_permits() const { return max_permits_; }
   size_t current() const { return current_; }
   size_t waiters_count() const { return waiters_.size(); }
+  bool adaptive() const { return adaptive_; }
+
+  // Smoothed time waiters spent queued for a permit (EWMA, 1/8 weight)
+  std::chrono::microseconds queue_delay() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::nanoseconds(static_cast<int64_t>(queue_delay_ns_)));
+  }
 
  private:
-  void queue_waiter(std::coroutine_handle<> h) { waiters_.push(h); }
+  struct Waiter {
+    std::coroutine_handle<> handle;
+    Clock::time_point queued_at;
+  };
+
+  void queue_waiter(std::coroutine_handle<> h) { waiters_.push(Waiter{h, Clock::now()}); }
+
+  // Hand a permit (already counted in current_) to the oldest waiter
+  void resume_next() {
+    Waiter w = waiters_.front();
+    waiters_.pop();
+    double delay_ns = static_cast<double>((Clock::now() - w.queued_at).count());
+    queue_delay_ns_ += (delay_ns - queue_delay_ns_) / 8;
+    w.handle.resume();
+  }
 
   size_t max_permits_;
   size_t current_;
-  std::queue<std::coroutine_handle<>> waiters_;
+  std::queue<Waiter> waiters_;
+  double queue_delay_ns_ = 0;
+
+  // Adaptive mode
+  bool adaptive_ = false;
+  size_t ceiling_;
+  size_t floor_ = 1;
+  double limit_ = 0;
+  int64_t rtt_min_ns_ = std::numeric_limits<int64_t>::max();
+  int64_t window_min_ns_ = std::numeric_limits<int64_t>::max();
+  size_t window_samples_ = 0;
+  Clock::time_point last_decrease_{};
 };
 
 }  // namespace ranking
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include "async_redis_client.h"
 #include "endpoint_registry.h"
@@ -16,7 +18,19 @@ namespace ranking {
  *
  * Similar to the synchronous IoClients, but for async clients that work
  * with the EventLoop. Each request execution owns an AsyncIoClients instance
- * that caches connected async clients for the lifetime of the request.
+ * that caches connected async clients for the lifetime of the request (or a
+ * process-level instance shared by all requests on the loop, as in bench mode).
+ *
+ * Connection pools: each Redis endpoint gets policy.pool_size connections
+ * (default 1), all opened on first use (or up front via WarmUp()). GetRedis()
+ * hands out the connection with the fewest outstanding commands, breaking
+ * ties round-robin, so one slow reply does not head-of-line block the whole
+ * endpoint. The endpoint's max_inflight is split evenly across connections.
+ *
+ * Reconnection: a connection that failed or dropped is replaced in the
+ * background (the new client connects asynchronously) the next time the pool
+ * is used, at most once per kReconnectBackoff per slot. Clients are shared:
+ * a replaced client lives on until the last task holding it lets go.
  *
  * Thread safety: This class is NOT thread-safe. All operations must be called
  * from the EventLoop thread. The design assumes a single event loop drives
@@ -26,7 +40,7 @@ namespace ranking {
  *   AsyncIoClients clients;
  *   auto result = clients.GetRedis(loop, endpoints, "ep_0001");
  *   if (!result) { ... handle error ... }
- *   AsyncRedisClient& redis = **result;
+ *   AsyncRedisClient& redis = **result;  // result keeps the client alive
  *   auto value = co_await redis.HGet("key", "field");
  */
 class AsyncIoClients {
@@ -40,22 +54,37 @@ class AsyncIoClients {
   AsyncIoClients(AsyncIoClients&&) = delete;
   AsyncIoClients& operator=(AsyncIoClients&&) = delete;
 
+  // Minimum delay between reconnect attempts for one pool slot
+  static constexpr std::chrono::milliseconds kReconnectBackoff{100};
+
   /**
    * Get or create an async Redis client for the given endpoint.
    *
+   * Picks the least-loaded connection of the endpoint's pool. Keep the
+   * returned pointer while using the client; fetch again for later requests.
+   *
    * MUST be called on the EventLoop thread.
    *
    * @param loop EventLoop to use for async operations
    * @param endpoints EndpointRegistry for configuration lookup
    * @param endpoint_id The endpoint ID (e.g., "ep_0001")
-   * @return Pointer to client on success, or error message
+   * @return Shared client on success, or error message
    */
-  std::expected<AsyncRedisClient*, std::string> GetRedis(EventLoop& loop,
+  std::expected<std::shared_ptr<AsyncRedisClient>, std::string> GetRedis(EventLoop& loop,
                                                           const rankd::EndpointRegistry& endpoints,
                                                           std::string_view endpoint_id);
 
   /**
-   * Get an existing async Redis client (no creation).
+   * Open the connection pool of every Redis endpoint ahead of the first
+   * request. Endpoints that fail to connect are skipped (GetRedis reports the
+   * error later).
+   *
+   * MUST be called on the EventLoop thread.
+   */
+  void WarmUp(EventLoop& loop, const rankd::EndpointRegistry& endpoints);
+
+  /**
+   * Get an existing async Redis client (no creation or reconnection).
    *
    * @param endpoint_id The endpoint ID
    * @return Pointer to client if exists, nullptr otherwise
@@ -69,11 +98,46 @@ class AsyncIoClients {
    */
   void Clear();
 
-  // Number of cached Redis clients
-  size_t redis_count() const { return redis_clients_.size(); }
+  // Number of Redis endpoints with a connection pool
+  size_t redis_count() const { return redis_pools_.size(); }
+
+  // Open Redis connections across all pools
+  size_t redis_connection_count() const;
+
+  // Connections replaced after a failure or disconnect
+  uint64_t redis_reconnects() const { return reconnects_; }
+
+  // Redis commands requested across all pools, including replaced connections
+  uint64_t redis_commands() const;
+
+  // Inflight limit summed over an endpoint's connections (0 if no pool)
+  size_t redis_inflight_limit(std::string_view endpoint_id) const;
+  // Worst smoothed permit queueing delay among an endpoint's connections
+  std::chrono::microseconds redis_queue_delay(std::string_view endpoint_id) const;
+  // Hedged reads sent to replicas, and those that beat the primary, summed
+  // over an endpoint's connections
+  uint64_t redis_hedges_issued(std::string_view endpoint_id) const;
+  uint64_t redis_hedges_won(std::string_view endpoint_id) const;
 
  private:
-  std::unordered_map<std::string, std::unique_ptr<AsyncRedisClient>> redis_clients_;
+  struct RedisPool {
+    rankd::EndpointSpec spec;  // Per-connection spec (max_inflight split)
+    std::vector<std::shared_ptr<AsyncRedisClient>> conns;
+    std::vector<std::chrono::steady_clock::time_point> next_reconnect;
+    size_t next = 0;  // Round-robin start for ties
+  };
+
+  std::expected<RedisPool*, std::string> GetPool(EventLoop& loop,
+                                                 const rankd::EndpointRegistry& endpoints,
+                                                 std::string_view endpoint_id);
+  // Replace closed connections whose backoff has elapsed
+  void Reconnect(EventLoop& loop, RedisPool& pool);
+  // Least outstanding commands among open connections (round-robin on ties)
+  static const std::shared_ptr<AsyncRedisClient>& Pick(RedisPool& pool);
+
+  std::unordered_map<std::string, RedisPool> redis_pools_;
+  uint64_t reconnects_ = 0;
+  uint64_t retired_commands_ = 0;  // Counted by connections since replaced
 };
 
 }  // namespace ranking
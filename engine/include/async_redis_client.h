@@ -3,6 +3,7 @@
 #include <coroutine>
 #include <expected>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -10,6 +11,8 @@
 #include <vector>
 
 #include "async_inflight_limiter.h"
+#include "cancellation.h"
+#include "column_batch.h"
 #include "coro_task.h"
 #include "endpoint_registry.h"
 #include "event_loop.h"
@@ -20,6 +23,13 @@ struct redisReply;
 
 namespace ranking {
 
+// In-flight command table for single-flight coalescing (defined in .cpp)
+struct RedisSingleFlight;
+// Cross-request micro-batching window (defined in .cpp)
+struct RedisBatchWindow;
+// Replica connections and latency tracking for hedged reads (defined in .cpp)
+struct RedisHedger;
+
 /**
  * AsyncRedisClient - async Redis client using hiredis async API + libuv.
  *
@@ -31,14 +41,50 @@ namespace ranking {
  * from the EventLoop thread. The client is designed to be used with coroutines
  * running on the event loop.
  *
+ * Single-flight: a read identical to one already in flight on this client
+ * (same command bytes, e.g. concurrent requests hydrating the same user)
+ * is not sent again. It waits for the in-flight reply and gets a copy, so
+ * it costs neither a Redis round trip nor an inflight permit. Each caller
+ * keeps its own request timeout, counted from when it asked: a read that
+ * joins late is not failed by the leader's earlier deadline.
+ *
+ * Micro-batching: with policy.batch_window_us > 0, commands from all requests
+ * on this client are held for up to that long (or until batch_max_ops are
+ * pending) and then written to the connection back to back. This trades a
+ * bounded latency cost for fewer, larger socket writes at high QPS. Commands
+ * hold their inflight permit while waiting in the window.
+ *
+ * Adaptive inflight limit: with policy.adaptive_inflight, the permit count
+ * adapts between policy.min_inflight and max_inflight from each command's
+ * RTT and timeouts (see AsyncInflightLimiter). inflight_limiter() exposes
+ * the current limit and queueing delay.
+ *
+ * Hedged reads: when the endpoint lists resolver replicas and sets
+ * policy.hedge_percentile, a read that has not been answered within that
+ * percentile of recent RTTs is sent again to a replica (round-robin over
+ * connected ones). The first reply wins; the other is dropped. Hedges are
+ * budgeted to policy.hedge_budget_pct (default 5) percent of reads, and take
+ * no inflight permit. Replica connections are opened by Create() and are
+ * best effort: an unreachable replica is simply never hedged to.
+ *
+ * Cancellation: every command takes an optional CancellationToken. Once it
+ * is cancelled, the command completes at once with a "Cancelled" error,
+ * whether it is queued for a permit, held in the batching window or already
+ * sent; an in-flight command gives its permit back immediately and its late
+ * reply is dropped. A cancelled read that other callers have joined
+ * (single-flight) still returns at once; the command keeps running, with its
+ * permit, for them.
+ *
  * Fail-fast: No automatic reconnection. If connection fails, operations return
- * errors. The caller can check is_connected() and recreate the client if needed.
+ * errors. The caller can check is_closed() and recreate the client if needed
+ * (AsyncIoClients does this for its connection pools).
  *
  * IMPORTANT LIFETIME REQUIREMENTS:
  * 1. The AsyncRedisClient MUST outlive all in-flight operations. Destroying the
  *    client while Tasks are awaiting causes undefined behavior.
- * 2. Tasks returned by HGet/LRange/HGetAll MUST be awaited to completion.
- *    Destroying a Task mid-await causes undefined behavior.
+ * 2. Tasks returned by HGet/LRange/HGetAll (and the batch variants) MUST be
+ *    awaited to completion. Destroying a Task mid-await causes undefined
+ *    behavior.
  *
  * In practice: keep the client alive for the duration of the request, and
  * always co_await the returned Tasks before the request completes.
@@ -66,6 +112,13 @@ class AsyncRedisClient {
   template <typename T>
   using Result = std::expected<T, Error>;
 
+  // LRANGE reply decoded as int64 ids (see LRangeIds)
+  struct IdList {
+    std::shared_ptr<std::pmr::memory_resource> memory;  // Keeps `ids` storage alive
+    std::shared_ptr<rankd::IdColumn> ids;  // Elements that parsed as decimal ids
+    uint64_t bytes_received = 0;           // Payload bytes of all elements
+  };
+
   /**
    * Create a new async Redis client for the given endpoint.
    *
@@ -93,9 +146,11 @@ class AsyncRedisClient {
    * IMPORTANT: The returned Task MUST be awaited to completion. Do not destroy
    * or reassign the Task while a Redis command is in flight (undefined behavior).
    *
+   * @param cancel Completes the command early with a "Cancelled" error
    * @return Value if exists, nullopt if field doesn't exist, or error
    */
-  Task<Result<std::optional<std::string>>> HGet(std::string_view key, std::string_view field);
+  Task<Result<std::optional<std::string>>> HGet(std::string_view key, std::string_view field,
+                                                CancellationToken cancel = {});
 
   /**
    * LRANGE key start stop - get list elements in range.
@@ -104,7 +159,26 @@ class AsyncRedisClient {
    *
    * @return Vector of elements, or error
    */
-  Task<Result<std::vector<std::string>>> LRange(std::string_view key, int64_t start, int64_t stop);
+  Task<Result<std::vector<std::string>>> LRange(std::string_view key, int64_t start, int64_t stop,
+                                                CancellationToken cancel = {});
+
+  /**
+   * LRANGE key start stop, for lists of decimal ids.
+   *
+   * Elements are parsed with std::from_chars straight from hiredis' reply
+   * buffers in the reply callback, into an IdColumn sized to the reply and
+   * allocated from `memory` (the request arena; null = heap), so a
+   * ColumnBatch can adopt it without a copy. The redisReply is freed as soon
+   * as the callback returns. Elements that are not valid int64s are skipped.
+   * The command and the returned IdList hold a reference to `memory`.
+   *
+   * IMPORTANT: See HGet() for Task lifetime requirements.
+   *
+   * @return Parsed ids and element payload bytes, or error
+   */
+  Task<Result<IdList>> LRangeIds(std::string_view key, int64_t start, int64_t stop,
+                                 std::shared_ptr<std::pmr::memory_resource> memory = nullptr,
+                                 CancellationToken cancel = {});
 
   /**
    * HGETALL key - get all hash fields and values.
@@ -113,17 +187,89 @@ class AsyncRedisClient {
    *
    * @return Vector of alternating field/value strings, or error
    */
-  Task<Result<std::vector<std::string>>> HGetAll(std::string_view key);
+  Task<Result<std::vector<std::string>>> HGetAll(std::string_view key,
+                                                 CancellationToken cancel = {});
+
+  /**
+   * HMGET key field [field ...] - get selected hash fields.
+   *
+   * Transfers only the requested fields, unlike HGETALL.
+   *
+   * IMPORTANT: See HGet() for Task lifetime requirements. `fields` must stay
+   * alive until the Task completes.
+   *
+   * @return One value per field (nullopt if the field or key is absent), or error
+   */
+  Task<Result<std::vector<std::optional<std::string>>>> HMGet(
+      std::string_view key, const std::vector<std::string>& fields,
+      CancellationToken cancel = {});
+
+  /**
+   * Batched LRANGE / LRANGE ids / HGETALL / HMGET - issue one command per key, await all
+   * replies.
+   *
+   * All commands are written to the pipelined connection back to back, so a
+   * batch costs about one round trip instead of one per key. Each command
+   * still takes its own AsyncInflightLimiter permit: commands beyond
+   * max_inflight queue (FIFO) and go out as earlier replies arrive.
+   *
+   * Results are in key order; each entry succeeds or fails independently.
+   *
+   * IMPORTANT: See HGet() for Task lifetime requirements.
+   */
+  Task<std::vector<Result<std::vector<std::string>>>> LRangeBatch(
+      std::vector<std::string> keys, int64_t start, int64_t stop, CancellationToken cancel = {});
+  Task<std::vector<Result<IdList>>> LRangeIdsBatch(
+      std::vector<std::string> keys, int64_t start, int64_t stop,
+      std::shared_ptr<std::pmr::memory_resource> memory = nullptr, CancellationToken cancel = {});
+
+  // Ids of LRangeIdsBatch results (all successful) in key order, as one
+  // column. A single list is returned as is; several are copied into one
+  // column allocated from `memory` (null = heap).
+  static std::shared_ptr<rankd::IdColumn> JoinIds(
+      std::vector<Result<IdList>>& lists,
+      const std::shared_ptr<std::pmr::memory_resource>& memory);
+
+  Task<std::vector<Result<std::vector<std::string>>>> HGetAllBatch(
+      std::vector<std::string> keys, CancellationToken cancel = {});
+  Task<std::vector<Result<std::vector<std::optional<std::string>>>>> HMGetBatch(
+      std::vector<std::string> keys, std::vector<std::string> fields,
+      CancellationToken cancel = {});
 
   // Connection state accessors
   bool is_connected() const { return connected_; }
+  // Connection failed or dropped; every further command fails fast
+  bool is_closed() const { return ctx_ == nullptr; }
   const std::string& endpoint_id() const { return endpoint_id_; }
   const std::string& last_error() const { return last_error_; }
 
+  // Current permit limit and queueing delay live here
+  const AsyncInflightLimiter& inflight_limiter() const { return limiter_; }
+
+  // Commands holding or waiting for an inflight permit
+  size_t outstanding() const { return limiter_.current() + limiter_.waiters_count(); }
+
+  // Commands requested through this client (including coalesced reads)
+  uint64_t command_count() const;
+
+  // Reads served by joining an identical in-flight command
+  uint64_t coalesced_count() const;
+
+  // Micro-batching window flushes and the commands they carried
+  uint64_t batch_flush_count() const;
+  uint64_t batched_command_count() const;
+
+  // Reads re-sent to a replica, and those answered by the replica first
+  uint64_t hedges_issued() const;
+  uint64_t hedges_won() const;
+
  private:
+  friend struct RedisHedger;
+
   // Private constructor - use Create() factory
   AsyncRedisClient(EventLoop& loop, std::string endpoint_id, int max_inflight,
-                   int request_timeout_ms);
+                   int request_timeout_ms, int batch_window_us, int batch_max_ops,
+                   int min_inflight);
 
   // Initialize connection (called from Create)
   std::expected<void, std::string> connect(const std::string& host, int port,
@@ -143,6 +289,10 @@ class AsyncRedisClient {
   int request_timeout_ms_ = 0;  // 0 = no timeout
   bool connected_ = false;
   std::string last_error_;
+  uint64_t commands_ = 0;  // Loop thread only
+  std::shared_ptr<RedisSingleFlight> single_flight_;
+  std::unique_ptr<RedisBatchWindow> batch_window_;  // nullptr = no batching
+  std::unique_ptr<RedisHedger> hedger_;              // nullptr = no hedging
 };
 
 /**
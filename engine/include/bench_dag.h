@@ -0,0 +1,21 @@
+#pragma once
+
+namespace rankd {
+
+// Configuration for the synthetic wide-DAG scheduling benchmark
+struct BenchDagConfig {
+  int iterations = 20;           // plan executions per width and policy
+  int max_width = 32;            // sweeps side-branch widths 8, 16, ... up to this
+  int depth = 4;                 // critical chain length
+  int node_ms = 5;               // runtime of every synthetic node
+  int slots = 4;                 // max_nodes_inflight for the sync scheduler
+  bool json_output = false;      // JSON vs human-readable output
+};
+
+// Run the DAG benchmark: for each width, execute a plan with `width` short
+// side branches and one `depth`-node chain under FIFO and critical-path
+// ready queues, and report end-to-end latency.
+// Requires InitCPUThreadPool(). Returns 0 on success, non-zero on error.
+int run_bench_dag(const BenchDagConfig& config);
+
+}  // namespace rankd
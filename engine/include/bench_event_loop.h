@@ -6,11 +6,11 @@ namespace ranking {
 
 // Configuration for EventLoop benchmarks
 struct BenchEventLoopConfig {
-  std::string mode = "all";      // posts|timers|sleep_vs_pool|all
+  std::string mode = "all";      // posts|timers|sleep_vs_pool|frames|all
   int n = 0;                     // 0 = use mode default
-  int producers = 1;             // for posts mode
-  int sleep_ms = 1;              // for timer/sleep modes
-  int tasks = 1000;              // for timer/sleep modes
+  int producers = 1;             // posts mode: sweeps 1, 2, 4, ... up to this
+  int sleep_ms = 1;              // for timer/sleep/frames modes
+  int tasks = 1000;              // for timer/sleep/frames modes
   bool json_output = false;      // JSON vs human-readable output
 };
 
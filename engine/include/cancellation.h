@@ -0,0 +1,157 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace ranking {
+
+/**
+ * CancellationToken / CancellationSource - cooperative cancellation for
+ * coroutines driven by the EventLoop.
+ *
+ * A Task cannot be destroyed while suspended (see coro_task.h), so a request
+ * that fails or times out instead cancels its source: awaitables holding the
+ * token (Redis commands, permit waits, sleeps) then complete right away with
+ * an error, and the coroutines waiting on them unwind normally.
+ *
+ * Awaitables check cancelled() before starting work and register an
+ * on_cancel() callback while suspended. Callbacks run once, in registration
+ * order, from cancel(); they may resume coroutines, which may in turn drop
+ * other registrations.
+ *
+ * A default-constructed token is never cancelled and costs nothing to check.
+ *
+ * Thread safety: NOT thread-safe. Cancel and register on the EventLoop
+ * thread only.
+ *
+ * Usage:
+ *   CancellationSource source;
+ *   ctx.cancel = source.token();
+ *   ...
+ *   source.cancel();  // e.g. on first error
+ */
+class CancellationToken {
+  struct Node {
+    Node* prev = nullptr;
+    Node* next = nullptr;
+    bool linked = false;
+    std::function<void()> fn;
+  };
+
+  struct State {
+    bool cancelled = false;
+    Node* head = nullptr;
+    Node* tail = nullptr;
+
+    void unlink(Node* node) {
+      (node->prev ? node->prev->next : head) = node->next;
+      (node->next ? node->next->prev : tail) = node->prev;
+      node->prev = node->next = nullptr;
+      node->linked = false;
+    }
+  };
+
+ public:
+  /**
+   * RAII handle for an on_cancel() callback; destroying it unregisters the
+   * callback. Empty if the token can never be cancelled.
+   */
+  class Registration {
+   public:
+    Registration() = default;
+    ~Registration() { reset(); }
+
+    Registration(Registration&& other) noexcept
+        : state_(std::move(other.state_)), node_(std::move(other.node_)) {}
+    Registration& operator=(Registration&& other) noexcept {
+      if (this != &other) {
+        reset();
+        state_ = std::move(other.state_);
+        node_ = std::move(other.node_);
+      }
+      return *this;
+    }
+
+    Registration(const Registration&) = delete;
+    Registration& operator=(const Registration&) = delete;
+
+    void reset() {
+      // Callbacks are unlinked before they run, so only pending ones are linked
+      if (node_ && node_->linked) {
+        state_->unlink(node_.get());
+      }
+      node_.reset();
+      state_.reset();
+    }
+
+   private:
+    friend class CancellationToken;
+    std::shared_ptr<State> state_;
+    std::unique_ptr<Node> node_;
+  };
+
+  CancellationToken() = default;
+
+  bool cancelled() const { return state_ && state_->cancelled; }
+
+  // False for a default-constructed token
+  bool can_cancel() const { return state_ != nullptr; }
+
+  /**
+   * Run `fn` when the token is cancelled. Callers check cancelled() first:
+   * registering on an already cancelled token (or a default one) returns an
+   * empty Registration and never calls `fn`.
+   */
+  [[nodiscard]] Registration on_cancel(std::function<void()> fn) const {
+    Registration reg;
+    if (!state_ || state_->cancelled) {
+      return reg;
+    }
+    reg.state_ = state_;
+    reg.node_ = std::make_unique<Node>();
+    Node* node = reg.node_.get();
+    node->fn = std::move(fn);
+    node->linked = true;
+    node->prev = state_->tail;
+    (state_->tail ? state_->tail->next : state_->head) = node;
+    state_->tail = node;
+    return reg;
+  }
+
+ private:
+  friend class CancellationSource;
+  explicit CancellationToken(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+  std::shared_ptr<State> state_;
+};
+
+class CancellationSource {
+ public:
+  CancellationSource() : state_(std::make_shared<CancellationToken::State>()) {}
+
+  CancellationToken token() const { return CancellationToken(state_); }
+
+  bool cancelled() const { return state_->cancelled; }
+
+  // Cancel the token and run every registered callback (idempotent)
+  void cancel() {
+    if (state_->cancelled) {
+      return;
+    }
+    state_->cancelled = true;
+    // Keep the state alive: callbacks may destroy the last other owner
+    auto state = state_;
+    while (auto* node = state->head) {
+      state->unlink(node);
+      // Take the callback out first; running it may destroy the Registration
+      auto fn = std::move(node->fn);
+      fn();
+    }
+  }
+
+ private:
+  std::shared_ptr<CancellationToken::State> state_;
+};
+
+}  // namespace ranking
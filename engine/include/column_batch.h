@@ -3,7 +3,9 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace rankd {
@@ -12,12 +14,51 @@ struct DebugCounters {
   uint64_t materialize_count = 0;
 };
 
+// Allocator for column buffers: allocates from a memory resource like
+// std::pmr::polymorphic_allocator, but value-construction (vector(n), resize)
+// default-initializes, so sizing a buffer of trivial values skips the zero-fill.
+template <typename T>
+class ColumnAllocator : public std::pmr::polymorphic_allocator<T> {
+public:
+  using std::pmr::polymorphic_allocator<T>::polymorphic_allocator;
+  ColumnAllocator(const std::pmr::polymorphic_allocator<T> &other) noexcept
+      : std::pmr::polymorphic_allocator<T>(other) {}
+
+  template <typename U> void construct(U *p) noexcept(
+      std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void *>(p)) U;
+  }
+  template <typename U, typename... Args> void construct(U *p, Args &&...args) {
+    std::pmr::polymorphic_allocator<T>::construct(p, std::forward<Args>(args)...);
+  }
+};
+
+template <typename T> using ColumnVector = std::vector<T, ColumnAllocator<T>>;
+
+// How a new column initializes its values. Uninitialized is for kernels that
+// write every row they mark valid; values behind valid == 0 are never read.
+enum class ColumnInit { Zeroed, Uninitialized };
+
 // Float column storage: values + validity bitmap
+// Storage comes from `mr` (the batch's request arena, or the heap by default).
+// valid always starts all-zero.
 struct FloatColumn {
-  std::vector<double> values;
-  std::vector<uint8_t> valid;
+  ColumnVector<double> values;
+  ColumnVector<uint8_t> valid;
+
+  explicit FloatColumn(size_t n,
+                       std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : FloatColumn(n, ColumnInit::Zeroed, mr) {}
 
-  explicit FloatColumn(size_t n) : values(n, 0.0), valid(n, 0) {}
+  FloatColumn(size_t n, ColumnInit init,
+              std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : values(mr), valid(n, 0, mr) {
+    if (init == ColumnInit::Zeroed) {
+      values.assign(n, 0.0);
+    } else {
+      values.resize(n);
+    }
+  }
 };
 
 // String dictionary column: dictionary-encoded strings
@@ -35,17 +76,43 @@ struct StringDictColumn {
 
 // Shared id column storage (allows sharing without copy)
 struct IdColumn {
-  std::vector<int64_t> values;
-  std::vector<uint8_t> valid;
+  ColumnVector<int64_t> values;
+  ColumnVector<uint8_t> valid;
 
-  explicit IdColumn(size_t n) : values(n), valid(n, 1) {}
+  explicit IdColumn(size_t n, ColumnInit init = ColumnInit::Zeroed,
+                    std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : values(mr), valid(n, 1, mr) {
+    if (init == ColumnInit::Zeroed) {
+      values.assign(n, 0);
+    } else {
+      values.resize(n);
+    }
+  }
 };
 
+// A ColumnBatch optionally carries the memory resource (typically the request's
+// RequestArena) its columns are allocated from. The batch keeps that resource
+// alive, and every batch derived via with*Column shares it, so columns added to
+// a batch must come from resource() or the default heap.
+//
+// Sources that set every id pass ids = ColumnInit::Uninitialized to skip the
+// zero-fill of the id column.
 class ColumnBatch {
 public:
   explicit ColumnBatch(size_t num_rows,
-                       std::shared_ptr<DebugCounters> debug = nullptr)
-      : id_col_(std::make_shared<IdColumn>(num_rows)),
+                       std::shared_ptr<DebugCounters> debug = nullptr,
+                       std::shared_ptr<std::pmr::memory_resource> memory = nullptr,
+                       ColumnInit ids = ColumnInit::Zeroed)
+      : memory_(std::move(memory)),
+        id_col_(std::make_shared<IdColumn>(num_rows, ids, resourceOf(memory_))),
+        debug_(debug ? debug : std::make_shared<DebugCounters>()) {}
+
+  // Adopt an id column its source already filled (e.g. ids decoded straight
+  // from a reply) without a copy; `ids` must come from `memory` or the heap
+  explicit ColumnBatch(std::shared_ptr<IdColumn> ids,
+                       std::shared_ptr<DebugCounters> debug = nullptr,
+                       std::shared_ptr<std::pmr::memory_resource> memory = nullptr)
+      : memory_(std::move(memory)), id_col_(std::move(ids)),
         debug_(debug ? debug : std::make_shared<DebugCounters>()) {}
 
   size_t size() const { return id_col_->values.size(); }
@@ -62,10 +129,14 @@ public:
 
   const std::shared_ptr<DebugCounters> &debug() const { return debug_; }
 
+  // Memory resource for new columns/selections over this batch
+  std::pmr::memory_resource *resource() const { return resourceOf(memory_); }
+  const std::shared_ptr<std::pmr::memory_resource> &memory() const { return memory_; }
+
   // Copy id column - increments materialize_count
   std::vector<int64_t> copyIdColumn() const {
     debug_->materialize_count++;
-    return id_col_->values;
+    return {id_col_->values.begin(), id_col_->values.end()};
   }
 
   // Float column accessors
@@ -87,6 +158,7 @@ public:
   ColumnBatch withFloatColumn(uint32_t key_id,
                               std::shared_ptr<const FloatColumn> col) const {
     ColumnBatch result;
+    result.memory_ = memory_;           // Share memory resource
     result.id_col_ = id_col_;           // Share id storage
     result.float_cols_ = float_cols_;   // Copy map (shared_ptr copies are cheap)
     result.string_cols_ = string_cols_; // Share string columns
@@ -124,6 +196,7 @@ public:
   withStringColumn(uint32_t key_id,
                    std::shared_ptr<const StringDictColumn> col) const {
     ColumnBatch result;
+    result.memory_ = memory_;           // Share memory resource
     result.id_col_ = id_col_;           // Share id storage
     result.float_cols_ = float_cols_;   // Share float columns
     result.string_cols_ = string_cols_; // Copy map (shared_ptr copies are cheap)
@@ -142,10 +215,45 @@ public:
     return keys;
   }
 
+  // Calls fn(const void *buffer, size_t bytes) for each storage buffer this
+  // batch references: the id column, each float column and each string
+  // column's dict/codes/valid. Batches derived via with*Column report the
+  // buffers they share with the same pointers, so callers can deduplicate.
+  template <typename Fn> void forEachBuffer(Fn &&fn) const {
+    fn(id_col_.get(), id_col_->values.capacity() * sizeof(int64_t) +
+                          id_col_->valid.capacity());
+    for (const auto &[key_id, col] : float_cols_) {
+      fn(col.get(),
+         col->values.capacity() * sizeof(double) + col->valid.capacity());
+    }
+    for (const auto &[key_id, col] : string_cols_) {
+      if (col->dict) {
+        size_t dict_bytes = col->dict->size() * sizeof(std::string);
+        for (const auto &str : *col->dict) {
+          dict_bytes += str.size();
+        }
+        fn(col->dict.get(), dict_bytes);
+      }
+      if (col->codes) {
+        fn(col->codes.get(), col->codes->capacity() * sizeof(int32_t));
+      }
+      if (col->valid) {
+        fn(col->valid.get(), col->valid->capacity());
+      }
+    }
+  }
+
 private:
   // Private default constructor for with*Column
   ColumnBatch() = default;
 
+  static std::pmr::memory_resource *
+  resourceOf(const std::shared_ptr<std::pmr::memory_resource> &memory) {
+    return memory ? memory.get() : std::pmr::get_default_resource();
+  }
+
+  // Declared first so it is destroyed after the columns allocated from it
+  std::shared_ptr<std::pmr::memory_resource> memory_;
   std::shared_ptr<IdColumn> id_col_;
   std::map<uint32_t, std::shared_ptr<const FloatColumn>>
       float_cols_; // key_id -> column
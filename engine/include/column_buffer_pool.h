@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace rankd {
+
+// ColumnBufferPool: process-wide recycler for column-sized buffers.
+//
+// Successive requests allocate and free buffers of the same sizes (request
+// arena chunks holding columns and selections). Instead of handing them back
+// to the system allocator - and page-faulting fresh memory on the next
+// request - freed buffers are kept in power-of-two size classes and reused.
+//
+// - Each thread caches a few buffers per class without locking; the rest go
+//   to shared, mutex-guarded free lists.
+// - Retained (freed but cached) bytes are capped; frees beyond the cap go
+//   straight back to the system allocator.
+// - Requests smaller than the smallest class, larger than the largest class,
+//   or over-aligned bypass the pool.
+//
+// Thread-safe. The instance is never destroyed, so thread caches can flush
+// into it when their thread exits.
+class ColumnBufferPool : public std::pmr::memory_resource {
+public:
+  static constexpr size_t kMinClassShift = 12; // 4 KiB
+  static constexpr size_t kMaxClassShift = 26; // 64 MiB
+  static constexpr size_t kNumClasses = kMaxClassShift - kMinClassShift + 1;
+  static constexpr size_t kMaxAlignment = 64;
+  static constexpr size_t kThreadCacheBuffersPerClass = 4;
+  static constexpr size_t kDefaultRetainLimitBytes = size_t{256} << 20;
+
+  static ColumnBufferPool &instance();
+
+  ColumnBufferPool(const ColumnBufferPool &) = delete;
+  ColumnBufferPool &operator=(const ColumnBufferPool &) = delete;
+
+  // Cap on retained bytes (thread caches + shared lists). Lowering the cap
+  // does not release already-retained buffers; call trim() for that.
+  void setRetainLimit(size_t bytes) {
+    retain_limit_.store(bytes, std::memory_order_relaxed);
+  }
+  size_t retainLimit() const {
+    return retain_limit_.load(std::memory_order_relaxed);
+  }
+
+  // Bytes currently cached for reuse (not in use by anyone)
+  size_t retainedBytes() const {
+    return retained_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Pooled allocations served from a cached buffer / from the system
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+  // Release the calling thread's cache and all shared free lists to the
+  // system allocator. Other threads' caches are left alone.
+  void trim();
+
+  // Size class index for a pooled request, or kNumClasses if it bypasses
+  static size_t classIndex(size_t bytes, size_t alignment);
+  static size_t classBytes(size_t index) {
+    return size_t{1} << (index + kMinClassShift);
+  }
+
+private:
+  struct ThreadCache;
+
+  ColumnBufferPool() = default;
+
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  static ThreadCache &threadCache();
+
+  // Takes ownership of a freed pooled buffer: caches it or releases it
+  void release(size_t index, void *p, ThreadCache *cache);
+  static void freeBuffer(size_t index, void *p);
+
+  std::mutex mu_;
+  std::array<std::vector<void *>, kNumClasses> shared_; // guarded by mu_
+
+  std::atomic<size_t> retain_limit_{kDefaultRetainLimitBytes};
+  std::atomic<size_t> retained_bytes_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace rankd
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <coroutine>
+#include <cstddef>
 #include <exception>
 #include <optional>
 #include <utility>
+#include <vector>
+
+#include "frame_pool.h"
 
 namespace ranking {
 
@@ -25,7 +29,9 @@ namespace ranking {
 // Unsafe patterns:
 //   myCoroutine().start();  // Task destroyed immediately! Pending callbacks = UAF
 //
-// Future work: Add cancellation support to safely destroy pending coroutines.
+// To stop pending work early, cancel a CancellationToken (cancellation.h)
+// that the awaited operations hold: they complete right away and the Task
+// unwinds normally instead of being destroyed.
 
 // Forward declaration
 template <typename T>
@@ -37,6 +43,7 @@ namespace detail {
 struct PromiseBase {
   std::exception_ptr exception_;
   std::coroutine_handle<> continuation_;
+  bool started_ = false;  // Resumed by start(), not by its awaiter
 
   std::suspend_always initial_suspend() noexcept { return {}; }
 
@@ -58,6 +65,13 @@ struct PromiseBase {
   FinalAwaiter final_suspend() noexcept { return {}; }
 
   void unhandled_exception() { exception_ = std::current_exception(); }
+
+  // Coroutine frames come from the per-thread FramePool free lists: a node
+  // creates several short-lived frames, all of similar size across requests
+  static void* operator new(std::size_t size) { return FramePool::instance().allocate(size); }
+  static void operator delete(void* p, std::size_t size) noexcept {
+    FramePool::instance().deallocate(p, size);
+  }
 };
 
 }  // namespace detail
@@ -108,6 +122,11 @@ struct Task {
 
   std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
     handle_.promise().continuation_ = awaiting;
+    // A started task is suspended on its own awaitable, which resumes it; it
+    // resumes us from final_suspend
+    if (handle_.promise().started_) {
+      return std::noop_coroutine();
+    }
     return handle_;
   }
 
@@ -121,6 +140,7 @@ struct Task {
   // Start the coroutine (for use with blockingWait)
   void start() {
     if (handle_ && !handle_.done()) {
+      handle_.promise().started_ = true;
       handle_.resume();
     }
   }
@@ -183,6 +203,11 @@ struct Task<void> {
 
   std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
     handle_.promise().continuation_ = awaiting;
+    // A started task is suspended on its own awaitable, which resumes it; it
+    // resumes us from final_suspend
+    if (handle_.promise().started_) {
+      return std::noop_coroutine();
+    }
     return handle_;
   }
 
@@ -195,6 +220,7 @@ struct Task<void> {
   // Start the coroutine (for use with blockingWait)
   void start() {
     if (handle_ && !handle_.done()) {
+      handle_.promise().started_ = true;
       handle_.resume();
     }
   }
@@ -212,4 +238,39 @@ struct Task<void> {
   handle_type handle_;
 };
 
+// WhenAll - run a set of Tasks concurrently and collect their results in order.
+//
+// Every task is started before any is awaited, so tasks that suspend on I/O
+// (e.g. Redis commands) all have their requests in flight at once and the
+// total latency is that of the slowest one rather than the sum.
+//
+// Must be awaited on the EventLoop thread (tasks are started inline). All
+// tasks run to completion before WhenAll returns, so none is destroyed while
+// suspended. If a task throws, its exception is rethrown after the rest have
+// finished.
+template <typename T>
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> tasks) {
+  for (auto& task : tasks) {
+    task.start();
+  }
+
+  std::vector<T> results;
+  results.reserve(tasks.size());
+  std::exception_ptr first_error;
+  for (auto& task : tasks) {
+    // Completed tasks are ready; pending ones resume us from final_suspend
+    try {
+      results.push_back(co_await task);
+    } catch (...) {
+      if (!first_error) {
+        first_error = std::current_exception();
+      }
+    }
+  }
+  if (first_error) {
+    std::rethrow_exception(first_error);
+  }
+  co_return results;
+}
+
 }  // namespace ranking
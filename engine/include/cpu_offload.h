@@ -10,6 +10,8 @@
 #include "coro_task.h"
 #include "cpu_pool.h"
 #include "event_loop.h"
+#include "frame_pool.h"
+#include "timer_wheel.h"
 
 namespace ranking {
 
@@ -50,7 +52,7 @@ class OffloadCpu {
 
   void await_suspend(std::coroutine_handle<> h) {
     // Submit work to CPU pool
-    rankd::GetCPUThreadPool().submit([this, h]() {
+    rankd::GetCPUThreadPool().post([this, h]() {
       // Run the callable on CPU pool thread
       try {
         if constexpr (std::is_void_v<ResultType>) {
@@ -110,7 +112,7 @@ OffloadCpu(EventLoop&, F&&) -> OffloadCpu<std::decay_t<F>>;
  * Thread model:
  *   1. Coroutine suspends on event loop thread
  *   2. CPU work submitted to thread pool
- *   3. Timer started on loop thread (if deadline set)
+ *   3. Deadline armed on the loop's TimerWheel (if deadline set)
  *   4. First-wins: CPU completion or timeout
  *   5. Coroutine resumes on event loop thread
  *
@@ -137,12 +139,12 @@ class OffloadCpuWithTimeout {
       std::conditional_t<std::is_void_v<ResultType>, std::monostate, ResultType>;
 
   // Shared state between CPU job, timer, and coroutine
-  // Lives on heap so CPU job can safely access after coroutine resumes
+  // Lives on heap (FramePool) so CPU job can safely access after coroutine resumes
   struct State {
     bool completed = false;  // First-wins guard (loop-thread only)
     std::variant<StoredResult, std::exception_ptr> result{std::exception_ptr{}};
     std::coroutine_handle<> handle;
-    uv_timer_t* timer = nullptr;
+    TimerWheel::Entry deadline_timer;  // Armed on the loop's timer wheel
     EventLoop* loop = nullptr;
   };
 
@@ -150,7 +152,7 @@ class OffloadCpuWithTimeout {
       : loop_(loop),
         deadline_(deadline),
         fn_(std::forward<F>(fn)),
-        state_(std::make_shared<State>()) {
+        state_(make_pooled_shared<State>()) {
     state_->loop = &loop;
   }
 
@@ -178,7 +180,7 @@ class OffloadCpuWithTimeout {
     auto state = state_;  // Capture shared_ptr for lambda
     auto fn = std::move(fn_);
 
-    rankd::GetCPUThreadPool().submit([state, fn = std::move(fn)]() mutable {
+    rankd::GetCPUThreadPool().post([state, fn = std::move(fn)]() mutable {
       // Execute on CPU thread
       std::variant<StoredResult, std::exception_ptr> local_result{std::exception_ptr{}};
       try {
@@ -201,12 +203,7 @@ class OffloadCpuWithTimeout {
         state->result = std::move(local_result);
 
         // Cancel timer if active
-        if (state->timer) {
-          uv_timer_stop(state->timer);
-          uv_close(reinterpret_cast<uv_handle_t*>(state->timer),
-                   [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
-          state->timer = nullptr;
-        }
+        state->deadline_timer.cancel();
 
         state->handle.resume();
       });
@@ -220,19 +217,16 @@ class OffloadCpuWithTimeout {
         ms = 1;  // Minimum 1ms to ensure timer fires
       }
 
-      // Create and start timer on loop thread
+      // Arm the deadline on the loop thread's timer wheel
       state = state_;  // Refresh capture
       loop_.Post([state, ms]() {
         if (state->completed) {
           return;  // CPU job already finished
         }
 
-        auto* timer = new uv_timer_t;
-        timer->data = state.get();
-        state->timer = timer;
-
-        uv_timer_init(state->loop->RawLoop(), timer);
-        uv_timer_start(timer, OnTimeout, static_cast<uint64_t>(ms), 0);
+        state->deadline_timer.data = state.get();
+        state->loop->Timers().schedule(state->deadline_timer, static_cast<uint64_t>(ms),
+                                       OnTimeout);
       });
     }
 
@@ -262,7 +256,7 @@ class OffloadCpuWithTimeout {
   }
 
  private:
-  static void OnTimeout(uv_timer_t* t) {
+  static void OnTimeout(TimerWheel::Entry* t) {
     auto* state = static_cast<State*>(t->data);
     if (state->completed) {
       return;  // CPU job already finished
@@ -270,10 +264,6 @@ class OffloadCpuWithTimeout {
     state->completed = true;
     state->result = std::make_exception_ptr(
         std::runtime_error("Node execution timeout"));
-    state->timer = nullptr;
-
-    uv_close(reinterpret_cast<uv_handle_t*>(t),
-             [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
 
     // Resume via Post for consistency and reentrancy safety.
     // If Post fails (loop stopping), resume directly - we're on loop thread.
@@ -307,7 +297,7 @@ OffloadCpuWithTimeout(EventLoop&, std::optional<std::chrono::steady_clock::time_
  * Thread model:
  *   1. Caller suspends on event loop thread
  *   2. Detached coroutine starts inner task (loop thread)
- *   3. Timer started on loop thread (if deadline set)
+ *   3. Deadline armed on the loop's TimerWheel (if deadline set)
  *   4. First-wins: task completion or timeout, whoever sets done=true first
  *   5. Caller resumes on event loop thread via loop.Post()
  *
@@ -347,7 +337,7 @@ class AsyncWithTimeout {
     bool done = false;  // First-wins guard (loop-thread only)
     std::variant<StoredResult, std::exception_ptr> result{std::exception_ptr{}};
     std::coroutine_handle<> waiter;
-    uv_timer_t* timer = nullptr;
+    TimerWheel::Entry deadline_timer;  // Armed on the loop's timer wheel
     EventLoop* loop = nullptr;
     LateCompletionCounter late_counter;  // Optional test hook
 
@@ -365,15 +355,8 @@ class AsyncWithTimeout {
     // This handles synchronous completion during shutdown.
     bool needs_direct_resume = false;
 
-    // Cancel and close the timer (idempotent)
-    void cancel_timer() {
-      if (timer) {
-        uv_timer_stop(timer);
-        uv_close(reinterpret_cast<uv_handle_t*>(timer),
-                 [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
-        timer = nullptr;
-      }
-    }
+    // Cancel the deadline (idempotent)
+    void cancel_timer() { deadline_timer.cancel(); }
   };
 
   AsyncWithTimeout(EventLoop& loop,
@@ -383,7 +366,7 @@ class AsyncWithTimeout {
       : loop_(loop),
         deadline_(deadline),
         task_(std::move(task)),
-        state_(std::make_shared<State>()) {
+        state_(make_pooled_shared<State>()) {
     state_->loop = &loop;
     state_->late_counter = late_counter;
   }
@@ -528,12 +511,8 @@ class AsyncWithTimeout {
         ms = 1;  // Minimum 1ms to ensure timer fires
       }
 
-      auto* timer = new uv_timer_t;
-      timer->data = state_.get();
-      state_->timer = timer;
-
-      uv_timer_init(loop_.RawLoop(), timer);
-      uv_timer_start(timer, OnTimeout, static_cast<uint64_t>(ms), 0);
+      state_->deadline_timer.data = state_.get();
+      loop_.Timers().schedule(state_->deadline_timer, static_cast<uint64_t>(ms), OnTimeout);
     }
 
     // Mark that await_suspend has returned. This allows runner completion
@@ -572,22 +551,15 @@ class AsyncWithTimeout {
   }
 
  private:
-  static void OnTimeout(uv_timer_t* t) {
+  static void OnTimeout(TimerWheel::Entry* t) {
     auto* state = static_cast<State*>(t->data);
     if (state->done) {
-      // Task completed before timer - shouldn't happen since we cancel timer,
-      // but handle gracefully
-      uv_close(reinterpret_cast<uv_handle_t*>(t),
-               [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
+      // Task completed before timer - shouldn't happen since we cancel timer
       return;
     }
     state->done = true;
     state->result = std::make_exception_ptr(
         std::runtime_error("Node execution timeout"));
-    state->timer = nullptr;
-
-    uv_close(reinterpret_cast<uv_handle_t*>(t),
-             [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
 
     // Resume via Post for consistency and reentrancy safety.
     // If Post fails (loop stopping), resume directly - we're on loop thread.
@@ -2,7 +2,7 @@
 
 #include <cstddef>
 
-#include "thread_pool.h"
+#include "work_stealing_pool.h"
 
 namespace rankd {
 
@@ -13,6 +13,6 @@ void InitCPUThreadPool(size_t num_threads = 8);
 
 // Get the global CPU thread pool for DAG node execution.
 // Throws if InitCPUThreadPool() has not been called.
-ThreadPool& GetCPUThreadPool();
+WorkStealingPool& GetCPUThreadPool();
 
 }  // namespace rankd
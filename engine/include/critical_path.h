@@ -0,0 +1,174 @@
+#pragma once
+
+#include "plan.h"
+#include "task_registry.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rankd {
+
+// One node's latency EWMA in microseconds, or kNoHistory before the first
+// sample. Owned by NodeCostModel and never freed, so a validated Node can
+// keep a pointer to it (Node::cost_slot).
+struct NodeCostSlot {
+  static constexpr double kNoHistory = -1.0;
+  std::atomic<double> ewma_us{kNoHistory};
+};
+
+// NodeCostModel: process-wide runtime estimates for DAG nodes, used to rank
+// ready nodes by critical path (see ReadyQueue) and to pick trivial nodes
+// that the async scheduler runs inline (see runsInline).
+//
+// A node's estimate is, in order of preference:
+// - the EWMA of its observed latency, keyed by (plan_name, node_id), which
+//   both schedulers record after every node they run. validate_plan
+//   resolves each node's slot once, so recording is a lock-free atomic
+//   update;
+// - its op's static model (TaskSpec::estimate_cost_us), e.g. busy_cpu's
+//   busy_wait_ms;
+// - kDefaultIoCostUs or kDefaultCpuCostUs, by TaskSpec::is_io.
+//
+// Disabling the model makes ready queues plain FIFO (the old behaviour); it
+// does not affect inlining, which has its own threshold.
+//
+// Thread-safe. The instance is never destroyed.
+class NodeCostModel {
+public:
+  static constexpr double kDefaultCpuCostUs = 50.0;
+  static constexpr double kDefaultIoCostUs = 1000.0;
+  // Weight of the newest sample in the latency EWMA
+  static constexpr double kEwmaAlpha = 0.25;
+  // History stops growing past this many nodes (existing entries still update)
+  static constexpr size_t kMaxHistoryEntries = 65'536;
+  // Roughly the cost of an offload round trip (pool submit + Post back)
+  static constexpr double kDefaultInlineThresholdUs = 20.0;
+
+  static NodeCostModel &instance();
+
+  NodeCostModel(const NodeCostModel &) = delete;
+  NodeCostModel &operator=(const NodeCostModel &) = delete;
+
+  void setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Estimated runtime of `node` in microseconds
+  double estimateUs(const Plan &plan, const Node &node,
+                    const TaskSpec &spec) const;
+
+  // Fold an observed node latency into its history (no-op when disabled).
+  // Lock-free when node.cost_slot is set.
+  void record(const Plan &plan, const Node &node, double elapsed_us);
+
+  // History slot for `node`, created on first use; nullptr once the model
+  // holds kMaxHistoryEntries nodes. Called by validate_plan.
+  NodeCostSlot *slot(const Plan &plan, const Node &node);
+
+  // Inline threshold for trivial nodes, in estimated microseconds of work
+  // (0 disables inlining)
+  void setInlineThresholdUs(double us) {
+    inline_threshold_us_.store(us, std::memory_order_relaxed);
+  }
+  double inlineThresholdUs() const {
+    return inline_threshold_us_.load(std::memory_order_relaxed);
+  }
+
+  // True if a node of `spec` over `input_rows` rows is cheap enough to run
+  // on the event loop thread: input_rows x inline_row_cost_ns below the
+  // inline threshold. Tasks with inline_row_cost_ns == 0 never qualify.
+  bool runsInline(const TaskSpec &spec, size_t input_rows) const {
+    return spec.inline_row_cost_ns > 0 &&
+           static_cast<double>(input_rows) * spec.inline_row_cost_ns <
+               inlineThresholdUs() * 1000.0;
+  }
+
+  // Drop all history (slots stay allocated: validated nodes point at them)
+  void clear();
+
+  // Number of nodes with history
+  size_t size() const;
+
+private:
+  NodeCostModel() = default;
+
+  static std::string historyKey(const Plan &plan, const Node &node) {
+    return plan.plan_name + '\0' + node.node_id;
+  }
+
+  // Slot for an unvalidated node, or nullptr if it has none yet
+  const NodeCostSlot *findSlot(const Plan &plan, const Node &node) const;
+
+  mutable std::shared_mutex mu_;
+  // guarded by mu_ (the map, not the slots' values)
+  std::unordered_map<std::string, std::unique_ptr<NodeCostSlot>> slots_;
+  std::atomic<bool> enabled_{true};
+  std::atomic<double> inline_threshold_us_{kDefaultInlineThresholdUs};
+};
+
+// Critical-path priority of every node: its own cost plus the costliest
+// chain of successors below it (longest remaining path). `topo_order` must
+// list every node with parents before children.
+std::vector<double>
+compute_critical_path(const std::vector<double> &cost,
+                      const std::vector<std::vector<size_t>> &successors,
+                      const std::vector<size_t> &topo_order);
+
+// Priorities for `plan` from NodeCostModel, or empty (FIFO) when the model
+// is disabled. `successors` and `topo_order` as built by the schedulers.
+std::vector<double>
+plan_critical_path(const Plan &plan, const TaskRegistry &registry,
+                   const std::vector<std::vector<size_t>> &successors,
+                   const std::vector<size_t> &topo_order);
+
+// Ready-node queue for the DAG schedulers: pops the node with the highest
+// priority, ties (and every node, with no priorities) in push order.
+class ReadyQueue {
+public:
+  // Indexed by node; nodes past the end (or all, if empty) get priority 0
+  void setPriorities(std::vector<double> priority) {
+    priority_ = std::move(priority);
+  }
+
+  void push(size_t node_idx) {
+    double p = node_idx < priority_.size() ? priority_[node_idx] : 0.0;
+    heap_.push(Entry{p, next_seq_++, node_idx});
+  }
+
+  size_t pop() {
+    size_t node_idx = heap_.top().node_idx;
+    heap_.pop();
+    return node_idx;
+  }
+
+  bool empty() const { return heap_.empty(); }
+  size_t size() const { return heap_.size(); }
+
+private:
+  struct Entry {
+    double priority;
+    uint64_t seq;
+    size_t node_idx;
+    // Max-heap on priority, then min on seq
+    bool operator<(const Entry &other) const {
+      if (priority != other.priority) {
+        return priority < other.priority;
+      }
+      return seq > other.seq;
+    }
+  };
+
+  std::vector<double> priority_;
+  std::priority_queue<Entry> heap_;
+  uint64_t next_seq_ = 0;
+};
+
+} // namespace rankd
@@ -31,6 +31,13 @@ struct EndpointPolicy {
   std::optional<int> max_inflight;
   std::optional<int> connect_timeout_ms;
   std::optional<int> request_timeout_ms;
+  std::optional<int> batch_window_us;  // Async micro-batching window (0 = off)
+  std::optional<int> batch_max_ops;    // Flush the window early at this many ops
+  std::optional<int> pool_size;        // Async connections per endpoint per loop
+  std::optional<bool> adaptive_inflight;  // Async limit adapts to RTT/errors
+  std::optional<int> min_inflight;     // Floor for the adaptive limit
+  std::optional<int> hedge_percentile;  // Hedge reads slower than this RTT pct
+  std::optional<int> hedge_budget_pct;  // Max hedged reads, % of all reads
 };
 
 struct EndpointSpec {
@@ -39,6 +46,7 @@ struct EndpointSpec {
   EndpointKind kind = EndpointKind::Redis;
   ResolverType resolver_type = ResolverType::Static;
   StaticResolver static_resolver;  // only valid when resolver_type==Static
+  std::vector<StaticResolver> replicas;  // Read replicas (hedged reads)
   EndpointPolicy policy;
 };
 
@@ -171,12 +179,40 @@ inline nlohmann::json config_canonical_json(
     if (ep.policy.request_timeout_ms) {
       policy["request_timeout_ms"] = *ep.policy.request_timeout_ms;
     }
+    if (ep.policy.batch_window_us) {
+      policy["batch_window_us"] = *ep.policy.batch_window_us;
+    }
+    if (ep.policy.batch_max_ops) {
+      policy["batch_max_ops"] = *ep.policy.batch_max_ops;
+    }
+    if (ep.policy.pool_size) {
+      policy["pool_size"] = *ep.policy.pool_size;
+    }
+    if (ep.policy.adaptive_inflight) {
+      policy["adaptive_inflight"] = *ep.policy.adaptive_inflight;
+    }
+    if (ep.policy.min_inflight) {
+      policy["min_inflight"] = *ep.policy.min_inflight;
+    }
+    if (ep.policy.hedge_percentile) {
+      policy["hedge_percentile"] = *ep.policy.hedge_percentile;
+    }
+    if (ep.policy.hedge_budget_pct) {
+      policy["hedge_budget_pct"] = *ep.policy.hedge_budget_pct;
+    }
 
     nlohmann::json resolver = {
         {"type", resolver_type_to_string(ep.resolver_type)},
         {"host", ep.static_resolver.host},
         {"port", ep.static_resolver.port},
     };
+    if (!ep.replicas.empty()) {
+      nlohmann::json replicas = nlohmann::json::array();
+      for (const auto& replica : ep.replicas) {
+        replicas.push_back({{"host", replica.host}, {"port", replica.port}});
+      }
+      resolver["replicas"] = replicas;
+    }
 
     entries.push_back({{"endpoint_id", ep.endpoint_id},
                        {"name", ep.name},
@@ -358,6 +394,29 @@ inline std::variant<EndpointRegistry, std::string> EndpointRegistry::LoadFromJso
              std::to_string(spec.static_resolver.port);
     }
 
+    // Parse read replicas (optional)
+    if (resolver.contains("replicas")) {
+      if (!resolver["replicas"].is_array()) {
+        return "Endpoint " + spec.endpoint_id + " resolver replicas must be an array";
+      }
+      for (const auto& replica_json : resolver["replicas"]) {
+        StaticResolver replica;
+        if (!replica_json.is_object() || !replica_json.contains("host") ||
+            !replica_json["host"].is_string() || !replica_json.contains("port") ||
+            !replica_json["port"].is_number_integer()) {
+          return "Endpoint " + spec.endpoint_id +
+                 " has a replica without host and port";
+        }
+        replica.host = replica_json["host"].get<std::string>();
+        replica.port = replica_json["port"].get<int>();
+        if (replica.port < 1 || replica.port > 65535) {
+          return "Endpoint " + spec.endpoint_id + " has invalid replica port: " +
+                 std::to_string(replica.port);
+        }
+        spec.replicas.push_back(std::move(replica));
+      }
+    }
+
     // Parse policy (optional)
     if (ep_json.contains("policy") && ep_json["policy"].is_object()) {
       const auto& policy = ep_json["policy"];
@@ -375,6 +434,34 @@ inline std::variant<EndpointRegistry, std::string> EndpointRegistry::LoadFromJso
         spec.policy.request_timeout_ms =
             policy["request_timeout_ms"].get<int>();
       }
+      if (policy.contains("batch_window_us") &&
+          policy["batch_window_us"].is_number_integer()) {
+        spec.policy.batch_window_us = policy["batch_window_us"].get<int>();
+      }
+      if (policy.contains("batch_max_ops") &&
+          policy["batch_max_ops"].is_number_integer()) {
+        spec.policy.batch_max_ops = policy["batch_max_ops"].get<int>();
+      }
+      if (policy.contains("pool_size") &&
+          policy["pool_size"].is_number_integer()) {
+        spec.policy.pool_size = policy["pool_size"].get<int>();
+      }
+      if (policy.contains("adaptive_inflight") &&
+          policy["adaptive_inflight"].is_boolean()) {
+        spec.policy.adaptive_inflight = policy["adaptive_inflight"].get<bool>();
+      }
+      if (policy.contains("min_inflight") &&
+          policy["min_inflight"].is_number_integer()) {
+        spec.policy.min_inflight = policy["min_inflight"].get<int>();
+      }
+      if (policy.contains("hedge_percentile") &&
+          policy["hedge_percentile"].is_number_integer()) {
+        spec.policy.hedge_percentile = policy["hedge_percentile"].get<int>();
+      }
+      if (policy.contains("hedge_budget_pct") &&
+          policy["hedge_budget_pct"].is_number_integer()) {
+        spec.policy.hedge_budget_pct = policy["hedge_budget_pct"].get<int>();
+      }
     }
 
     // Check for duplicate endpoint_id
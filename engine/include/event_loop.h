@@ -4,11 +4,17 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "frame_pool.h"
+#include "timer_wheel.h"
 
 namespace ranking {
 
@@ -21,6 +27,100 @@ struct EventLoopExitState {
   bool exited{false};
 };
 
+// Type-erased, move-only void() callable for EventLoop::Post().
+// Captures up to kInlineBytes are stored inline (no heap allocation);
+// larger ones fall back to the heap.
+class PostCallback {
+public:
+  static constexpr size_t kInlineBytes = 48;
+
+  PostCallback() = default;
+
+  template <typename F, typename Fn = std::decay_t<F>,
+            typename = std::enable_if_t<!std::is_same_v<Fn, PostCallback>>>
+  PostCallback(F&& fn) {  // NOLINT(google-explicit-constructor)
+    if constexpr (kStoredInline<Fn>) {
+      ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+      ops_ = &kInlineOps<Fn>;
+    } else {
+      ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<F>(fn)));
+      ops_ = &kHeapOps<Fn>;
+    }
+  }
+
+  PostCallback(PostCallback&& other) noexcept : ops_(other.ops_) {
+    if (ops_) {
+      ops_->move(storage_, other.storage_);
+      other.ops_ = nullptr;
+    }
+  }
+
+  PostCallback& operator=(PostCallback&& other) noexcept {
+    if (this != &other) {
+      reset();
+      ops_ = other.ops_;
+      if (ops_) {
+        ops_->move(storage_, other.storage_);
+        other.ops_ = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  PostCallback(const PostCallback&) = delete;
+  PostCallback& operator=(const PostCallback&) = delete;
+
+  ~PostCallback() { reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void operator()() { ops_->invoke(storage_); }
+
+private:
+  struct Ops {
+    void (*invoke)(void* storage);
+    void (*move)(void* dst, void* src);  // move-construct dst, destroy src
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Fn>
+  static constexpr bool kStoredInline = sizeof(Fn) <= kInlineBytes &&
+                                        alignof(Fn) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<Fn>;
+
+  template <typename Fn>
+  static Fn* As(void* storage) {
+    return std::launder(static_cast<Fn*>(storage));
+  }
+
+  template <typename Fn>
+  static constexpr Ops kInlineOps = {
+      [](void* s) { (*As<Fn>(s))(); },
+      [](void* dst, void* src) {
+        ::new (dst) Fn(std::move(*As<Fn>(src)));
+        As<Fn>(src)->~Fn();
+      },
+      [](void* s) { As<Fn>(s)->~Fn(); },
+  };
+
+  template <typename Fn>
+  static constexpr Ops kHeapOps = {
+      [](void* s) { (**As<Fn*>(s))(); },
+      [](void* dst, void* src) { ::new (dst) Fn*(*As<Fn*>(src)); },
+      [](void* s) { delete *As<Fn*>(s); },
+  };
+
+  void reset() {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  const Ops* ops_ = nullptr;
+  alignas(std::max_align_t) unsigned char storage_[kInlineBytes];
+};
+
 // Single-threaded libuv event loop wrapper.
 // Provides thread-safe posting of callbacks to be executed on the loop thread.
 //
@@ -42,6 +142,10 @@ struct EventLoopExitState {
 //                 ↘ Stopped (if Stop called during init)
 //
 // All transitions are atomic CAS operations - no race windows.
+//
+// Post() queue: intrusive lock-free MPSC queue (Vyukov). Producers never
+// take a lock; the loop thread is the only consumer. uv_async_send is
+// coalesced with a pending flag, so a burst of posts costs one wakeup.
 class EventLoop {
 public:
   // Lifecycle states
@@ -69,9 +173,17 @@ public:
   void Stop();
 
   // Post a callback to be executed on the loop thread.
-  // Thread-safe; can be called from any thread.
-  // Returns false if the loop is not running (not started or stopping).
-  bool Post(std::function<void()> fn);
+  // Thread-safe; can be called from any thread. Callbacks from one thread
+  // run in posting order.
+  // Returns false if the loop is not running (not started or stopping);
+  // a rejected callback is destroyed without running.
+  template <typename F>
+  bool Post(F&& fn) {
+    if (state_.load() != State::Running) {
+      return false;
+    }
+    return Enqueue(new PostNode{{}, PostCallback(std::forward<F>(fn))});
+  }
 
   // Access the raw libuv loop handle.
   // Only valid after Start() and before Stop().
@@ -86,17 +198,55 @@ public:
   // Get current state (for testing/debugging)
   State GetState() const { return state_.load(); }
 
+  // Number of async wakeups that drained the Post() queue (for benchmarks)
+  uint64_t WakeupCount() const { return wakeups_.load(std::memory_order_relaxed); }
+
+  // Timer wheel for node and Redis deadlines on this loop, created on first
+  // use. Loop thread only; its tick timer is closed with the other handles
+  // on stop.
+  TimerWheel& Timers();
+
 private:
+  // Nodes come from FramePool: a post made on the loop thread (a resumed
+  // coroutine scheduling its continuation) reuses a block the drain freed
+  struct PostNode {
+    std::atomic<PostNode*> next{nullptr};
+    PostCallback fn;
+
+    static void* operator new(std::size_t size) { return FramePool::instance().allocate(size); }
+    static void operator delete(void* p, std::size_t size) noexcept {
+      FramePool::instance().deallocate(p, size);
+    }
+  };
+
+  // Max callbacks run per wakeup; the rest run on the next loop iteration
+  // so a callback that keeps posting cannot starve IO.
+  static constexpr int kMaxDrainBatch = 1024;
+
   static void OnAsync(uv_async_t* handle);
-  void DrainQueue();
+  bool Enqueue(PostNode* node);       // Post() slow path: reject or push + wake
+  void Push(PostNode* node);          // MPSC push (any thread)
+  PostNode* Pop();                    // MPSC pop (loop thread only)
+  void Wake();                        // uv_async_send unless a wakeup is pending
+  void DrainQueue(bool all = false);  // all = ignore kMaxDrainBatch (shutdown)
   void DoStop();  // Internal stop logic, called on loop thread
 
   uv_loop_t loop_;
   uv_async_t async_;
   std::thread loop_thread_;
   std::thread::id loop_thread_id_;
-  std::mutex queue_mutex_;
-  std::queue<std::function<void()>> queue_;
+
+  // MPSC queue: producers exchange head_; the loop thread owns tail_
+  std::atomic<PostNode*> head_;
+  PostNode* tail_;
+  PostNode stub_;
+  // Set while a uv_async_send is outstanding; cleared by OnAsync
+  std::atomic<bool> async_pending_{false};
+  // Post() calls between their Running check and their push. DoStop waits
+  // for zero so every accepted callback is drained before shutdown.
+  std::atomic<int> posters_{0};
+  std::atomic<uint64_t> wakeups_{0};
+  std::unique_ptr<TimerWheel> timers_;  // Loop thread only
 
   // Single atomic state - eliminates all race conditions between flags
   std::atomic<State> state_{State::Idle};
@@ -105,4 +255,18 @@ private:
   std::shared_ptr<EventLoopExitState> exit_state_;
 };
 
+// One-shot uv timers for awaitables and clients, allocated from FramePool.
+// Init with uv_timer_init as usual; ClosePooledTimer stops the timer and
+// returns it to the pool once libuv is done with the handle.
+inline uv_timer_t* NewPooledTimer() {
+  return static_cast<uv_timer_t*>(FramePool::instance().allocate(sizeof(uv_timer_t)));
+}
+
+inline void ClosePooledTimer(uv_timer_t* timer) {
+  uv_timer_stop(timer);
+  uv_close(reinterpret_cast<uv_handle_t*>(timer), [](uv_handle_t* h) {
+    FramePool::instance().deallocate(h, sizeof(uv_timer_t));
+  });
+}
+
 }  // namespace ranking
@@ -4,6 +4,7 @@
 #include "plan.h"
 #include "schema_delta.h"
 #include "task_registry.h"
+#include <string>
 #include <vector>
 
 namespace rankd {
@@ -12,14 +13,30 @@ namespace rankd {
 class EndpointRegistry;
 
 // Validate plan (fail-closed). Throws std::runtime_error on failure.
-// Also populates node.writes_eval_kind and node.writes_eval_keys (RFC0005).
+// Also populates node.writes_eval_kind and node.writes_eval_keys (RFC0005),
+// and node.live_keys (keys descendants may read, for source hydration).
 // If endpoints is provided, EndpointRef params are validated against the registry.
 void validate_plan(Plan &plan, const EndpointRegistry *endpoints = nullptr);
 
+// Per-node IO trace (IO tasks only)
+struct NodeIoTrace {
+  std::string node_id;
+  uint64_t bytes_received = 0;  // reply payload bytes (NodeIoStats)
+};
+
 // Result of executing a plan, including optional trace data
 struct ExecutionResult {
   std::vector<RowSet> outputs;
   std::vector<NodeSchemaDelta> schema_deltas;  // RFC0005: per-node schema changes
+  std::vector<NodeIoTrace> io_trace;           // IO nodes, topo order
+  // Async scheduler: nodes without run_async that ran inline on the event
+  // loop thread vs. offloaded to the CPU pool
+  uint32_t nodes_inlined = 0;
+  uint32_t nodes_offloaded = 0;
+  // Logical working set: most bytes of node results reachable at once (see
+  // NodeResults). Arena-backed columns are not freed until the request ends,
+  // so this is a lower bound on what the request actually keeps allocated.
+  size_t peak_result_working_set_bytes = 0;
 };
 
 // Execute plan and return results with schema delta trace.
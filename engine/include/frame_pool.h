@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace ranking {
+
+// FramePool: recycler for the small, short-lived blocks the async scheduler
+// allocates per node and per I/O operation - coroutine frames (Task promise
+// operator new), awaitable states (OffloadCpuWithTimeout / AsyncWithTimeout,
+// Redis command state, SleepState) and uv timers.
+//
+// Blocks are kept in power-of-two size classes on per-thread intrusive free
+// lists. Frames and states are created on the event loop thread, so in
+// practice its cache serves nearly every allocation with no locking or
+// atomics beyond the stats counters. A block freed on another thread (a
+// state whose last reference drops on a CPU worker) lands in that thread's
+// cache; every cache is capped, and frees beyond the cap go straight back to
+// the system allocator.
+//
+// Requests larger than the largest class bypass the pool. Blocks carry the
+// default new alignment only; over-aligned types must not use the pool.
+//
+// Thread-safe. The instance is never destroyed, so blocks freed during
+// thread or process exit still have somewhere to go.
+class FramePool {
+public:
+  static constexpr size_t kMinClassShift = 6;  // 64 B
+  static constexpr size_t kMaxClassShift = 13; // 8 KiB
+  static constexpr size_t kNumClasses = kMaxClassShift - kMinClassShift + 1;
+  static constexpr size_t kDefaultThreadCacheBlocks = 1024;
+
+  static FramePool &instance();
+
+  FramePool(const FramePool &) = delete;
+  FramePool &operator=(const FramePool &) = delete;
+
+  void *allocate(size_t bytes);
+  void deallocate(void *p, size_t bytes) noexcept;
+
+  // Blocks each thread keeps per size class (0 disables pooling: every
+  // allocation goes to the system allocator). Lowering the cap does not
+  // release already-cached blocks; call trim() for that.
+  void setThreadCacheLimit(size_t blocks) {
+    thread_cache_limit_.store(blocks, std::memory_order_relaxed);
+  }
+  size_t threadCacheLimit() const {
+    return thread_cache_limit_.load(std::memory_order_relaxed);
+  }
+
+  // All allocations, and those served by the system allocator (cache miss,
+  // pooling disabled, or too large)
+  uint64_t allocations() const {
+    return allocations_.load(std::memory_order_relaxed);
+  }
+  uint64_t systemAllocations() const {
+    return system_allocations_.load(std::memory_order_relaxed);
+  }
+
+  // Release the calling thread's cached blocks to the system allocator
+  void trim();
+
+  // Size class index for a request, or kNumClasses if it bypasses the pool
+  static size_t classIndex(size_t bytes);
+  static size_t classBytes(size_t index) {
+    return size_t{1} << (index + kMinClassShift);
+  }
+
+private:
+  struct ThreadCache;
+
+  FramePool() = default;
+
+  static ThreadCache *threadCache();
+
+  std::atomic<size_t> thread_cache_limit_{kDefaultThreadCacheBlocks};
+  std::atomic<uint64_t> allocations_{0};
+  std::atomic<uint64_t> system_allocations_{0};
+};
+
+// Standard allocator over FramePool, for std::allocate_shared of awaitable
+// states (one block holds the control block and the state)
+template <typename T>
+struct FramePoolAllocator {
+  using value_type = T;
+
+  FramePoolAllocator() = default;
+  template <typename U>
+  FramePoolAllocator(const FramePoolAllocator<U> &) noexcept {}
+
+  T *allocate(size_t n) {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "FramePool blocks have default new alignment only");
+    return static_cast<T *>(FramePool::instance().allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t n) noexcept {
+    FramePool::instance().deallocate(p, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const FramePoolAllocator<U> &) const noexcept {
+    return true;
+  }
+};
+
+// std::make_shared, with the allocation served by FramePool
+template <typename T, typename... Args>
+std::shared_ptr<T> make_pooled_shared(Args &&...args) {
+  return std::allocate_shared<T>(FramePoolAllocator<T>(),
+                                 std::forward<Args>(args)...);
+}
+
+} // namespace ranking
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rankd {
+
+// HydrationCache: process-wide cache of hydrated user:{id} hash fields.
+//
+// Popular users are hydrated again by every request and every source task
+// (follow, recommendation, viewer). Values fetched from Redis are kept here,
+// keyed by (endpoint id, user id, key id), so later requests skip the round
+// trip. Entries from one endpoint never answer reads against another.
+//
+// Off by default (capacity 0): a hit may be up to ttl() older than Redis, so
+// callers opt in to that staleness with setCapacity().
+//
+// - Sharded by key hash. Lookups take only a shard's shared lock, so
+//   concurrent hits (e.g. from the event loop thread) never serialize.
+// - Bounded: capacity() entries, split evenly across shards; each shard
+//   evicts with CLOCK (second chance), preferring expired entries.
+// - Entries expire ttl() after insertion.
+// - Negative caching: a missing user or field is cached as nullopt.
+//
+// Values are owned std::strings on the heap, never request arena memory, so
+// entries safely outlive the request that inserted them.
+//
+// Thread-safe. The instance is never destroyed.
+class HydrationCache {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t kNumShards = 16;
+  static constexpr size_t kDefaultCapacity = 0;
+  static constexpr std::chrono::milliseconds kDefaultTtl{30'000};
+
+  static HydrationCache &instance();
+
+  HydrationCache(const HydrationCache &) = delete;
+  HydrationCache &operator=(const HydrationCache &) = delete;
+
+  // Max entries across all shards (0 disables the cache). Shrinking evicts
+  // lazily, on the next insert into each shard.
+  void setCapacity(size_t entries) {
+    capacity_.store(entries, std::memory_order_relaxed);
+  }
+  size_t capacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+  void setTtl(std::chrono::milliseconds ttl) {
+    ttl_ms_.store(ttl.count(), std::memory_order_relaxed);
+  }
+  std::chrono::milliseconds ttl() const {
+    return std::chrono::milliseconds(ttl_ms_.load(std::memory_order_relaxed));
+  }
+
+  bool enabled() const { return capacity() > 0 && ttl().count() > 0; }
+
+  // Look up key_id of user:{id} on `endpoint`. Returns false on a miss; on a
+  // hit sets `value` (nullopt = cached as missing).
+  bool lookup(std::string_view endpoint, int64_t id, uint32_t key_id,
+              std::optional<std::string> &value);
+
+  // Look up key_id for each of `ids` on `endpoint`. Hits are written to
+  // values[i]; returns the indices that missed (all of them if the cache is
+  // disabled).
+  std::vector<size_t> lookupMany(std::string_view endpoint,
+                                 std::span<const int64_t> ids,
+                                 uint32_t key_id,
+                                 std::vector<std::optional<std::string>> &values);
+
+  // Cache key_id of user:{id} on `endpoint`; nullopt records the user or
+  // field as missing
+  void insert(std::string_view endpoint, int64_t id, uint32_t key_id,
+              std::optional<std::string> value);
+
+  // Drop all entries (metrics are kept)
+  void clear();
+
+  size_t size() const;
+
+  // Metrics
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  uint64_t negativeHits() const {
+    return negative_hits_.load(std::memory_order_relaxed);
+  }
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+  uint64_t evictions() const {
+    return evictions_.load(std::memory_order_relaxed);
+  }
+  uint64_t expirations() const {
+    return expirations_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Key {
+    std::string endpoint;
+    int64_t id;
+    uint32_t key_id;
+    bool operator==(const Key &) const = default;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &k) const {
+      uint64_t h = static_cast<uint64_t>(k.id) * 0x9e3779b97f4a7c15ULL;
+      return static_cast<size_t>(h ^ (h >> 29) ^ k.key_id) ^
+             (std::hash<std::string>{}(k.endpoint) * 0xff51afd7ed558ccdULL);
+    }
+  };
+  struct Entry {
+    std::optional<std::string> value;
+    Clock::time_point expires_at;
+    mutable std::atomic<bool> referenced{false}; // CLOCK bit, set on hit
+  };
+  struct Shard {
+    mutable std::shared_mutex mu;
+    std::unordered_map<Key, Entry, KeyHash> map; // guarded by mu
+    std::vector<Key> ring;                        // CLOCK order, guarded by mu
+    size_t hand = 0;                              // guarded by mu
+  };
+
+  HydrationCache() = default;
+
+  Shard &shardFor(const Key &key) {
+    return shards_[KeyHash{}(key) % kNumShards];
+  }
+  bool lookupAt(const Key &key, Clock::time_point now,
+                std::optional<std::string> &value);
+  // Remove the entry in ring slot `slot` (caller holds the unique lock)
+  static void eraseSlot(Shard &shard, size_t slot);
+  // Advance the CLOCK hand to a victim and evict it (caller holds the lock)
+  void evictOne(Shard &shard);
+
+  std::array<Shard, kNumShards> shards_;
+
+  std::atomic<size_t> capacity_{kDefaultCapacity};
+  std::atomic<int64_t> ttl_ms_{kDefaultTtl.count()};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> negative_hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> expirations_{0};
+};
+
+} // namespace rankd
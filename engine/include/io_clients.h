@@ -20,6 +20,10 @@ namespace rankd {
  * connected clients (Redis, etc.) for the lifetime of the request.
  * This avoids creating a new connection per task invocation.
  *
+ * Redis clients are checked out of the process-wide RedisConnectionPool on
+ * first use and returned when the request ends, so connections outlive the
+ * request and the next request skips the TCP connect.
+ *
  * Thread safety: Thread-safe. Multiple nodes in a DAG may access
  * concurrently under Level 2 parallelism. Internal mutex protects
  * the client cache map.
@@ -29,7 +33,7 @@ struct IoClients {
   // Thread-safe: uses internal mutex to protect cache access.
   RedisClient& getRedis(const EndpointRegistry& endpoints, std::string_view endpoint_id);
 
-  // Destructor cleans up all clients
+  // Destructor returns all clients to the connection pool
   ~IoClients();
 
   // Non-copyable, non-movable (has mutex)
@@ -40,9 +44,14 @@ struct IoClients {
   IoClients& operator=(IoClients&&) = delete;
 
  private:
+  struct PooledRedis {
+    EndpointSpec endpoint;  // Pool key on return
+    std::unique_ptr<RedisClient> client;
+  };
+
   // Cache of Redis clients by endpoint_id
-  // Clients are created on first use and reused for the request lifetime
-  std::unordered_map<std::string, std::unique_ptr<RedisClient>> redis_by_endpoint_;
+  // Clients are checked out on first use and reused for the request lifetime
+  std::unordered_map<std::string, PooledRedis> redis_by_endpoint_;
   mutable std::mutex mutex_;
 };
 
@@ -85,6 +94,9 @@ inline RedisClient& GetRedisClient(const ExecCtx& ctx, std::string_view endpoint
  *   auto result = WithInflightLimit(ctx, endpoint_id,
  *       [](RedisClient& redis) { return redis.hgetall("key"); });
  *
+ * A pipelined batch (lrange_batch/hgetall_batch) holds a single slot for the
+ * whole batch, since it occupies the connection as one round trip.
+ *
  * @param ctx Execution context
  * @param endpoint_id The endpoint ID (e.g., "ep_0001")
  * @param op Lambda that takes RedisClient& and returns the result
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "rowset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace rankd {
+
+// NodeResults: per-node output RowSets for one plan execution, each released
+// as soon as its last consumer has completed.
+//
+// Holding every result until the plan finishes keeps each node's batch and
+// selection/order buffers alive long after the nodes that read them are done,
+// so for wide fan-out plans the peak footprint is the sum of all outputs
+// rather than the live working set. Instead, every node starts with one
+// reference per consumer:
+// - each plan node that reads it as an input or NodeRef param (addEdge, once
+//   per edge, so a node read twice by the same child counts twice);
+// - each plan output naming it (addOutput), held until the end.
+// complete() stores a node's result and drops one reference from each of its
+// parents; a parent whose count reaches zero is released.
+//
+// The working set counts the distinct buffers (see RowSet::forEachBuffer)
+// reachable from held results, so columns shared between a parent's and a
+// child's batch are counted once. It is a logical figure, not resident
+// memory: releasing a result frees its selection/order and heap buffers, but
+// columns allocated from a RequestArena (the default for node outputs) stay
+// allocated until the request ends, so the process never drops to it.
+//
+// Not thread-safe: the parallel scheduler calls complete() under its mutex.
+// get() may run concurrently with complete() of other nodes, since a result
+// is never released while one of its consumers is still running.
+class NodeResults {
+public:
+  explicit NodeResults(size_t num_nodes = 0) { reset(num_nodes); }
+
+  NodeResults(const NodeResults &) = delete;
+  NodeResults &operator=(const NodeResults &) = delete;
+
+  void reset(size_t num_nodes);
+
+  // `child_idx` reads `parent_idx`'s result
+  void addEdge(size_t parent_idx, size_t child_idx);
+
+  // `node_idx`'s result is a plan output: never released
+  void addOutput(size_t node_idx);
+
+  // Store `node_idx`'s result, then release parents with no consumers left
+  void complete(size_t node_idx, RowSet result);
+
+  // Result of a completed node that still has consumers
+  const RowSet &get(size_t node_idx) const { return *results_[node_idx]; }
+
+  bool has(size_t node_idx) const { return results_[node_idx].has_value(); }
+
+  // Bytes of distinct buffers reachable from held results now / at most so
+  // far (logical working set, not RSS)
+  size_t workingSetBytes() const { return working_set_bytes_; }
+  size_t peakWorkingSetBytes() const { return peak_working_set_bytes_; }
+
+private:
+  struct BufferRef {
+    size_t bytes = 0;
+    uint32_t refs = 0;
+  };
+
+  void release(size_t node_idx);
+
+  std::vector<std::optional<RowSet>> results_;
+  std::vector<uint32_t> consumers_;          // remaining consumers per node
+  std::vector<std::vector<size_t>> parents_; // one entry per edge
+  std::unordered_map<const void *, BufferRef> buffers_;
+  size_t working_set_bytes_ = 0;
+  size_t peak_working_set_bytes_ = 0;
+};
+
+} // namespace rankd
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "rowset.h"
+#include <atomic>
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -72,6 +74,77 @@ enum class OutputPattern {
 // Convert OutputPattern to string for error messages
 const char *outputPatternToString(OutputPattern pattern);
 
+// =============================================================================
+// OutputValidation: how much checking validateTaskOutput does per request
+// =============================================================================
+//
+// Full checks of StableFilter, PrefixOfInput and PermutationOfInput
+// materialize input and output active rows (and sort both for permutations),
+// which can cost more than the task itself. The level trades that cost
+// against coverage:
+//
+// - Full: every check on every node (default).
+// - Structural: O(1) checks. Row counts as in Full. An active-row contract is
+//   accepted without materializing rows only when it holds by construction:
+//   the output is input[0]'s own view, or its RowSet provenance shows it
+//   was built directly from input[0] by a refinement builder (filterActive
+//   or truncateTo for StableFilter, truncateTo with the expected count for
+//   PrefixOfInput, sortActive for PermutationOfInput). Outputs built from
+//   caller-supplied indices (withSelection*, withOrder) or any other way get
+//   the full check, so structural validation catches the same violations as
+//   Full.
+// - Sampled: Full on 1 in sampleEvery() requests, Structural otherwise.
+//
+// The schedulers call beginRequest() once per plan execution, so every node
+// of a request is checked at the same level. Thread-safe; never destroyed.
+enum class ValidationLevel { Full, Structural, Sampled };
+
+// Parse "full" / "structural" / "sampled" (nullopt otherwise)
+std::optional<ValidationLevel> parseValidationLevel(const std::string &name);
+
+class OutputValidation {
+public:
+  static constexpr uint64_t kDefaultSampleEvery = 100;
+
+  static OutputValidation &instance();
+
+  OutputValidation(const OutputValidation &) = delete;
+  OutputValidation &operator=(const OutputValidation &) = delete;
+
+  void setLevel(ValidationLevel level) {
+    level_.store(level, std::memory_order_relaxed);
+  }
+  ValidationLevel level() const { return level_.load(std::memory_order_relaxed); }
+
+  // Sampled level: full checks on 1 in `n` requests (0 is treated as 1)
+  void setSampleEvery(uint64_t n) {
+    sample_every_.store(n, std::memory_order_relaxed);
+  }
+  uint64_t sampleEvery() const {
+    return sample_every_.load(std::memory_order_relaxed);
+  }
+
+  // Start a request: true if its nodes get full checks
+  bool beginRequest();
+
+  // Structural checks that could not be proven from provenance and ran the
+  // full check instead
+  uint64_t structuralFallbacks() const {
+    return structural_fallbacks_.load(std::memory_order_relaxed);
+  }
+  void noteStructuralFallback() {
+    structural_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  OutputValidation() = default;
+
+  std::atomic<ValidationLevel> level_{ValidationLevel::Full};
+  std::atomic<uint64_t> sample_every_{kDefaultSampleEvery};
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> structural_fallbacks_{0};
+};
+
 // =============================================================================
 // ValidateTaskOutput: Centralized output validation
 // =============================================================================
@@ -89,10 +162,12 @@ const char *outputPatternToString(OutputPattern pattern);
 //   inputs    - Task inputs (for validation against input shapes)
 //   params    - Validated parameters (for extracting fanout, count, etc.)
 //   output    - Task output to validate
+//   full      - Full checks (true) or structural ones (see OutputValidation)
 //
 void validateTaskOutput(const std::string &node_id, const std::string &op,
                         OutputPattern pattern,
                         const std::vector<RowSet> &inputs,
-                        const ValidatedParams &params, const RowSet &output);
+                        const ValidatedParams &params, const RowSet &output,
+                        bool full = true);
 
 } // namespace rankd
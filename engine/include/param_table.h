@@ -1,16 +1,20 @@
 #pragma once
 
 #include "param_registry.h"
+#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace rankd {
 
@@ -239,6 +243,12 @@ struct ExecStats {
   std::atomic<uint64_t> regex_re2_calls{0}; // Number of RE2 regex evaluations (per dict entry)
 };
 
+// Per-node IO counters, filled in by IO tasks
+// Atomic: a late-completing task may still write after the node timed out
+struct NodeIoStats {
+  std::atomic<uint64_t> bytes_received{0}; // reply payload bytes (excl. framing)
+};
+
 // Forward declaration for RowSet
 class RowSet;
 
@@ -265,8 +275,26 @@ struct ExecCtx {
   const EndpointRegistry *endpoints = nullptr;
   // Per-request IO client cache (Redis, etc.) - mutable for lazy initialization
   IoClients *clients = nullptr;
+  // Per-request arena (RequestArena) for column storage; null = heap.
+  // Batches created by tasks keep it alive.
+  std::shared_ptr<std::pmr::memory_resource> arena;
+  // Keys descendants may read from this node's output (Node::live_keys);
+  // null = all. Sources skip hydrating fields nobody reads.
+  std::shared_ptr<const std::vector<uint32_t>> live_keys;
+  // Per-node IO counters (nullable)
+  NodeIoStats *io_stats = nullptr;
   // Enable within-request DAG parallelism (Level 2)
   bool parallel = false;
+
+  bool isKeyLive(uint32_t key_id) const {
+    return !live_keys ||
+           std::binary_search(live_keys->begin(), live_keys->end(), key_id);
+  }
+  void addBytesReceived(uint64_t bytes) const {
+    if (io_stats) {
+      io_stats->bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
 };
 
 } // namespace rankd
@@ -10,6 +10,8 @@
 
 namespace rankd {
 
+struct NodeCostSlot;
+
 struct Node {
   std::string node_id;
   std::string op;
@@ -22,6 +24,17 @@ struct Node {
   // RFC0005: Evaluated writes contract (populated during validation)
   EffectKind writes_eval_kind = EffectKind::Unknown;
   std::vector<uint32_t> writes_eval_keys;  // sorted, deduped; empty for Unknown
+
+  // Keys that descendant nodes may read from this node's output (expr/pred
+  // key_refs and key params), sorted and deduped. Populated during validation.
+  // nullptr = every key is live: the output reaches a plan output (which
+  // emits all columns), or the plan was not validated.
+  std::shared_ptr<const std::vector<uint32_t>> live_keys;
+
+  // This node's latency history in NodeCostModel, resolved during validation
+  // so recording a sample needs no key or lock. nullptr = the plan was not
+  // validated (or the model is full); NodeCostModel looks the node up by key.
+  NodeCostSlot *cost_slot = nullptr;
 };
 
 // ExprNode: recursive expression tree (for vm expressions)
@@ -86,6 +99,11 @@ struct PredNode {
 // Parse PredNode from JSON. Throws on invalid structure.
 PredNodePtr parse_pred_node(const nlohmann::json &j);
 
+// Append every key_id an expression / predicate reads (key_ref operands and
+// regex keys). May produce duplicates.
+void collect_key_refs(const ExprNode &node, std::vector<uint32_t> &out);
+void collect_key_refs(const PredNode &node, std::vector<uint32_t> &out);
+
 struct Plan {
   int schema_version = 0;
   std::string plan_name;
@@ -3,6 +3,7 @@
 #include "endpoint_registry.h"
 #include <expected>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +38,27 @@ class RedisClient {
   std::expected<std::unordered_map<std::string, std::string>, std::string>
   hgetall(const std::string& key);
 
+  // HMGET key field... - get selected hash fields (only those are transferred)
+  // Returns one value per field (nullopt if absent), error message on failure
+  std::expected<std::vector<std::optional<std::string>>, std::string> hmget(
+      const std::string& key, const std::vector<std::string>& fields);
+
+  // Pipelined batches: send one command per key, then read all replies, so
+  // the whole batch costs about one round trip. Results are in key order.
+  // Any failed command fails the batch (remaining replies are still drained
+  // so the connection stays in sync).
+  std::expected<std::vector<std::vector<std::string>>, std::string> lrange_batch(
+      const std::vector<std::string>& keys, int64_t start, int64_t stop);
+  std::expected<std::vector<std::unordered_map<std::string, std::string>>, std::string>
+  hgetall_batch(const std::vector<std::string>& keys);
+  std::expected<std::vector<std::vector<std::optional<std::string>>>, std::string>
+  hmget_batch(const std::vector<std::string>& keys,
+              const std::vector<std::string>& fields);
+
+  // PING - health check; connects if needed. False (and disconnected) if the
+  // connection is unusable.
+  bool ping();
+
   // Check if connected
   bool connected() const { return ctx_ != nullptr; }
 
@@ -50,6 +72,16 @@ class RedisClient {
   // Disconnect and clear state
   void disconnect();
 
+  // Pipeline one formatted command per key (at most kMaxPipelineDepth in
+  // flight) and hand each reply to on_reply(i, reply). Caller holds mutex_.
+  template <typename Format, typename OnReply>
+  std::expected<void, std::string> pipeline(const char* cmd_name, size_t count,
+                                            Format&& format, OnReply&& on_reply);
+
+  // Commands written before reading replies back; bounds the client and
+  // server output buffers for very large batches
+  static constexpr size_t kMaxPipelineDepth = 1024;
+
   std::string host_;
   int port_ = 0;
   int connect_timeout_ms_ = 50;
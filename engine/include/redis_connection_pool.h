@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "endpoint_registry.h"
+#include "redis_client.h"
+
+namespace rankd {
+
+// RedisConnectionPool: process-wide pool of sync Redis connections.
+//
+// IoClients is created per request (per iteration in --bench), so without
+// pooling every request pays a TCP connect plus redisSetTimeout before its
+// first command. Requests check a RedisClient out here on first use of an
+// endpoint and return it when the request ends; the next request reuses the
+// open connection.
+//
+// - Keyed by endpoint id and address, so registries that reuse an id for a
+//   different host never share connections.
+// - LIFO per endpoint: the most recently used (warmest) connection goes
+//   out first. At most maxIdle() connections per endpoint are kept.
+// - Health check: a connection idle for longer than kHealthCheckAfterIdle is
+//   PINGed at checkout. A failed PING drops the socket; RedisClient then
+//   reconnects lazily on its next command.
+// - Connections that broke while checked out are not returned.
+//
+// Thread-safe. The instance is never destroyed.
+class RedisConnectionPool {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t kDefaultMaxIdle = 64;
+  static constexpr std::chrono::seconds kHealthCheckAfterIdle{5};
+
+  static RedisConnectionPool &instance();
+
+  RedisConnectionPool(const RedisConnectionPool &) = delete;
+  RedisConnectionPool &operator=(const RedisConnectionPool &) = delete;
+
+  // Idle connections kept per endpoint (0 disables pooling)
+  void setMaxIdle(size_t connections) {
+    max_idle_.store(connections, std::memory_order_relaxed);
+  }
+  size_t maxIdle() const { return max_idle_.load(std::memory_order_relaxed); }
+
+  // Take an idle connection for `endpoint`, or a new (lazily connecting)
+  // client if none is idle
+  std::unique_ptr<RedisClient> checkout(const EndpointSpec &endpoint);
+
+  // Give a client from checkout() back for reuse
+  void checkin(const EndpointSpec &endpoint, std::unique_ptr<RedisClient> client);
+
+  // Close all idle connections (metrics are kept)
+  void clear();
+
+  size_t idleCount() const;
+
+  // Metrics
+  uint64_t reuses() const { return reuses_.load(std::memory_order_relaxed); }
+  uint64_t creates() const { return creates_.load(std::memory_order_relaxed); }
+  uint64_t healthCheckFailures() const {
+    return health_check_failures_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Idle {
+    std::unique_ptr<RedisClient> client;
+    Clock::time_point since;
+  };
+
+  RedisConnectionPool() = default;
+
+  static std::string poolKey(const EndpointSpec &endpoint);
+
+  mutable std::mutex mu_;
+  std::unordered_map<std::string, std::vector<Idle>> idle_; // guarded by mu_
+
+  std::atomic<size_t> max_idle_{kDefaultMaxIdle};
+  std::atomic<uint64_t> reuses_{0};
+  std::atomic<uint64_t> creates_{0};
+  std::atomic<uint64_t> health_check_failures_{0};
+};
+
+} // namespace rankd
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "column_buffer_pool.h"
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace rankd {
+
+// RequestArena: bump allocator for one request's column and selection storage.
+//
+// Everything a request allocates (source columns, vm output columns, selection
+// bitmaps) dies together when the request completes, so individual frees are
+// no-ops and the whole arena is released in bulk on destruction.
+//
+// Thread-safe: nodes of a parallel DAG allocate concurrently from the same
+// arena.
+//
+// Chunks come from the process-wide ColumnBufferPool by default, so the next
+// request reuses this request's (already faulted-in) memory.
+//
+// Lifetime: ColumnBatch holds a shared_ptr to the resource its columns were
+// allocated from, so the arena outlives every batch (and every late-completing
+// task after a timeout) that still references its memory.
+class RequestArena : public std::pmr::memory_resource {
+public:
+  static constexpr size_t kDefaultInitialBytes = 64 * 1024;
+
+  explicit RequestArena(
+      size_t initial_bytes = kDefaultInitialBytes,
+      std::pmr::memory_resource *upstream = &ColumnBufferPool::instance())
+      : mono_(initial_bytes, upstream) {}
+
+  RequestArena(const RequestArena &) = delete;
+  RequestArena &operator=(const RequestArena &) = delete;
+
+  // Bytes handed out so far. Nothing is freed before destruction, so this is
+  // also the request's high-water mark.
+  size_t highWaterBytes() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return allocated_bytes_;
+  }
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    allocated_bytes_ += bytes;
+    return mono_.allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *, size_t, size_t) override {
+    // Released in bulk when the arena is destroyed
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  mutable std::mutex mu_;
+  std::pmr::monotonic_buffer_resource mono_;
+  size_t allocated_bytes_ = 0;
+};
+
+} // namespace rankd
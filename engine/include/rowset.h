@@ -2,8 +2,10 @@
 
 #include "column_batch.h"
 #include <algorithm>
+#include <bit>
 #include <memory>
-#include <optional>
+#include <memory_resource>
+#include <mutex>
 #include <type_traits>
 #include <vector>
 
@@ -14,6 +16,101 @@ using RowIndex = uint32_t;
 using SelectionVector = std::vector<RowIndex>;
 using Permutation = std::vector<RowIndex>;
 
+// Dense selection: one bit per batch row, iterated in ascending row order.
+// Cheaper than a SelectionVector when many rows are active: 1 bit per row
+// instead of 32 bits per active row, and traversal is a contiguous word scan.
+class SelectionBitmap {
+public:
+  explicit SelectionBitmap(size_t num_rows,
+                           std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : words_((num_rows + 63) / 64, 0, mr), num_rows_(num_rows) {}
+
+  // Build from ascending, duplicate-free indices
+  static SelectionBitmap fromIndices(const std::vector<RowIndex> &indices,
+                                     size_t num_rows,
+                                     std::pmr::memory_resource *mr =
+                                         std::pmr::get_default_resource()) {
+    SelectionBitmap bits(num_rows, mr);
+    for (RowIndex idx : indices) {
+      bits.set(idx);
+    }
+    return bits;
+  }
+
+  size_t numRows() const { return num_rows_; }
+
+  // Number of set bits
+  size_t count() const { return count_; }
+
+  bool test(RowIndex idx) const { return (words_[idx >> 6] >> (idx & 63)) & 1; }
+
+  void set(RowIndex idx) {
+    uint64_t &word = words_[idx >> 6];
+    uint64_t mask = uint64_t{1} << (idx & 63);
+    count_ += (word & mask) ? 0 : 1;
+    word |= mask;
+  }
+
+  const std::pmr::vector<uint64_t> &words() const { return words_; }
+
+  // Calls fn(RowIndex) for each set bit in ascending order; stops when fn
+  // returns false
+  template <typename Fn> void forEachSet(Fn &&fn) const {
+    for (size_t w = 0; w < words_.size(); ++w) {
+      uint64_t word = words_[w];
+      while (word) {
+        auto idx = static_cast<RowIndex>(w * 64 + std::countr_zero(word));
+        if (!fn(idx))
+          return;
+        word &= word - 1;
+      }
+    }
+  }
+
+  // Ascending index list of the set bits
+  SelectionVector toIndices() const {
+    SelectionVector out;
+    out.reserve(count_);
+    forEachSet([&](RowIndex idx) {
+      out.push_back(idx);
+      return true;
+    });
+    return out;
+  }
+
+  // True if every bit set here is also set in `other` (same row count)
+  bool isSubsetOf(const SelectionBitmap &other) const {
+    for (size_t w = 0; w < words_.size(); ++w) {
+      if (words_[w] & ~other.words_[w])
+        return false;
+    }
+    return true;
+  }
+
+  bool operator==(const SelectionBitmap &other) const {
+    return num_rows_ == other.num_rows_ && count_ == other.count_ &&
+           words_ == other.words_;
+  }
+
+private:
+  std::pmr::vector<uint64_t> words_;
+  size_t num_rows_;
+  size_t count_ = 0;
+};
+
+// Representation choice for an ascending selection of `active` rows out of
+// `num_rows`: a bitmap wins once it is no larger than the index vector
+// (num_rows / 8 bytes vs active * 4 bytes), i.e. density >= 1/32.
+inline bool preferSelectionBitmap(size_t active, size_t num_rows) {
+  return active * 32 >= num_rows;
+}
+
+// Immutable, refcounted index buffers. RowSets sharing a selection or order
+// point at the same buffer, so copying a RowSet never copies index data.
+using SelectionBuffer = std::shared_ptr<const SelectionVector>;
+using SelectionBitmapBuffer = std::shared_ptr<const SelectionBitmap>;
+using PermutationBuffer = std::shared_ptr<const Permutation>;
+
 // Forward declaration
 class RowSet;
 
@@ -21,10 +118,12 @@ class RowSet;
 // Does not own any data - lifetime must not exceed the RowSet it references
 class ActiveRows {
 public:
-  ActiveRows(const ColumnBatch *batch,
-             const std::optional<SelectionVector> *selection,
-             const std::optional<Permutation> *order)
-      : batch_(batch), selection_(selection), order_(order) {}
+  // indices is the active index list in iteration order; otherwise bitmap
+  // gives the active rows in ascending order. If both are null every row of
+  // the batch is active in natural order.
+  ActiveRows(const ColumnBatch *batch, const std::vector<RowIndex> *indices,
+             const SelectionBitmap *bitmap = nullptr)
+      : batch_(batch), indices_(indices), bitmap_(indices ? nullptr : bitmap) {}
 
   // Iterate over active row indices, calling fn(RowIndex) for each.
   // If fn returns false, iteration stops early. If fn returns void, iteration continues.
@@ -39,32 +138,15 @@ public:
       }
     };
 
-    if (*order_ && *selection_) {
-      // Both exist: iterate order, filter by selection membership
-      std::vector<uint8_t> in_selection(batch_->size(), 0);
-      for (RowIndex idx : **selection_) {
-        in_selection[idx] = 1;
-      }
-      for (RowIndex idx : **order_) {
-        if (in_selection[idx]) {
-          if (!call_fn(idx))
-            return;
-        }
-      }
-    } else if (*order_) {
-      // Only order exists
-      for (RowIndex idx : **order_) {
-        if (!call_fn(idx))
-          return;
-      }
-    } else if (*selection_) {
-      // Only selection exists
-      for (RowIndex idx : **selection_) {
+    if (indices_) {
+      for (RowIndex idx : *indices_) {
         if (!call_fn(idx))
           return;
       }
+    } else if (bitmap_) {
+      bitmap_->forEachSet(call_fn);
     } else {
-      // Neither: iterate [0..size)
+      // No selection or order: iterate [0..size)
       for (size_t i = 0; i < batch_->size(); ++i) {
         if (!call_fn(static_cast<RowIndex>(i)))
           return;
@@ -75,7 +157,7 @@ public:
   // Get up to `limit` row indices as a vector
   std::vector<RowIndex> toVector(size_t limit) const {
     std::vector<RowIndex> result;
-    result.reserve(std::min(limit, batch_->size()));
+    result.reserve(std::min(limit, size()));
 
     forEachIndex([&](RowIndex idx) -> bool {
       result.push_back(idx);
@@ -87,42 +169,61 @@ public:
 
   // Get the number of active rows
   size_t size() const {
-    if (*order_ && *selection_) {
-      // Count how many order entries are in selection
-      std::vector<uint8_t> in_selection(batch_->size(), 0);
-      for (RowIndex idx : **selection_) {
-        in_selection[idx] = 1;
-      }
-      size_t count = 0;
-      for (RowIndex idx : **order_) {
-        if (in_selection[idx])
-          count++;
-      }
-      return count;
-    } else if (*order_) {
-      return (*order_)->size();
-    } else if (*selection_) {
-      return (*selection_)->size();
-    } else {
-      return batch_->size();
-    }
+    if (indices_)
+      return indices_->size();
+    if (bitmap_)
+      return bitmap_->count();
+    return batch_->size();
   }
 
+  // Underlying active index list (null for bitmap or all-rows iteration)
+  const std::vector<RowIndex> *indices() const { return indices_; }
+
+  // Underlying bitmap (non-null only when iterating a bitmap selection)
+  const SelectionBitmap *bitmap() const { return bitmap_; }
+
+  // True if every row of the batch is active in natural order
+  bool isAllRows() const { return !indices_ && !bitmap_; }
+
 private:
   const ColumnBatch *batch_;
-  const std::optional<SelectionVector> *selection_;
-  const std::optional<Permutation> *order_;
+  const std::vector<RowIndex> *indices_;
+  const SelectionBitmap *bitmap_;
 };
 
 // RowSet: a view over a ColumnBatch with optional selection and ordering
 // Selection = which rows are active (filtered set)
 // Order = iteration order (permutation)
+//
+// Selection and order are held in immutable shared buffers: copying a RowSet
+// (scheduler inputs, offload captures, NodeRef resolution) bumps refcounts
+// instead of copying index vectors. Builders take ownership of the vectors
+// passed to them and share whichever buffer they do not replace.
+//
+// A selection is either an index vector (iteration order as given) or a
+// bitmap (ascending row order); producers pick the cheaper one with
+// preferSelectionBitmap. At most one of the two is present.
+//
+// When both selection and order are present, the active rows are the order
+// filtered by selection membership. That composed index list is computed
+// lazily on first traversal and cached (shared by copies), so repeated
+// iteration and size queries do not rebuild a membership mask.
+//
+// Builders whose result is a refinement of their source by construction
+// (filterActive, sortActive, truncateTo) record their provenance: which
+// builder made the RowSet and the identity (batch and buffer pointers, never
+// dereferenced) of the view it was applied to. Structural output-contract
+// validation uses it to accept a task's output in O(1) when it was built
+// directly from the task's input. withSelection* and withOrder take
+// caller-supplied indices, so they prove nothing and record no provenance.
 class RowSet {
 public:
+  // Refinement builder that produced a RowSet (None: any other way)
+  enum class Derivation : uint8_t { None, Filter, Sort, Truncate };
+
   // Construct with just a batch (all rows active, natural order)
   explicit RowSet(std::shared_ptr<const ColumnBatch> batch)
-      : batch_(std::move(batch)), selection_(std::nullopt), order_(std::nullopt) {
-  }
+      : batch_(std::move(batch)) {}
 
   // Access the underlying batch (read-only)
   const ColumnBatch &batch() const { return *batch_; }
@@ -134,7 +235,9 @@ public:
   size_t rowCount() const { return batch_->size(); }
 
   // Get a view for iterating over active rows
-  ActiveRows activeRows() const { return ActiveRows(batch_.get(), &selection_, &order_); }
+  ActiveRows activeRows() const {
+    return ActiveRows(batch_.get(), activeIndices(), bitmap_.get());
+  }
 
   // Returns up to `limit` row indices in iteration order (convenience wrapper)
   std::vector<RowIndex> materializeIndexViewForOutput(size_t limit) const {
@@ -145,26 +248,46 @@ public:
   size_t logicalSize() const { return activeRows().size(); }
 
   // Builder: create new RowSet with a different batch
+  // newBatch must share this batch's memory resource (e.g. derived from it via
+  // with*Column), since a bitmap selection may live in that resource.
   RowSet withBatch(std::shared_ptr<const ColumnBatch> newBatch) const {
     RowSet result(std::move(newBatch));
     result.selection_ = selection_;
+    result.bitmap_ = bitmap_;
     result.order_ = order_;
+    result.composed_ = composed_; // same rows, same composition
     return result;
   }
 
   // Builder: create new RowSet with a selection vector
   RowSet withSelection(SelectionVector sel) const {
     RowSet result(batch_);
-    result.selection_ = std::move(sel);
+    result.selection_ = std::make_shared<const SelectionVector>(std::move(sel));
     result.order_ = order_;
+    result.resetComposed();
+    return result;
+  }
+
+  // Builder: create new RowSet with a bitmap selection (numRows == rowCount())
+  RowSet withSelection(SelectionBitmap bits) const {
+    RowSet result(batch_);
+    result.bitmap_ = shareBitmap(std::move(bits));
+    result.order_ = order_;
+    result.resetComposed();
     return result;
   }
 
   // Builder: create new RowSet with a selection, clearing order
   RowSet withSelectionClearOrder(SelectionVector sel) const {
     RowSet result(batch_);
-    result.selection_ = std::move(sel);
-    result.order_ = std::nullopt;
+    result.selection_ = std::make_shared<const SelectionVector>(std::move(sel));
+    return result;
+  }
+
+  // Builder: create new RowSet with a bitmap selection, clearing order
+  RowSet withSelectionClearOrder(SelectionBitmap bits) const {
+    RowSet result(batch_);
+    result.bitmap_ = shareBitmap(std::move(bits));
     return result;
   }
 
@@ -172,30 +295,190 @@ public:
   RowSet withOrder(Permutation ord) const {
     RowSet result(batch_);
     result.selection_ = selection_;
-    result.order_ = std::move(ord);
+    result.bitmap_ = bitmap_;
+    result.order_ = std::make_shared<const Permutation>(std::move(ord));
+    result.resetComposed();
+    return result;
+  }
+
+  // Builder: keep the active rows for which keep(idx) is true, in iteration
+  // order, clearing order. An index-list input (ordered or sparse) yields an
+  // index vector; an ascending one is evaluated into a bitmap and keeps
+  // whichever representation is cheaper for the result density.
+  template <typename Keep> RowSet filterActive(Keep &&keep) const {
+    auto active = activeRows();
+    RowSet result(batch_);
+    if (const auto *indices = active.indices()) {
+      SelectionVector sel;
+      for (RowIndex idx : *indices) {
+        if (keep(idx)) {
+          sel.push_back(idx);
+        }
+      }
+      result.selection_ = std::make_shared<const SelectionVector>(std::move(sel));
+    } else {
+      SelectionBitmap bits(batch_->size(), batch_->resource());
+      active.forEachIndex([&](RowIndex idx) {
+        if (keep(idx)) {
+          bits.set(idx);
+        }
+      });
+      if (preferSelectionBitmap(bits.count(), batch_->size())) {
+        result.bitmap_ = shareBitmap(std::move(bits));
+      } else {
+        result.selection_ = std::make_shared<const SelectionVector>(bits.toIndices());
+      }
+    }
+    result.recordProvenance(Derivation::Filter, *this);
+    return result;
+  }
+
+  // Builder: order the active rows by `less`, stably (ties keep their
+  // iteration order). The selection is shared; the order holds exactly the
+  // active rows.
+  template <typename Less> RowSet sortActive(Less &&less) const {
+    Permutation ord = activeRows().toVector(rowCount());
+    std::stable_sort(ord.begin(), ord.end(), less);
+    RowSet result(batch_);
+    result.selection_ = selection_;
+    result.bitmap_ = bitmap_;
+    result.order_ = std::make_shared<const Permutation>(std::move(ord));
+    result.resetComposed();
+    result.recordProvenance(Derivation::Sort, *this);
     return result;
   }
 
   // Builder: truncate to at most `limit` active rows
   // Materializes active indices and creates a new selection
   RowSet truncateTo(size_t limit) const {
+    if (hasSelection() && !order_ && logicalSize() <= limit) {
+      return *this; // Already within limit: share the selection buffer
+    }
     auto indices = activeRows().toVector(limit);
     RowSet result(batch_);
-    result.selection_ = std::move(indices);
-    result.order_ = std::nullopt; // Order is baked into the new selection
+    // Order is baked into the new selection
+    result.selection_ = std::make_shared<const SelectionVector>(std::move(indices));
+    result.recordProvenance(Derivation::Truncate, *this);
     return result;
   }
 
-  // Check if selection is present
-  bool hasSelection() const { return selection_.has_value(); }
+  // Check if selection is present (index vector or bitmap)
+  bool hasSelection() const { return selection_ != nullptr || bitmap_ != nullptr; }
 
   // Check if order is present
-  bool hasOrder() const { return order_.has_value(); }
+  bool hasOrder() const { return order_ != nullptr; }
+
+  // Shared selection/order buffers (null if absent)
+  const SelectionBuffer &selectionBuffer() const { return selection_; }
+  const SelectionBitmapBuffer &selectionBitmap() const { return bitmap_; }
+  const PermutationBuffer &orderBuffer() const { return order_; }
+
+  // Builder that produced this RowSet
+  Derivation derivation() const { return provenance_.derivation; }
+
+  // True if derivation() was applied directly to `source`'s view: same batch
+  // and same selection/order buffers (copies of `source` qualify). O(1).
+  bool derivedFrom(const RowSet &source) const {
+    return provenance_.derivation != Derivation::None &&
+           provenance_.batch == source.batch_.get() &&
+           provenance_.selection == source.selection_.get() &&
+           provenance_.bitmap == source.bitmap_.get() &&
+           provenance_.order == source.order_.get();
+  }
+
+  // True if both RowSets share the batch and every selection/order buffer
+  bool sameView(const RowSet &other) const {
+    return batch_ == other.batch_ && selection_ == other.selection_ &&
+           bitmap_ == other.bitmap_ && order_ == other.order_;
+  }
+
+  // Calls fn(const void *buffer, size_t bytes) for the batch's buffers (see
+  // ColumnBatch::forEachBuffer) and this RowSet's selection/order buffers.
+  // The lazily composed index cache is not reported.
+  template <typename Fn> void forEachBuffer(Fn &&fn) const {
+    batch_->forEachBuffer(fn);
+    if (selection_) {
+      fn(selection_.get(), selection_->capacity() * sizeof(RowIndex));
+    }
+    if (bitmap_) {
+      fn(bitmap_.get(), bitmap_->words().capacity() * sizeof(uint64_t));
+    }
+    if (order_) {
+      fn(order_.get(), order_->capacity() * sizeof(RowIndex));
+    }
+  }
 
 private:
+  // Order filtered by selection, built at most once per (selection, order) pair
+  struct ComposedIndices {
+    std::once_flag once;
+    std::vector<RowIndex> indices;
+  };
+
+  // Bitmap buffers live in the batch's memory resource, like its columns
+  // (batch_ is destroyed last, so the resource outlives the buffer)
+  SelectionBitmapBuffer shareBitmap(SelectionBitmap bits) const {
+    return std::allocate_shared<SelectionBitmap>(
+        std::pmr::polymorphic_allocator<SelectionBitmap>(batch_->resource()),
+        std::move(bits));
+  }
+
+  // Identity of the view a builder was applied to. Compared by address only
+  // while the source is alive (the task's input during validation).
+  struct Provenance {
+    Derivation derivation = Derivation::None;
+    const void *batch = nullptr;
+    const void *selection = nullptr;
+    const void *bitmap = nullptr;
+    const void *order = nullptr;
+  };
+
+  void recordProvenance(Derivation derivation, const RowSet &source) {
+    provenance_ = {derivation, source.batch_.get(), source.selection_.get(),
+                   source.bitmap_.get(), source.order_.get()};
+  }
+
+  void resetComposed() {
+    composed_ = (hasSelection() && order_) ? std::make_shared<ComposedIndices>() : nullptr;
+  }
+
+  // Active index list in iteration order. Null means bitmap_ (if set) or all
+  // rows in natural order.
+  const std::vector<RowIndex> *activeIndices() const {
+    if (composed_) {
+      std::call_once(composed_->once, [this] {
+        auto &out = composed_->indices;
+        if (bitmap_) {
+          out.reserve(std::min(order_->size(), bitmap_->count()));
+          for (RowIndex idx : *order_) {
+            if (bitmap_->test(idx))
+              out.push_back(idx);
+          }
+          return;
+        }
+        std::vector<uint8_t> in_selection(batch_->size(), 0);
+        for (RowIndex idx : *selection_) {
+          in_selection[idx] = 1;
+        }
+        out.reserve(std::min(order_->size(), selection_->size()));
+        for (RowIndex idx : *order_) {
+          if (in_selection[idx])
+            out.push_back(idx);
+        }
+      });
+      return &composed_->indices;
+    }
+    if (order_)
+      return order_.get();
+    return selection_.get();
+  }
+
   std::shared_ptr<const ColumnBatch> batch_;
-  std::optional<SelectionVector> selection_;
-  std::optional<Permutation> order_;
+  SelectionBuffer selection_;     // index-vector selection, or
+  SelectionBitmapBuffer bitmap_;  // bitmap selection (never both)
+  PermutationBuffer order_;
+  std::shared_ptr<ComposedIndices> composed_; // non-null iff selection && order_
+  Provenance provenance_;
 };
 
 } // namespace rankd
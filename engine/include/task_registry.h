@@ -50,6 +50,7 @@ struct ParamField {
   bool nullable = false; // if true, null is a valid value
   std::optional<ParamDefaultValue> default_value; // used when absent or null
   std::optional<EndpointKind> endpoint_kind;  // For EndpointRef: required kind
+  bool reads_key = false;  // For Int: value is a key_id the task reads
 };
 
 // Default budget for task execution (MVP: included but ignored by executor)
@@ -78,6 +79,17 @@ struct TaskSpec {
   // instead of wrapping run() with OffloadCpu. Used by IO-bound tasks (Redis)
   // and sleep task to natively suspend on the event loop.
   AsyncTaskFn run_async;  // nullptr if not implemented
+
+  // Optional static runtime estimate in microseconds, from the node's raw
+  // params. Seeds critical-path scheduling until the node has latency
+  // history (see NodeCostModel).
+  std::function<double(const nlohmann::json &params)> estimate_cost_us;
+
+  // Estimated CPU cost per input row, in ns. The async scheduler runs a
+  // task without run_async inline on the event loop thread, instead of
+  // offloading it, when input rows x this is below the inline threshold
+  // (see NodeCostModel::runsInline). 0 = always offload.
+  double inline_row_cost_ns = 0;
 };
 
 // Compute the effective writes contract expression from a TaskSpec.
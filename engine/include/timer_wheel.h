@@ -0,0 +1,110 @@
+#pragma once
+
+#include <uv.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ranking {
+
+// TimerWheel: hashed timing wheel for deadlines on one libuv loop.
+//
+// Node and Redis deadlines are armed for nearly every operation and almost
+// always cancelled before they fire. Giving each its own uv_timer_t costs a
+// heap insert and removal in libuv's timer heap (O(log n) with thousands
+// pending) plus a handle init/close round trip. The wheel instead hashes
+// each deadline into one of kSlots 1 ms buckets by its expiry tick:
+//
+// - schedule() and cancel() are O(1) list operations on an intrusive Entry
+//   embedded in the caller's state (no allocation);
+// - one one-shot uv timer is armed for the earliest pending expiry, so the
+//   loop only wakes when an entry may be due (a cancelled entry can leave
+//   one spurious wakeup), and sleeps while only far-future entries remain;
+// - a wakeup walks the buckets of the ticks it catches up on; entries more
+//   than kSlots ticks out stay put until their own lap comes round.
+//
+// Ticks are uv_now() milliseconds, so resolution is 1 ms like uv timers: an
+// entry fires on the first wakeup at or after its expiry. Loop thread only.
+class TimerWheel {
+public:
+  static constexpr uint64_t kTickMs = 1;
+  static constexpr size_t kSlots = 512; // power of two
+
+  // Intrusive timer, embedded in the owner's state. Must stay at the same
+  // address while armed; destroying an armed entry cancels it.
+  class Entry {
+  public:
+    using Callback = void (*)(Entry *);
+
+    Entry() = default;
+    ~Entry() { cancel(); }
+
+    Entry(const Entry &) = delete;
+    Entry &operator=(const Entry &) = delete;
+
+    bool armed() const { return head_ != nullptr; }
+
+    // Disarm without firing. Idempotent.
+    void cancel();
+
+    void *data = nullptr; // For the callback, like uv_handle_t::data
+
+  private:
+    friend class TimerWheel;
+
+    TimerWheel *wheel_ = nullptr;
+    Entry **head_ = nullptr; // List this entry is linked into
+    Entry *prev_ = nullptr;
+    Entry *next_ = nullptr;
+    uint64_t expiry_tick_ = 0;
+    Callback callback_ = nullptr;
+  };
+
+  explicit TimerWheel(uv_loop_t *loop);
+  // Disarms pending entries without firing them. The tick timer must be
+  // closed first: close(), or closing every handle of the loop as
+  // EventLoop does on stop.
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel &) = delete;
+  TimerWheel &operator=(const TimerWheel &) = delete;
+
+  // Fire `callback(&entry)` after `delay_ms` (at least one tick). Re-arms an
+  // already armed entry.
+  void schedule(Entry &entry, uint64_t delay_ms, Entry::Callback callback);
+
+  // Close the tick timer handle (owners that close the loop themselves)
+  void close();
+
+  // Armed entries
+  size_t size() const { return size_; }
+
+  // Tick timer wakeups so far (for benchmarks)
+  uint64_t ticks() const { return ticks_; }
+
+private:
+  static constexpr uint64_t kNotArmed = UINT64_MAX;
+
+  static void OnTick(uv_timer_t *timer);
+  void advance(uint64_t now_ms);
+  // Earliest expiry among armed entries (size_ > 0)
+  uint64_t next_expiry() const;
+  void arm(uint64_t tick, uint64_t now_ms);
+  void link(Entry &entry, Entry **head);
+  void unlink(Entry &entry);
+
+  uv_loop_t *loop_;
+  std::array<Entry *, kSlots> slots_{};
+  Entry *expired_ = nullptr; // Entries due on the tick being processed
+  size_t size_ = 0;
+  uint64_t current_tick_ = 0; // Last tick processed (uv_now() ms)
+  uint64_t ticks_ = 0;
+  // Tick the uv timer fires at; 0 while advance() runs (it re-arms at the
+  // end), kNotArmed when stopped
+  uint64_t armed_tick_ = kNotArmed;
+  bool running_ = false;
+  uv_timer_t tick_timer_; // Not the first member: data != handle address
+};
+
+} // namespace ranking
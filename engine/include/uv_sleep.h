@@ -3,13 +3,16 @@
 #include <uv.h>
 
 #include <coroutine>
+#include <cstddef>
 
+#include "cancellation.h"
 #include "event_loop.h"
+#include "frame_pool.h"
 
 namespace ranking {
 
 // Internal state for a sleep operation.
-// Allocated on the heap and self-destructs after the timer closes.
+// Allocated from FramePool and self-destructs after the timer closes.
 //
 // IMPORTANT: The owning Task must remain alive until the timer fires.
 // If the Task is destroyed while suspended, this handle becomes dangling
@@ -17,10 +20,13 @@ namespace ranking {
 struct SleepState {
   uv_timer_t timer;
   std::coroutine_handle<> handle;
+  CancellationToken::Registration cancel_reg;  // Ends the sleep early
 
+  // Also run on cancellation, with the timer still pending
   static void OnTimer(uv_timer_t* t) {
     auto* state = reinterpret_cast<SleepState*>(t);
     auto h = state->handle;
+    state->cancel_reg.reset();
 
     // Stop the timer and close the handle
     uv_timer_stop(t);
@@ -34,27 +40,41 @@ struct SleepState {
     auto* state = reinterpret_cast<SleepState*>(h);
     delete state;
   }
+
+  static void* operator new(std::size_t size) { return FramePool::instance().allocate(size); }
+  static void operator delete(void* p, std::size_t size) noexcept {
+    FramePool::instance().deallocate(p, size);
+  }
 };
 
 // Awaitable that suspends the coroutine for a given number of milliseconds
-// using a libuv timer on the event loop.
+// using a libuv timer on the event loop. Cancelling `cancel` wakes it early.
 class SleepAwaitable {
 public:
-  SleepAwaitable(EventLoop& loop, uint64_t ms) : loop_(loop), ms_(ms) {}
+  SleepAwaitable(EventLoop& loop, uint64_t ms, CancellationToken cancel = {})
+      : loop_(loop), ms_(ms), cancel_(std::move(cancel)) {}
 
-  bool await_ready() const noexcept { return ms_ == 0; }
+  bool await_ready() const noexcept { return ms_ == 0 || cancel_.cancelled(); }
 
   bool await_suspend(std::coroutine_handle<> h) {
-    // Allocate state on heap - it will self-destruct after close
+    // Allocate state from the pool - it will self-destruct after close
     auto* state = new SleepState{};
     state->handle = h;
 
-    // Capture loop pointer and ms by value (SleepAwaitable might be destroyed)
+    // Capture loop pointer, ms and token by value (SleepAwaitable might be
+    // destroyed)
     auto* loop_ptr = &loop_;
     auto ms = ms_;
 
     // Initialize and start timer on the loop thread
-    bool posted = loop_.Post([loop_ptr, state, ms]() {
+    bool posted = loop_.Post([loop_ptr, state, ms, cancel = cancel_]() {
+      if (cancel.cancelled()) {
+        auto h = state->handle;
+        delete state;  // Timer never initialized
+        h.resume();
+        return;
+      }
+      state->cancel_reg = cancel.on_cancel([state]() { SleepState::OnTimer(&state->timer); });
       uv_timer_init(loop_ptr->RawLoop(), &state->timer);
       // Tag timer so CloseWalkCallback knows it's a SleepState
       // (data == handle address since timer is first member of SleepState)
@@ -75,11 +95,12 @@ public:
 private:
   EventLoop& loop_;
   uint64_t ms_;
+  CancellationToken cancel_;
 };
 
 // Factory function for cleaner syntax
-inline SleepAwaitable SleepMs(EventLoop& loop, uint64_t ms) {
-  return SleepAwaitable(loop, ms);
+inline SleepAwaitable SleepMs(EventLoop& loop, uint64_t ms, CancellationToken cancel = {}) {
+  return SleepAwaitable(loop, ms, std::move(cancel));
 }
 
 }  // namespace ranking
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rankd {
+
+// Work-stealing executor for CPU-bound DAG work (see GetCPUThreadPool()).
+//
+// Each worker owns a Chase-Lev deque. Jobs submitted from a worker thread
+// are pushed onto its own deque and popped LIFO, so a job's children run hot
+// in cache. Jobs submitted from other threads (event loop, scheduler) go to
+// per-worker inboxes, round-robin, so submitters never share one lock.
+// An idle worker drains its deque, then its inbox, then steals from the
+// other workers starting at a random victim.
+//
+// post() is fire-and-forget: one allocation per job, no future. An exception
+// escaping a posted job is logged and dropped. submit() wraps post() for
+// callers that need the result or the exception.
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(size_t num_threads = 8);
+  // Runs every queued job, then joins the workers
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  // Run f() on a worker. Throws if the pool is shutting down.
+  template <typename F> void post(F &&f) {
+    enqueue(new JobImpl<std::decay_t<F>>(std::forward<F>(f)));
+  }
+
+  // Run f() on a worker and get a future for its result
+  template <typename F>
+  auto submit(F &&f) -> std::future<std::invoke_result_t<F>> {
+    using ReturnType = std::invoke_result_t<F>;
+    std::packaged_task<ReturnType()> task(std::forward<F>(f));
+    std::future<ReturnType> result = task.get_future();
+    post(std::move(task));
+    return result;
+  }
+
+  // Wait for all in-flight jobs to complete (drain).
+  // Call this before destroying resources that jobs may reference.
+  void wait_idle();
+
+  // Get number of worker threads
+  size_t size() const { return workers_.size(); }
+
+  // Get number of in-flight jobs (queued or running)
+  size_t in_flight() const { return in_flight_.load(); }
+
+  // Jobs taken from another worker's deque or inbox (for benchmarks)
+  uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+  struct Job {
+    virtual ~Job() = default;
+    virtual void run() = 0;
+  };
+
+  template <typename F> struct JobImpl final : Job {
+    explicit JobImpl(F &&f) : fn(std::move(f)) {}
+    explicit JobImpl(const F &f) : fn(f) {}
+    void run() override { fn(); }
+    F fn;
+  };
+
+  // Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+  // Work-Stealing for Weak Memory Models"). push/pop: owner only;
+  // steal: any thread.
+  class Deque {
+  public:
+    Deque();
+    ~Deque();
+
+    void push(Job *job);
+    Job *pop();
+    Job *steal();
+
+  private:
+    struct Array {
+      explicit Array(int64_t cap)
+          : capacity(cap), slots(new std::atomic<Job *>[cap]) {}
+      Job *get(int64_t i) const {
+        return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+      }
+      void put(int64_t i, Job *job) {
+        slots[i & (capacity - 1)].store(job, std::memory_order_relaxed);
+      }
+      int64_t capacity;  // power of two
+      std::unique_ptr<std::atomic<Job *>[]> slots;
+    };
+
+    Array *grow(Array *old, int64_t bottom, int64_t top);
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Array *> array_;
+    // Replaced arrays stay alive until destruction: a thief may still be
+    // reading one (owner only)
+    std::vector<std::unique_ptr<Array>> arrays_;
+  };
+
+  struct alignas(64) Worker {
+    Deque deque;
+    std::mutex inbox_mutex;
+    std::deque<Job *> inbox;  // guarded by inbox_mutex
+    uint64_t rng = 0;         // xorshift state for victim selection
+    std::thread thread;
+  };
+
+  void enqueue(Job *job);
+  void worker_loop(size_t index);
+  Job *find_job(size_t index);
+  Job *pop_inbox(Worker &worker);
+  void run_job(Job *job);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_inbox_{0};
+
+  // Jobs queued but not yet taken. Sleeping workers wake when it is > 0.
+  std::atomic<size_t> queued_{0};
+  std::atomic<size_t> sleepers_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<bool> stop_{false};
+
+  std::atomic<size_t> in_flight_{0};
+  std::mutex idle_mutex_;
+  std::condition_variable idle_cv_;
+
+  std::atomic<uint64_t> steals_{0};
+};
+
+} // namespace rankd
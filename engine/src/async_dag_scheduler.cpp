@@ -1,6 +1,8 @@
 #include "async_dag_scheduler.h"
 
 #include "cpu_offload.h"
+#include "critical_path.h"
+#include "node_results.h"
 #include "output_contract.h"
 #include "pred_eval.h"  // For clearRegexCache
 #include "schema_delta.h"
@@ -117,16 +119,29 @@ struct AsyncSchedulerState {
   // Deadline/timeout config
   OptionalDeadline request_deadline;
   std::optional<std::chrono::milliseconds> node_timeout;
+  bool full_validation = true;                           // OutputValidation level for this request
+  size_t max_nodes_inflight = 0;                         // Cap on running sync (CPU) nodes
 
   // Mutable state (single-threaded, no locks needed)
   std::vector<int> deps_remaining;                       // countdown to 0
-  std::vector<std::optional<rankd::RowSet>> results;     // output per node
+  rankd::NodeResults results;                            // output per node, freed after last consumer
   std::vector<std::optional<rankd::NodeSchemaDelta>> schema_deltas;  // per node
+  // Per-node IO counters; shared so late completions after a timeout can
+  // still write to them
+  std::vector<std::shared_ptr<rankd::NodeIoStats>> io_stats;
   size_t num_nodes = 0;
   size_t nodes_remaining = 0;                            // countdown to 0 for completion
   size_t inflight_count = 0;                             // running coroutines (for safe shutdown)
-  std::queue<size_t> ready_queue;                        // nodes ready to run
+  size_t cpu_running = 0;                                // sync nodes holding a CPU slot
+  uint32_t nodes_inlined = 0;                            // sync tasks run on the loop thread
+  uint32_t nodes_offloaded = 0;                          // sync tasks run on the CPU pool
+  std::vector<uint8_t> holds_cpu_slot;                   // node_idx -> sync task (capped)
+  rankd::ReadyQueue ready_queue;                         // ready async/IO nodes, critical path first
+  rankd::ReadyQueue cpu_ready_queue;                     // ready sync nodes waiting for a CPU slot
   std::optional<std::string> first_error;                // fail-fast
+  CancellationSource cancel;                             // Cancelled by fail()
+  ExecCtxAsync node_ctx;                                 // base_ctx + cancel token
+  CancellationToken::Registration caller_cancel;         // base_ctx.cancel -> fail()
 
   // Coroutine ownership - keeps Task alive until complete
   std::vector<std::optional<Task<void>>> node_tasks;
@@ -135,14 +150,48 @@ struct AsyncSchedulerState {
   std::coroutine_handle<> main_coro;
 
   AsyncSchedulerState(const rankd::Plan& p, const ExecCtxAsync& c, const rankd::TaskRegistry& r,
-                      OptionalDeadline deadline, std::optional<std::chrono::milliseconds> timeout)
-      : plan(p), base_ctx(c), registry(r), request_deadline(deadline), node_timeout(timeout) {}
+                      OptionalDeadline deadline, std::optional<std::chrono::milliseconds> timeout,
+                      size_t max_inflight)
+      : plan(p),
+        base_ctx(c),
+        registry(r),
+        request_deadline(deadline),
+        node_timeout(timeout),
+        max_nodes_inflight(max_inflight) {
+    node_ctx = base_ctx;
+    node_ctx.cancel = cancel.token();
+    if (base_ctx.cancel.cancelled()) {
+      fail("Request cancelled");
+    }
+    caller_cancel = base_ctx.cancel.on_cancel([this]() { fail("Request cancelled"); });
+  }
+
+  // Record the first error and cancel in-flight work. Cancelling resumes
+  // suspended node coroutines synchronously; they unwind through fail()
+  // again, which is a no-op after the first call.
+  void fail(const std::string& error) {
+    if (!first_error) {
+      first_error = error;
+    }
+    cancel.cancel();
+  }
 };
 
+// Sync tasks queue for a CPU slot; async/IO tasks hold none and start as soon
+// as they are ready
+void push_ready_node(AsyncSchedulerState& state, size_t node_idx) {
+  if (state.holds_cpu_slot[node_idx]) {
+    state.cpu_ready_queue.push(node_idx);
+  } else {
+    state.ready_queue.push(node_idx);
+  }
+}
+
 void init_async_scheduler_state(AsyncSchedulerState& state) {
   size_t n = state.plan.nodes.size();
   state.num_nodes = n;
   state.nodes_remaining = n;
+  state.full_validation = rankd::OutputValidation::instance().beginRequest();
 
   // Build node_id -> index map
   for (size_t i = 0; i < n; ++i) {
@@ -152,9 +201,14 @@ void init_async_scheduler_state(AsyncSchedulerState& state) {
   // Initialize containers
   state.deps_remaining.resize(n, 0);
   state.successors.resize(n);
-  state.results.resize(n);
+  state.results.reset(n);
   state.schema_deltas.resize(n);
+  state.io_stats.resize(n);
+  for (auto& stats : state.io_stats) {
+    stats = std::make_shared<rankd::NodeIoStats>();
+  }
   state.node_tasks.resize(n);
+  state.holds_cpu_slot.resize(n, 0);
 
   // Compute indegrees and build successor edges
   for (size_t i = 0; i < n; ++i) {
@@ -174,13 +228,18 @@ void init_async_scheduler_state(AsyncSchedulerState& state) {
     }
 
     state.deps_remaining[i] = static_cast<int>(deps.size());
+    state.holds_cpu_slot[i] = spec.run_async ? 0 : 1;
 
     // Build successor edges
     for (const auto& dep_id : deps) {
       size_t parent_idx = state.node_index.at(dep_id);
       state.successors[parent_idx].push_back(i);
+      state.results.addEdge(parent_idx, i);
     }
   }
+  for (const auto& out_id : state.plan.outputs) {
+    state.results.addOutput(state.node_index.at(out_id));
+  }
 
   // Compute topo order (for deterministic schema_deltas output)
   std::vector<int> in_degree = state.deps_remaining;
@@ -204,10 +263,17 @@ void init_async_scheduler_state(AsyncSchedulerState& state) {
     }
   }
 
-  // Push nodes with indegree 0 to ready_queue
+  // Rank ready nodes by longest remaining path: spawn order is the order in
+  // which CPU work reaches the pool and IO reaches Redis
+  auto priorities = rankd::plan_critical_path(
+      state.plan, state.registry, state.successors, state.topo_order);
+  state.cpu_ready_queue.setPriorities(priorities);
+  state.ready_queue.setPriorities(std::move(priorities));
+
+  // Push nodes with indegree 0 to the ready queues
   for (size_t i = 0; i < n; ++i) {
     if (state.deps_remaining[i] == 0) {
-      state.ready_queue.push(i);
+      push_ready_node(state, i);
     }
   }
 }
@@ -246,14 +312,20 @@ struct CompletionAwaitable {
  */
 void on_node_success(AsyncSchedulerState& state, size_t node_idx, rankd::RowSet result,
                      rankd::NodeSchemaDelta delta) {
-  // Store result
-  state.results[node_idx] = std::move(result);
+  // A sync node's CPU slot goes to the next ready sync node (its coroutine
+  // still counts in inflight_count until it returns)
+  if (state.holds_cpu_slot[node_idx]) {
+    --state.cpu_running;
+  }
+
+  // Store result; parents with no consumers left are released
+  state.results.complete(node_idx, std::move(result));
   state.schema_deltas[node_idx] = std::move(delta);
 
   // Wake successors
   for (size_t succ_idx : state.successors[node_idx]) {
     if (--state.deps_remaining[succ_idx] == 0) {
-      state.ready_queue.push(succ_idx);
+      push_ready_node(state, succ_idx);
     }
   }
 
@@ -269,13 +341,13 @@ void on_node_success(AsyncSchedulerState& state, size_t node_idx, rankd::RowSet
  * Records the error (fail-fast: no new nodes spawned).
  * main_coro resumed by run_node_async when inflight_count hits 0.
  */
-void on_node_failure(AsyncSchedulerState& state, const std::string& error) {
-  if (!state.first_error) {
-    state.first_error = error;
-  }
-
+void on_node_failure(AsyncSchedulerState& state, size_t node_idx, const std::string& error) {
   // Decrement remaining but don't spawn new nodes
+  if (state.holds_cpu_slot[node_idx]) {
+    --state.cpu_running;
+  }
   --state.nodes_remaining;
+  state.fail(error);
 }
 
 /**
@@ -304,7 +376,7 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
     std::vector<rankd::RowSet> inputs;
     for (const auto& parent_id : node.inputs) {
       size_t parent_idx = state.node_index.at(parent_id);
-      inputs.push_back(*state.results[parent_idx]);
+      inputs.push_back(state.results.get(parent_idx));
     }
 
     // 2. Validate params
@@ -317,17 +389,36 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
         std::make_shared<std::unordered_map<std::string, rankd::RowSet>>();
     for (const auto& [param_name, ref_node_id] : validated.node_ref_params) {
       size_t ref_idx = state.node_index.at(ref_node_id);
-      resolved_refs->emplace(param_name, *state.results[ref_idx]);
+      resolved_refs->emplace(param_name, state.results.get(ref_idx));
     }
 
     // 4. Build execution context for this node
-    ExecCtxAsync ctx = state.base_ctx;
+    ExecCtxAsync ctx = state.node_ctx;
     ctx.resolved_node_refs = resolved_refs->empty() ? nullptr : resolved_refs.get();
+    ctx.live_keys = node.live_keys;
+    auto io_stats = state.io_stats[node_idx];
+    ctx.io_stats = io_stats.get();
 
     // 5. Execute the task
     const auto& spec = state.registry.get_spec(node.op);
 
-    // Execute async or sync (both wrapped with deadline support)
+    // Sync tasks with little estimated work run inline: an offload costs a
+    // pool submit, a timer and a Post back, which can exceed the work itself
+    bool run_inline = false;
+    if (!spec.run_async) {
+      size_t input_rows = 0;
+      for (const auto& input : inputs) {
+        input_rows += input.rowCount();
+      }
+      for (const auto& [param_name, ref] : *resolved_refs) {
+        input_rows += ref.rowCount();
+      }
+      run_inline = rankd::NodeCostModel::instance().runsInline(spec, input_rows);
+      ++(run_inline ? state.nodes_inlined : state.nodes_offloaded);
+    }
+
+    // Execute async, inline, or offloaded (async and offloaded wrapped with
+    // deadline support)
     auto run_task = [&]() -> Task<rankd::RowSet> {
       if (spec.run_async) {
         // Task has native async implementation - wrap with AsyncWithTimeout
@@ -361,9 +452,13 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
                           std::shared_ptr<rankd::RequestContext> req,
                           std::shared_ptr<rankd::EndpointRegistry> ep,
                           std::shared_ptr<std::unordered_map<std::string, rankd::RowSet>> refs,
+                          std::shared_ptr<std::pmr::memory_resource> arena,
+                          std::shared_ptr<const std::vector<uint32_t>> live_keys,
+                          std::shared_ptr<rankd::NodeIoStats> io,
                           AsyncTaskFn run_async_fn,
                           EventLoop* loop,
-                          AsyncIoClients* clients) -> Task<rankd::RowSet> {
+                          AsyncIoClients* clients,
+                          CancellationToken cancel) -> Task<rankd::RowSet> {
           // Build async ctx from shared copies
           ranking::ExecCtxAsync async_ctx;
           async_ctx.params = params.get();
@@ -376,8 +471,12 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
           async_ctx.resolved_node_refs = refs->empty() ? nullptr : refs.get();
           async_ctx.request = req.get();
           async_ctx.endpoints = ep ? ep.get() : nullptr;
+          async_ctx.arena = std::move(arena);
+          async_ctx.live_keys = std::move(live_keys);
+          async_ctx.io_stats = io.get();
           async_ctx.loop = loop;
           async_ctx.async_clients = clients;
+          async_ctx.cancel = std::move(cancel);
 
           co_return co_await run_async_fn(*in, *vp, async_ctx);
         };
@@ -386,7 +485,28 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
             *ctx.loop, effective_deadline,
             wrapper(async_inputs, async_validated, params_copy, expr_table_copy,
                     pred_table_copy, request_copy, endpoints_copy, resolved_refs,
-                    spec.run_async, ctx.loop, ctx.async_clients));
+                    ctx.arena, ctx.live_keys, io_stats, spec.run_async, ctx.loop,
+                    ctx.async_clients, ctx.cancel));
+      } else if (run_inline) {
+        // Runs to completion on the loop thread before anything else can
+        // resume, so ctx and the scheduler state can be used directly
+        rankd::clearRegexCache();
+
+        rankd::ExecCtx sync_ctx;
+        sync_ctx.params = ctx.params;
+        sync_ctx.expr_table = ctx.expr_table;
+        sync_ctx.pred_table = ctx.pred_table;
+        sync_ctx.stats = nullptr;  // Same as the offload path
+        sync_ctx.resolved_node_refs = ctx.resolved_node_refs;
+        sync_ctx.request = ctx.request;
+        sync_ctx.endpoints = ctx.endpoints;
+        sync_ctx.clients = nullptr;  // Sync clients not available in async path
+        sync_ctx.arena = ctx.arena;
+        sync_ctx.live_keys = ctx.live_keys;
+        sync_ctx.io_stats = io_stats.get();
+        sync_ctx.parallel = false;
+
+        co_return state.registry.execute(node.op, inputs, validated, sync_ctx);
       } else {
         // Wrap sync run() with OffloadCpuWithTimeout for deadline support
         // IMPORTANT: All data must be copied/shared because if timeout fires,
@@ -409,14 +529,18 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
             ctx.endpoints ? std::make_shared<rankd::EndpointRegistry>(*ctx.endpoints)
                           : nullptr;
         // stats is optional and only for timing - skip on timeout (result discarded anyway)
-        // resolved_refs is already a shared_ptr
+        // resolved_refs is already a shared_ptr; arena is shared so a late
+        // completion can still allocate from it
+        auto arena = ctx.arena;
+        auto live_keys = ctx.live_keys;
 
         co_return co_await OffloadCpuWithTimeout(
             *ctx.loop, effective_deadline,
             [&registry, op = std::move(op), captured_inputs = std::move(captured_inputs),
              captured_validated = std::move(captured_validated),
              params_copy, expr_table_copy, pred_table_copy,
-             resolved_refs, request_copy, endpoints_copy]() mutable {
+             resolved_refs, request_copy, endpoints_copy, arena, live_keys,
+             io_stats]() mutable {
               // Clear thread-local regex cache on CPU thread
               rankd::clearRegexCache();
 
@@ -431,6 +555,9 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
               sync_ctx.request = request_copy.get();
               sync_ctx.endpoints = endpoints_copy ? endpoints_copy.get() : nullptr;
               sync_ctx.clients = nullptr;  // Sync clients not available in async path
+              sync_ctx.arena = arena;
+              sync_ctx.live_keys = live_keys;
+              sync_ctx.io_stats = io_stats.get();
               sync_ctx.parallel = false;
 
               return registry.execute(op, captured_inputs, captured_validated,
@@ -440,6 +567,10 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
     };
 
     rankd::RowSet output = co_await run_task();
+    rankd::NodeCostModel::instance().record(
+        state.plan, node,
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time)
+            .count());
 
     // 6. Validate output contract
     std::vector<rankd::RowSet> contract_inputs = inputs;
@@ -447,7 +578,7 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
       contract_inputs.push_back(resolved_refs->at("rhs"));
     }
     rankd::validateTaskOutput(node.node_id, node.op, spec.output_pattern, contract_inputs,
-                               validated, output);
+                               validated, output, state.full_validation);
 
     // 7. Compute schema delta
     rankd::NodeSchemaDelta node_delta;
@@ -463,7 +594,7 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
     on_node_success(state, node_idx, std::move(output), std::move(node_delta));
 
   } catch (const std::exception& e) {
-    on_node_failure(state, e.what());
+    on_node_failure(state, node_idx, e.what());
   }
 
   // Decrement inflight count and resume main_coro when last task completes.
@@ -481,27 +612,34 @@ Task<void> run_node_async(AsyncSchedulerState& state, size_t node_idx) {
 }
 
 /**
- * Spawn coroutines for all nodes in the ready queue.
+ * Spawn coroutines for ready nodes, critical path first. Sync (CPU) nodes
+ * are capped at max_nodes_inflight running at a time; the rest wait in
+ * cpu_ready_queue for a running sync node to complete. Async/IO nodes hold
+ * no CPU slot and all start at once.
  */
 void spawn_ready_nodes(AsyncSchedulerState& state) {
   // Check request deadline before spawning new nodes
   if (deadline_exceeded(state.request_deadline)) {
-    if (!state.first_error) {
-      state.first_error = "Request deadline exceeded";
-    }
+    state.fail("Request deadline exceeded");
     return;  // Don't spawn new nodes
   }
 
-  while (!state.ready_queue.empty() && !state.first_error) {
-    size_t node_idx = state.ready_queue.front();
-    state.ready_queue.pop();
-
+  auto start_node = [&state](size_t node_idx) {
     // Track inflight before starting (decremented in run_node_async on completion)
     ++state.inflight_count;
 
     // Create and start the node coroutine
     state.node_tasks[node_idx] = run_node_async(state, node_idx);
     state.node_tasks[node_idx]->start();
+  };
+
+  while (!state.cpu_ready_queue.empty() && !state.first_error &&
+         state.cpu_running < state.max_nodes_inflight) {
+    ++state.cpu_running;
+    start_node(state.cpu_ready_queue.pop());
+  }
+  while (!state.ready_queue.empty() && !state.first_error) {
+    start_node(state.ready_queue.pop());
   }
 }
 
@@ -511,10 +649,17 @@ Task<rankd::ExecutionResult> execute_plan_async(
     const rankd::Plan& plan,
     const ExecCtxAsync& ctx,
     OptionalDeadline request_deadline,
-    std::optional<std::chrono::milliseconds> node_timeout) {
+    std::optional<std::chrono::milliseconds> node_timeout,
+    int max_nodes_inflight) {
   const auto& registry = rankd::TaskRegistry::instance();
 
-  AsyncSchedulerState state(plan, ctx, registry, request_deadline, node_timeout);
+  // Default max_nodes_inflight to pool size, as execute_plan_parallel does
+  if (max_nodes_inflight <= 0) {
+    max_nodes_inflight = static_cast<int>(rankd::GetCPUThreadPool().size());
+  }
+
+  AsyncSchedulerState state(plan, ctx, registry, request_deadline, node_timeout,
+                            static_cast<size_t>(max_nodes_inflight));
   init_async_scheduler_state(state);
 
   // Spawn initial ready nodes
@@ -534,8 +679,9 @@ Task<rankd::ExecutionResult> execute_plan_async(
   // Collect outputs
   for (const auto& out_id : plan.outputs) {
     size_t idx = state.node_index.at(out_id);
-    result.outputs.push_back(*state.results[idx]);
+    result.outputs.push_back(state.results.get(idx));
   }
+  result.peak_result_working_set_bytes = state.results.peakWorkingSetBytes();
 
   // Collect schema_deltas in topo order
   for (size_t idx : state.topo_order) {
@@ -544,6 +690,18 @@ Task<rankd::ExecutionResult> execute_plan_async(
     }
   }
 
+  // Collect IO trace in topo order
+  for (size_t idx : state.topo_order) {
+    const auto& node = plan.nodes[idx];
+    if (registry.get_spec(node.op).is_io) {
+      result.io_trace.push_back(
+          {node.node_id, state.io_stats[idx]->bytes_received.load()});
+    }
+  }
+
+  result.nodes_inlined = state.nodes_inlined;
+  result.nodes_offloaded = state.nodes_offloaded;
+
   co_return result;
 }
 
@@ -558,7 +716,9 @@ rankd::ExecutionResult execute_plan_async_blocking(
     const rankd::RequestContext& request,
     rankd::ExecStats* stats,
     OptionalDeadline request_deadline,
-    std::optional<std::chrono::milliseconds> node_timeout) {
+    std::optional<std::chrono::milliseconds> node_timeout,
+    std::shared_ptr<std::pmr::memory_resource> arena,
+    int max_nodes_inflight) {
 
   // Guard: calling from loop thread would deadlock (we'd block waiting for
   // callbacks that can't run because we're blocking the loop thread)
@@ -575,6 +735,7 @@ rankd::ExecutionResult execute_plan_async_blocking(
   ctx.stats = stats;
   ctx.request = &request;
   ctx.endpoints = &endpoints;
+  ctx.arena = std::move(arena);
   ctx.loop = &loop;
   ctx.async_clients = &async_clients;
 
@@ -590,7 +751,8 @@ rankd::ExecutionResult execute_plan_async_blocking(
   // final_suspend, which would cause UB when destroying the Task.
   auto wrapper = [&]() -> BlockingTask {
     try {
-      result = co_await execute_plan_async(plan, ctx, request_deadline, node_timeout);
+      result = co_await execute_plan_async(plan, ctx, request_deadline, node_timeout,
+                                           max_nodes_inflight);
     } catch (...) {
       error = std::current_exception();
     }
@@ -1,13 +1,15 @@
 #include "async_io_clients.h"
 
+#include <algorithm>
+
 namespace ranking {
 
-std::expected<AsyncRedisClient*, std::string> AsyncIoClients::GetRedis(
+std::expected<AsyncIoClients::RedisPool*, std::string> AsyncIoClients::GetPool(
     EventLoop& loop, const rankd::EndpointRegistry& endpoints, std::string_view endpoint_id) {
   // Check cache first
-  auto it = redis_clients_.find(std::string(endpoint_id));
-  if (it != redis_clients_.end()) {
-    return it->second.get();
+  auto it = redis_pools_.find(std::string(endpoint_id));
+  if (it != redis_pools_.end()) {
+    return &it->second;
   }
 
   // Look up endpoint
@@ -21,26 +23,164 @@ std::expected<AsyncRedisClient*, std::string> AsyncIoClients::GetRedis(
     return std::unexpected("Endpoint is not a Redis endpoint: " + std::string(endpoint_id));
   }
 
-  // Create new client
-  auto client_result = AsyncRedisClient::Create(loop, *spec);
-  if (!client_result) {
-    return std::unexpected(client_result.error());
+  // Split the endpoint's inflight limits across its connections
+  RedisPool pool;
+  pool.spec = *spec;
+  size_t size = static_cast<size_t>(std::max(spec->policy.pool_size.value_or(1), 1));
+  int max_inflight = spec->policy.max_inflight.value_or(64);
+  pool.spec.policy.max_inflight =
+      std::max(1, (max_inflight + static_cast<int>(size) - 1) / static_cast<int>(size));
+  if (spec->policy.min_inflight) {
+    pool.spec.policy.min_inflight = std::max(
+        1, (*spec->policy.min_inflight + static_cast<int>(size) - 1) / static_cast<int>(size));
+  }
+
+  // Open every connection now; they connect asynchronously
+  for (size_t i = 0; i < size; ++i) {
+    auto client_result = AsyncRedisClient::Create(loop, pool.spec);
+    if (!client_result) {
+      return std::unexpected(client_result.error());
+    }
+    pool.conns.push_back(std::move(*client_result));
   }
+  pool.next_reconnect.assign(size, std::chrono::steady_clock::time_point{});
 
   // Cache and return
-  auto* client = client_result->get();
-  redis_clients_[std::string(endpoint_id)] = std::move(*client_result);
-  return client;
+  auto [pos, inserted] = redis_pools_.emplace(std::string(endpoint_id), std::move(pool));
+  return &pos->second;
+}
+
+void AsyncIoClients::Reconnect(EventLoop& loop, RedisPool& pool) {
+  auto now = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < pool.conns.size(); ++i) {
+    if (!pool.conns[i]->is_closed() || now < pool.next_reconnect[i]) {
+      continue;
+    }
+    pool.next_reconnect[i] = now + kReconnectBackoff;
+    auto client_result = AsyncRedisClient::Create(loop, pool.spec);
+    if (!client_result) {
+      continue;  // Retry after the backoff
+    }
+    // Tasks still holding the old client keep it alive until they finish
+    retired_commands_ += pool.conns[i]->command_count();
+    pool.conns[i] = std::move(*client_result);
+    ++reconnects_;
+  }
+}
+
+const std::shared_ptr<AsyncRedisClient>& AsyncIoClients::Pick(RedisPool& pool) {
+  size_t n = pool.conns.size();
+  AsyncRedisClient* best = nullptr;
+  size_t best_index = 0;
+  for (size_t k = 0; k < n; ++k) {
+    size_t i = (pool.next + k) % n;
+    AsyncRedisClient* client = pool.conns[i].get();
+    // Closed connections only if nothing else is open (they fail fast)
+    if (best && (client->is_closed() > best->is_closed() ||
+                 (client->is_closed() == best->is_closed() &&
+                  client->outstanding() >= best->outstanding()))) {
+      continue;
+    }
+    best = client;
+    best_index = i;
+  }
+  pool.next = (best_index + 1) % n;
+  return pool.conns[best_index];
+}
+
+std::expected<std::shared_ptr<AsyncRedisClient>, std::string> AsyncIoClients::GetRedis(
+    EventLoop& loop, const rankd::EndpointRegistry& endpoints, std::string_view endpoint_id) {
+  auto pool = GetPool(loop, endpoints, endpoint_id);
+  if (!pool) {
+    return std::unexpected(pool.error());
+  }
+  Reconnect(loop, **pool);
+  return Pick(**pool);
+}
+
+void AsyncIoClients::WarmUp(EventLoop& loop, const rankd::EndpointRegistry& endpoints) {
+  for (const auto& spec : endpoints.all()) {
+    if (spec.kind == rankd::EndpointKind::Redis) {
+      (void)GetPool(loop, endpoints, spec.endpoint_id);
+    }
+  }
 }
 
 AsyncRedisClient* AsyncIoClients::GetExistingRedis(std::string_view endpoint_id) {
-  auto it = redis_clients_.find(std::string(endpoint_id));
-  if (it != redis_clients_.end()) {
-    return it->second.get();
+  auto it = redis_pools_.find(std::string(endpoint_id));
+  if (it != redis_pools_.end()) {
+    return Pick(it->second).get();
   }
   return nullptr;
 }
 
-void AsyncIoClients::Clear() { redis_clients_.clear(); }
+size_t AsyncIoClients::redis_connection_count() const {
+  size_t count = 0;
+  for (const auto& [id, pool] : redis_pools_) {
+    for (const auto& client : pool.conns) {
+      count += client->is_closed() ? 0 : 1;
+    }
+  }
+  return count;
+}
+
+uint64_t AsyncIoClients::redis_commands() const {
+  uint64_t count = retired_commands_;
+  for (const auto& [id, pool] : redis_pools_) {
+    for (const auto& client : pool.conns) {
+      count += client->command_count();
+    }
+  }
+  return count;
+}
+
+size_t AsyncIoClients::redis_inflight_limit(std::string_view endpoint_id) const {
+  auto it = redis_pools_.find(std::string(endpoint_id));
+  if (it == redis_pools_.end()) {
+    return 0;
+  }
+  size_t limit = 0;
+  for (const auto& client : it->second.conns) {
+    limit += client->inflight_limiter().max_permits();
+  }
+  return limit;
+}
+
+std::chrono::microseconds AsyncIoClients::redis_queue_delay(std::string_view endpoint_id) const {
+  std::chrono::microseconds delay{0};
+  auto it = redis_pools_.find(std::string(endpoint_id));
+  if (it != redis_pools_.end()) {
+    for (const auto& client : it->second.conns) {
+      delay = std::max(delay, client->inflight_limiter().queue_delay());
+    }
+  }
+  return delay;
+}
+
+uint64_t AsyncIoClients::redis_hedges_issued(std::string_view endpoint_id) const {
+  uint64_t issued = 0;
+  auto it = redis_pools_.find(std::string(endpoint_id));
+  if (it != redis_pools_.end()) {
+    for (const auto& client : it->second.conns) {
+      issued += client->hedges_issued();
+    }
+  }
+  return issued;
+}
+
+uint64_t AsyncIoClients::redis_hedges_won(std::string_view endpoint_id) const {
+  uint64_t won = 0;
+  auto it = redis_pools_.find(std::string(endpoint_id));
+  if (it != redis_pools_.end()) {
+    for (const auto& client : it->second.conns) {
+      won += client->hedges_won();
+    }
+  }
+  return won;
+}
+
+void AsyncIoClients::Clear() {
+  redis_pools_.clear();
+}
 
 }  // namespace ranking
@@ -5,24 +5,121 @@
 // libuv adapter must be included AFTER async.h
 #include <adapters/libuv.h>
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <chrono>
 #include <cstdarg>
+#include <cstddef>
 #include <cstring>
+#include <unordered_map>
+
+#include "frame_pool.h"
 
 namespace ranking {
 
 namespace {
+struct CommandState;
+}  // namespace
+
+// Leaders of in-flight reads, keyed by RESP command bytes. Loop thread only.
+struct RedisSingleFlight {
+  std::unordered_map<std::string, std::shared_ptr<CommandState>> leaders;
+  uint64_t coalesced = 0;
+};
+
+// Hedged reads: replica connections, a sliding window of primary RTTs to
+// derive the hedge delay from, and the hedge budget. Loop thread only.
+struct RedisHedger {
+  static constexpr size_t kRttWindow = 256;      // Recent RTTs kept
+  static constexpr uint64_t kRecomputeEvery = 32;  // Samples between delay updates
+  static constexpr uint64_t kHedgeCost = 100;    // Credits per hedge (1 read = pct)
+  static constexpr uint64_t kMaxCredits = 10 * kHedgeCost;  // Burst of 10 hedges
+
+  RedisHedger(uv_loop_t* loop, int percentile, int budget_pct)
+      : loop(loop),
+        percentile(std::clamp(percentile, 1, 99)),
+        budget_pct(static_cast<uint64_t>(std::clamp(budget_pct, 0, 100))) {
+    rtts_us.reserve(kRttWindow);
+  }
+
+  // Called as a read is issued: earn budget and, once enough RTTs are known,
+  // start its hedge timer
+  void arm(const std::shared_ptr<CommandState>& state, const std::string& command);
+  // Hedge timer fired with the read still pending
+  void fire(CommandState& state);
+  // The read completed; `rtt` is how long the primary had by then
+  void on_complete(std::chrono::steady_clock::duration rtt, bool hedge_won);
+
+  uv_loop_t* loop;
+  int percentile;
+  uint64_t budget_pct;
+  std::vector<std::unique_ptr<AsyncRedisClient>> replicas;
+  size_t next_replica = 0;
+  std::vector<uint32_t> rtts_us;  // Ring buffer of primary RTTs
+  size_t next_rtt = 0;
+  uint64_t samples = 0;
+  uint64_t delay_us = 0;  // 0 = not enough samples yet
+  uint64_t credits = 0;
+  uint64_t issued = 0;
+  uint64_t won = 0;
+};
+
+namespace {
+
+// How OnReply decodes array replies
+enum class ReplyDecode : uint8_t {
+  Strings,  // Copy each element into array_vals
+  Int64s,   // Parse each element as a decimal id into array_ids
+};
 
 // Parsed Redis reply data - extracted in callback before hiredis frees the original
 struct ParsedReply {
   int type = 0;
   std::string str_value;               // For string/error replies
-  std::vector<std::string> array_vals;  // For array replies
+  std::vector<std::string> array_vals;  // For array replies (ReplyDecode::Strings)
+  std::vector<uint8_t> array_nil;       // For array replies: 1 = nil element
+  std::shared_ptr<rankd::IdColumn> array_ids;  // For array replies (ReplyDecode::Int64s)
+  uint64_t array_bytes = 0;            // Element payload bytes (ReplyDecode::Int64s)
   int64_t integer = 0;                 // For integer replies
 };
 
-// Deep-copy a redisReply into ParsedReply before hiredis frees it
-ParsedReply parse_reply(redisReply* r) {
+// Parse array elements as int64 ids straight from hiredis' buffers into an id
+// column sized to the reply, allocated from `mr`. Elements that are not decimal
+// ids are skipped and the column trimmed to the ids written.
+void parse_int_elements(redisReply* r, ParsedReply& p, std::pmr::memory_resource* mr) {
+  auto ids = std::make_shared<rankd::IdColumn>(r->elements, rankd::ColumnInit::Uninitialized, mr);
+  size_t n = 0;
+  for (size_t i = 0; i < r->elements; ++i) {
+    const redisReply* e = r->element[i];
+    if (!e || e->type != REDIS_REPLY_STRING || !e->str) continue;
+    p.array_bytes += e->len;
+    auto [ptr, ec] = std::from_chars(e->str, e->str + e->len, ids->values[n]);
+    if (ec == std::errc{}) {
+      ++n;
+    }
+  }
+  ids->values.resize(n);
+  ids->valid.resize(n);
+  p.array_ids = std::move(ids);
+}
+
+// Copy of an id column in another request's memory
+std::shared_ptr<rankd::IdColumn> copy_ids(const rankd::IdColumn& ids,
+                                          std::pmr::memory_resource* mr) {
+  auto copy = std::make_shared<rankd::IdColumn>(ids.values.size(),
+                                                rankd::ColumnInit::Uninitialized, mr);
+  std::copy(ids.values.begin(), ids.values.end(), copy->values.begin());
+  return copy;
+}
+
+std::pmr::memory_resource* resource_of(const std::shared_ptr<std::pmr::memory_resource>& memory) {
+  return memory ? memory.get() : std::pmr::get_default_resource();
+}
+
+// Deep-copy a redisReply into ParsedReply before hiredis frees it. Decoded ids
+// are allocated from `ids_memory`.
+ParsedReply parse_reply(redisReply* r, ReplyDecode decode, std::pmr::memory_resource* ids_memory) {
   ParsedReply p;
   if (!r) return p;
 
@@ -42,12 +139,18 @@ ParsedReply parse_reply(redisReply* r) {
       break;
 
     case REDIS_REPLY_ARRAY:
+      if (decode == ReplyDecode::Int64s) {
+        parse_int_elements(r, p, ids_memory);
+        break;
+      }
       p.array_vals.reserve(r->elements);
+      p.array_nil.assign(r->elements, 0);
       for (size_t i = 0; i < r->elements; ++i) {
         if (r->element[i] && r->element[i]->type == REDIS_REPLY_STRING && r->element[i]->str) {
           p.array_vals.emplace_back(r->element[i]->str, r->element[i]->len);
         } else if (r->element[i] && r->element[i]->type == REDIS_REPLY_NIL) {
           p.array_vals.emplace_back();  // Empty string for nil
+          p.array_nil[i] = 1;
         } else {
           p.array_vals.emplace_back();  // Empty string for other types
         }
@@ -66,22 +169,136 @@ ParsedReply parse_reply(redisReply* r) {
 // even if CommandState was destroyed after timeout.
 struct CommandStateRef {
   std::weak_ptr<struct CommandState> state;
+  bool hedge = false;  // Callback of the duplicate sent to a replica
+
+  static void* operator new(std::size_t size) { return FramePool::instance().allocate(size); }
+  static void operator delete(void* p, std::size_t size) noexcept {
+    FramePool::instance().deallocate(p, size);
+  }
 };
 
 // State for a pending Redis command, used to communicate between callback and coroutine.
 // Shared between the awaitable and the hiredis callback using shared_ptr.
 struct CommandState : std::enable_shared_from_this<CommandState> {
   std::coroutine_handle<> handle;
+  // Decoded ids are allocated here (null = heap); declared before `reply` so
+  // it outlives them, even for a leader whose own caller already left
+  std::shared_ptr<std::pmr::memory_resource> memory;
   ParsedReply reply;
+  ReplyDecode decode = ReplyDecode::Strings;
   std::string error;
   AsyncInflightLimiter::Guard permit;  // Released when state is destroyed
-  uv_timer_t* timeout_timer = nullptr;  // Optional timeout timer
+  std::chrono::steady_clock::time_point issued_at{};  // For adaptive limiting
+  TimerWheel::Entry timeout_timer;      // Optional timeout, on the loop's timer wheel
+  uv_timer_t* hedge_timer = nullptr;    // Pending hedge (RedisHedger::arm)
+  RedisHedger* hedger = nullptr;        // Set once the read is armed for hedging
+  std::string hedge_command;
   bool completed = false;  // Guard against double-resume (reply vs timeout race)
   CommandStateRef* callback_ref = nullptr;  // Control block for hiredis callback
 
+  // Single-flight: set while this command leads an in-flight read
+  std::shared_ptr<RedisSingleFlight> flights;
+  std::string flight_key;
+  std::vector<std::weak_ptr<CommandState>> followers;  // Joined, not issued
+  std::shared_ptr<CommandState> leader;  // On a follower: the read it joined
+  // The leader's own awaiter already resumed (with `detached_error`); the
+  // command keeps running for its followers
+  bool detached = false;
+  std::string detached_error;
+
+  CancellationToken::Registration cancel_reg;  // Calls cancel()
+
   // Note: We do NOT delete callback_ref in destructor. Hiredis still holds this
   // pointer and will call OnReply later (even on disconnect/error). OnReply
   // handles cleanup after seeing the expired weak_ptr.
+  //
+  // A leader that timed out is dropped with its last follower, possibly
+  // before its hedge fired
+  ~CommandState() { close_timer(hedge_timer); }
+
+  // Complete the command: hand the outcome to joined followers, then resume
+  // the awaiting coroutine. Resuming may destroy the awaitable that owns this
+  // state, so callers must not touch it afterwards unless they hold a ref.
+  void finish() {
+    auto self = shared_from_this();  // Followers may hold the last refs
+    close_timer(hedge_timer);
+    // Give the permit back before resuming anyone: a resumed caller may
+    // destroy the client, and with it the limiter
+    permit = AsyncInflightLimiter::Guard();
+    auto joined = std::move(followers);
+    close_flight();
+    for (auto& weak : joined) {
+      auto follower = weak.lock();
+      if (!follower || follower->completed) continue;  // Cancelled while joined
+      follower->timeout_timer.cancel();
+      follower->reply = reply;
+      if (reply.array_ids) {
+        // Each caller owns (and may adopt) its ids, in its own memory
+        follower->reply.array_ids = copy_ids(*reply.array_ids, resource_of(follower->memory));
+      }
+      follower->error = error;
+      follower->completed = true;
+      follower->handle.resume();
+    }
+    if (!detached) {
+      handle.resume();
+    }
+  }
+
+  // Later identical reads must issue their own command
+  void close_flight() {
+    if (flights) {
+      flights->leaders.erase(flight_key);
+      flights.reset();
+    }
+  }
+
+  bool has_waiting_followers() const {
+    for (const auto& weak : followers) {
+      auto follower = weak.lock();
+      if (follower && !follower->completed) return true;
+    }
+    return false;
+  }
+
+  // Resume the leader's own awaiter with `reason` now, leaving the command
+  // (permit, timer, pending reply) to the followers still waiting on it
+  void detach(const char* reason) {
+    detached = true;
+    detached_error = reason;
+    handle.resume();
+  }
+
+  // Complete with a "Cancelled" error without waiting for the reply. If other
+  // callers have joined this read, only the cancelled caller leaves: it is
+  // resumed at once and the read keeps running for them.
+  void cancel() {
+    if (completed || detached) return;
+    auto self = shared_from_this();  // finish() may drop the last owner
+    if (has_waiting_followers()) {
+      detach("Cancelled");
+      return;
+    }
+    completed = true;
+    error = "Cancelled";
+    timeout_timer.cancel();
+    // Give the permit back now; OnReply drops the late reply
+    permit = AsyncInflightLimiter::Guard();
+    finish();
+  }
+
+  static void close_timer(uv_timer_t*& timer) {
+    if (!timer) return;
+    ClosePooledTimer(timer);
+    timer = nullptr;
+  }
+
+  // Report this command's round trip to an adaptive limiter
+  void sample(bool dropped) {
+    if (permit && issued_at != std::chrono::steady_clock::time_point{}) {
+      permit.limiter()->on_sample(std::chrono::steady_clock::now() - issued_at, dropped);
+    }
+  }
 
   static void OnReply(redisAsyncContext* c, void* reply_ptr, void* privdata) {
     auto* ref = static_cast<CommandStateRef*>(privdata);
@@ -96,67 +313,322 @@ struct CommandState : std::enable_shared_from_this<CommandState> {
     }
 
     // Clear callback_ref since we're handling cleanup here
-    state->callback_ref = nullptr;
+    if (!ref->hedge) {
+      state->callback_ref = nullptr;
+    }
 
-    // Guard against double-resume if timeout already fired
-    if (state->completed) {
-      // Timeout already resumed the coroutine. Clean up and return.
+    // Guard against double-resume if timeout (or the other copy of a hedged
+    // read) already completed it. A replica dropping the hedge is not an
+    // answer either; the primary still is.
+    if (state->completed || (ref->hedge && !reply_ptr)) {
       delete ref;
       return;
     }
     state->completed = true;
 
     // Cancel timeout timer if active
-    if (state->timeout_timer) {
-      uv_timer_stop(state->timeout_timer);
-      uv_close(reinterpret_cast<uv_handle_t*>(state->timeout_timer),
-               [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
-      state->timeout_timer = nullptr;
+    state->timeout_timer.cancel();
+
+    // Redis error replies are not a congestion signal; a lost reply is
+    state->sample(reply_ptr == nullptr);
+    if (state->hedger) {
+      state->hedger->on_complete(std::chrono::steady_clock::now() - state->issued_at,
+                                 ref->hedge);
     }
 
     if (reply_ptr) {
       // Deep-copy the reply data BEFORE hiredis frees it after this callback
-      state->reply = parse_reply(static_cast<redisReply*>(reply_ptr));
+      state->reply = parse_reply(static_cast<redisReply*>(reply_ptr), state->decode,
+                                 resource_of(state->memory));
     } else if (c && c->err) {
       state->error = c->errstr ? c->errstr : "Unknown error";
     } else {
       state->error = "Null reply";
     }
 
-    // Resume the coroutine - the state will be read in await_resume
+    // Resume the coroutine(s) - the state will be read in await_resume
     // We're already on the loop thread since this is a hiredis callback
-    auto h = state->handle;
-    delete ref;  // Clean up before resume (which may destroy state)
-    h.resume();
+    delete ref;
+    state->finish();  // `state` keeps the CommandState alive until we return
   }
 
-  static void OnTimeout(uv_timer_t* timer) {
+  // Deadline of one waiter: the leader (whose timer also bounds the command)
+  // or a follower, which joined later and has its own
+  static void OnTimeout(TimerWheel::Entry* timer) {
     auto* state = static_cast<CommandState*>(timer->data);
     if (!state) return;
 
     // Guard against double-resume if reply already arrived
     if (state->completed) return;
-    state->completed = true;
-
-    state->error = "Request timeout";
-    state->timeout_timer = nullptr;
-
-    // Clean up the timer
-    uv_close(reinterpret_cast<uv_handle_t*>(timer),
-             [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
+    auto self = state->shared_from_this();  // finish() may drop the last owner
 
     // Release the permit immediately - don't wait for OnReply which may never come
     // (e.g., stalled connection). This prevents permit leaks on timeout.
+    state->sample(/*dropped=*/true);
     state->permit = AsyncInflightLimiter::Guard();
 
-    // Resume with timeout error
+    // Followers that joined later are still within their own deadlines: the
+    // leader's caller times out, and the reply (if it comes) still serves
+    // them. New reads no longer join a command past its deadline.
+    if (state->has_waiting_followers()) {
+      state->close_flight();
+      if (!state->detached) {
+        state->detach("Request timeout");
+      }
+      return;
+    }
+
+    state->completed = true;
+    state->error = "Request timeout";
+
     // Note: callback_ref still exists but OnReply will see completed=true or
     // expired weak_ptr (if awaitable finishes and state is destroyed).
-    auto h = state->handle;
-    h.resume();
+    state->finish();
+  }
+};
+
+// Write `command` to the hiredis connection. The reply (or a queueing error)
+// completes `state`.
+void send_command(redisAsyncContext* ctx, const std::shared_ptr<CommandState>& state,
+                  const std::string& command) {
+  // Create callback ref with weak_ptr - allows OnReply to safely check if state
+  // was destroyed after timeout.
+  auto* ref = new CommandStateRef{state};
+  state->callback_ref = ref;
+
+  // Issue the async command
+  int status = redisAsyncFormattedCommand(ctx, CommandState::OnReply, ref,
+                                          command.c_str(), command.size());
+
+  if (status != REDIS_OK) {
+    // Command failed to queue - cancel timer and resume with error
+    state->timeout_timer.cancel();
+    // Clean up callback ref since no callback will fire
+    delete ref;
+    state->callback_ref = nullptr;
+    state->error = ctx->errstr ? ctx->errstr : "Failed to queue Redis command";
+    state->completed = true;
+    state->finish();
+  }
+  // On success, OnReply will be called later and will resume the coroutine
+}
+
+void OnHedgeTimer(uv_timer_t* timer) {
+  auto* state = static_cast<CommandState*>(timer->data);
+  state->hedge_timer = nullptr;
+  ClosePooledTimer(timer);
+  // finish() stops the timer, so the read is still pending here
+  state->hedger->fire(*state);
+}
+
+}  // namespace
+
+void RedisHedger::arm(const std::shared_ptr<CommandState>& state, const std::string& command) {
+  credits = std::min(credits + budget_pct, kMaxCredits);
+  if (delay_us == 0 || credits < kHedgeCost) {
+    return;
+  }
+  state->hedger = this;
+  state->hedge_command = command;
+
+  // libuv timers have millisecond resolution
+  auto* timer = NewPooledTimer();
+  uv_timer_init(loop, timer);
+  timer->data = state.get();
+  state->hedge_timer = timer;
+  uv_timer_start(timer, OnHedgeTimer, std::max<uint64_t>((delay_us + 999) / 1000, 1), 0);
+}
+
+void RedisHedger::fire(CommandState& state) {
+  if (credits < kHedgeCost) {
+    return;  // Budget spent by reads armed earlier
+  }
+  for (size_t tried = 0; tried < replicas.size(); ++tried) {
+    AsyncRedisClient& replica = *replicas[next_replica];
+    next_replica = (next_replica + 1) % replicas.size();
+    if (!replica.is_connected() || !replica.ctx_) {
+      continue;
+    }
+    auto* ref = new CommandStateRef{state.weak_from_this(), /*hedge=*/true};
+    if (redisAsyncFormattedCommand(replica.ctx_, CommandState::OnReply, ref,
+                                   state.hedge_command.c_str(),
+                                   state.hedge_command.size()) != REDIS_OK) {
+      delete ref;
+      continue;
+    }
+    credits -= kHedgeCost;
+    ++issued;
+    return;
+  }
+}
+
+void RedisHedger::on_complete(std::chrono::steady_clock::duration rtt, bool hedge_won) {
+  won += hedge_won ? 1 : 0;
+
+  // When the hedge won, the primary's RTT is at least `rtt`; recording that
+  // keeps slow primaries in the window
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(rtt).count();
+  auto sample = static_cast<uint32_t>(std::clamp<int64_t>(us, 0, UINT32_MAX));
+  if (rtts_us.size() < kRttWindow) {
+    rtts_us.push_back(sample);
+  } else {
+    rtts_us[next_rtt] = sample;
+    next_rtt = (next_rtt + 1) % kRttWindow;
   }
+
+  if (++samples % kRecomputeEvery == 0) {
+    std::vector<uint32_t> sorted = rtts_us;
+    auto nth = sorted.begin() + static_cast<ptrdiff_t>(sorted.size() * percentile / 100);
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    delay_us = std::max<uint64_t>(*nth, 1);
+  }
+}
+
+// Cross-request micro-batching window. Commands from all requests on this
+// client are held until `window_ns` after the first one, or until `max_ops`
+// are pending, then written back to back.
+//
+// The window is checked after every poll phase (uv_check), so under load it
+// closes close to `window_ns`. A timer, rounded up to whole milliseconds,
+// wakes an otherwise idle loop. Loop thread only.
+struct RedisBatchWindow {
+  struct Pending {
+    std::shared_ptr<CommandState> state;
+    std::string command;
+  };
+
+  RedisBatchWindow(uv_loop_t* loop, redisAsyncContext** ctx_ptr, uint64_t window_us,
+                   size_t max_ops)
+      : ctx_ptr(ctx_ptr),
+        window_ns(window_us * 1000),
+        max_ops(max_ops > 0 ? max_ops : 1),
+        timer(new uv_timer_t),
+        check(new uv_check_t) {
+    uv_timer_init(loop, timer);
+    uv_check_init(loop, check);
+    timer->data = this;
+    check->data = this;
+  }
+
+  ~RedisBatchWindow() {
+    // EventLoop::Stop() closes every open handle; if it got here first the
+    // handles are left to it (leaked rather than double-closed)
+    auto* t = reinterpret_cast<uv_handle_t*>(timer);
+    auto* c = reinterpret_cast<uv_handle_t*>(check);
+    if (!uv_is_closing(t)) {
+      uv_close(t, [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
+    }
+    if (!uv_is_closing(c)) {
+      uv_close(c, [](uv_handle_t* h) { delete reinterpret_cast<uv_check_t*>(h); });
+    }
+  }
+
+  void enqueue(std::shared_ptr<CommandState> state, std::string command) {
+    pending.push_back(Pending{std::move(state), std::move(command)});
+    if (pending.size() >= max_ops) {
+      flush();
+      return;
+    }
+    if (pending.size() == 1) {
+      opened_ns = uv_hrtime();
+      uint64_t timeout_ms = (window_ns + 999'999) / 1'000'000;
+      uv_timer_start(timer, OnTimer, timeout_ms, 0);
+      uv_check_start(check, OnCheck);
+    }
+  }
+
+  void flush() {
+    uv_timer_stop(timer);
+    uv_check_stop(check);
+    // Swap out first: completions below may enqueue into a fresh window
+    auto batch = std::move(pending);
+    pending.clear();
+    if (batch.empty()) return;
+    ++flushes;
+    commands += batch.size();
+
+    for (auto& p : batch) {
+      if (p.state->completed) continue;  // Timed out while waiting
+      redisAsyncContext* ctx = *ctx_ptr;
+      if (!ctx) {
+        p.state->error = "Connection closed while batching";
+        p.state->completed = true;
+        p.state->finish();
+        continue;
+      }
+      send_command(ctx, p.state, p.command);
+    }
+  }
+
+  static void OnTimer(uv_timer_t* t) { static_cast<RedisBatchWindow*>(t->data)->flush(); }
+
+  static void OnCheck(uv_check_t* c) {
+    auto* self = static_cast<RedisBatchWindow*>(c->data);
+    if (uv_hrtime() - self->opened_ns >= self->window_ns) {
+      self->flush();
+    }
+  }
+
+  redisAsyncContext** ctx_ptr;
+  uint64_t window_ns;
+  size_t max_ops;
+  uv_timer_t* timer;
+  uv_check_t* check;
+  std::vector<Pending> pending;
+  uint64_t opened_ns = 0;
+  uint64_t flushes = 0;
+  uint64_t commands = 0;
+};
+
+namespace {
+
+// Everything needed to put a command on the wire once it holds a permit. A
+// command queued for a permit keeps its own copy: if it leads a single-flight
+// read, its awaiter may be cancelled and gone before the permit frees up,
+// while followers still wait on the read.
+struct CommandIssue {
+  EventLoop& loop;
+  redisAsyncContext** ctx_ptr;  // Pointer to client's ctx_ member
+  RedisBatchWindow* window;     // nullptr = send immediately
+  RedisHedger* hedger;          // nullptr = no hedged reads
+  std::string command;
+  int timeout_ms;  // 0 = no timeout
 };
 
+// Send (or batch) a command that holds its permit. A send that fails resumes
+// the awaiter, which may destroy the awaitable.
+void issue_command(CommandIssue& issue, const std::shared_ptr<CommandState>& state) {
+  // Check if connection is still valid (may have disconnected while waiting)
+  redisAsyncContext* ctx = *issue.ctx_ptr;
+  if (!ctx) {
+    state->error = "Connection closed while waiting for permit";
+    state->completed = true;
+    state->finish();
+    return;
+  }
+
+  state->issued_at = std::chrono::steady_clock::now();
+
+  // Start timeout timer if configured
+  if (issue.timeout_ms > 0) {
+    state->timeout_timer.data = state.get();
+    issue.loop.Timers().schedule(state->timeout_timer, static_cast<uint64_t>(issue.timeout_ms),
+                                 CommandState::OnTimeout);
+  }
+
+  // Before sending: a send that fails resumes (and may destroy) the awaiter
+  if (issue.hedger) {
+    issue.hedger->arm(state, issue.command);
+  }
+
+  // Hold the command for the cross-request batching window, if configured
+  if (issue.window) {
+    issue.window->enqueue(state, std::move(issue.command));
+    return;
+  }
+  send_command(ctx, state, issue.command);
+}
+
 // Awaitable for a single Redis command that suspends until reply arrives.
 //
 // IMPORTANT LIFETIME REQUIREMENTS:
@@ -170,13 +642,18 @@ class RedisCommandAwaitable {
   // to handle disconnection while waiting for permits - the client clears ctx_
   // on disconnect and we check it before issuing commands.
   RedisCommandAwaitable(EventLoop& loop, redisAsyncContext** ctx_ptr, AsyncInflightLimiter& limiter,
-                        std::string command, int timeout_ms)
-      : loop_(loop),
-        ctx_ptr_(ctx_ptr),
+                        std::shared_ptr<RedisSingleFlight> flights, RedisBatchWindow* window,
+                        RedisHedger* hedger, std::string command, int timeout_ms,
+                        CancellationToken cancel, ReplyDecode decode = ReplyDecode::Strings,
+                        std::shared_ptr<std::pmr::memory_resource> ids_memory = nullptr)
+      : issue_{loop, ctx_ptr, window, hedger, std::move(command), timeout_ms},
         limiter_(limiter),
-        command_(std::move(command)),
-        timeout_ms_(timeout_ms),
-        state_(std::make_shared<CommandState>()) {}
+        flights_(std::move(flights)),
+        cancel_(std::move(cancel)),
+        state_(make_pooled_shared<CommandState>()) {
+    state_->decode = decode;
+    state_->memory = std::move(ids_memory);
+  }
 
   // Move-only (reference member prevents assignment)
   RedisCommandAwaitable(RedisCommandAwaitable&&) = default;
@@ -190,7 +667,7 @@ class RedisCommandAwaitable {
     // Post the command execution to the event loop thread
     // Capture raw pointer - unique_ptr still owned by this object
     auto* state_ptr = state_.get();
-    bool posted = loop_.Post([this, state_ptr]() { execute_on_loop(state_ptr); });
+    bool posted = issue_.loop.Post([this, state_ptr]() { execute_on_loop(state_ptr); });
 
     if (!posted) {
       // Loop not running - don't suspend
@@ -201,8 +678,10 @@ class RedisCommandAwaitable {
   }
 
   std::expected<ParsedReply, AsyncRedisClient::Error> await_resume() {
-    if (!state_->error.empty()) {
-      return std::unexpected(AsyncRedisClient::Error{state_->error, 0});
+    // A leader that left early; its followers get the command's own outcome
+    const std::string& error = state_->detached ? state_->detached_error : state_->error;
+    if (!error.empty()) {
+      return std::unexpected(AsyncRedisClient::Error{error, 0});
     }
     if (state_->reply.type == 0) {
       return std::unexpected(AsyncRedisClient::Error{"No reply from Redis", 0});
@@ -216,36 +695,87 @@ class RedisCommandAwaitable {
 
  private:
   void execute_on_loop(CommandState* state_ptr) {
+    if (cancel_.cancelled()) {
+      state_ptr->error = "Cancelled";
+      state_ptr->completed = true;
+      state_ptr->finish();
+      return;
+    }
+    state_ptr->cancel_reg = cancel_.on_cancel([state_ptr]() { state_ptr->cancel(); });
+
+    // Single-flight: join an identical in-flight read instead of issuing it.
+    // Followers take no permit; the leader's reply (or error) resumes them.
+    if (flights_) {
+      // Followers copy the leader's decoded reply, so the decoding is part
+      // of the key
+      std::string key = issue_.command;
+      if (state_ptr->decode == ReplyDecode::Int64s) {
+        key += "#ids";
+      }
+      auto [it, inserted] = flights_->leaders.try_emplace(key, state_);
+      if (!inserted) {
+        it->second->followers.push_back(state_);
+        state_ptr->leader = it->second;
+        ++flights_->coalesced;
+        // The follower's deadline counts from when it joined, not from when
+        // the leader was issued
+        if (issue_.timeout_ms > 0) {
+          state_ptr->timeout_timer.data = state_ptr;
+          issue_.loop.Timers().schedule(state_ptr->timeout_timer,
+                                        static_cast<uint64_t>(issue_.timeout_ms),
+                                        CommandState::OnTimeout);
+        }
+        return;
+      }
+      state_ptr->flights = flights_;
+      state_ptr->flight_key = std::move(key);
+    }
+
     // Try to acquire a permit synchronously
     if (limiter_.try_acquire()) {
       state_ptr->permit = AsyncInflightLimiter::Guard(&limiter_);
-      issue_command(state_ptr);
+      issue_command(issue_, state_);
       return;
     }
 
     // Need to wait for a permit - create a wrapper coroutine
     // We store the task in a struct that self-destructs after completion
     struct WaitAndExecute {
-      RedisCommandAwaitable* self;
-      CommandState* state;
+      CommandIssue issue;
+      std::shared_ptr<CommandState> state;  // Outlives the awaitable if cancelled
+      AsyncInflightLimiter& limiter;
+      CancellationToken cancel;
       Task<void> task;
 
+      static void* operator new(std::size_t size) {
+        return FramePool::instance().allocate(size);
+      }
+      static void operator delete(void* p, std::size_t size) noexcept {
+        FramePool::instance().deallocate(p, size);
+      }
+
       Task<void> run() {
-        auto guard = co_await self->limiter_.acquire();
-        state->permit = std::move(guard);
-        // SAFETY: Capture loop reference BEFORE issue_command. If issue_command
-        // fails, it resumes the awaiter synchronously, which may destroy the
-        // RedisCommandAwaitable (self) before we return. Accessing self->loop_
-        // after that would be use-after-free.
-        EventLoop& loop = self->loop_;
-        self->issue_command(state);
+        auto guard = co_await limiter.acquire();
+        // The token may have fired while a permit was handed over, before this
+        // command's own callback ran
+        if (cancel.cancelled()) {
+          state->cancel();
+        }
+        // Cancelled while queued: the awaiter has resumed and the awaitable
+        // may be gone, so only `issue` and `state` are used here. A leader
+        // whose followers still wait is sent for them; otherwise the permit is
+        // handed straight back when `guard` goes out of scope.
+        if (!state->completed) {
+          state->permit = std::move(guard);
+          issue_command(issue, state);
+        }
         // Post cleanup to next event loop iteration - coroutine will be at
         // final_suspend by then and safe to destroy.
         // SAFETY: We MUST defer deletion because we're still inside the coroutine.
         // Deleting 'this' would destroy the Task member and call handle_.destroy()
         // on the running coroutine frame, which is undefined behavior.
         auto* to_delete = this;
-        bool posted = loop.Post([to_delete]() { delete to_delete; });
+        bool posted = issue.loop.Post([to_delete]() { delete to_delete; });
         if (!posted) {
           // Loop stopped - can't post. Leak intentionally to avoid UB.
           // This only happens during shutdown when the loop is already stopped,
@@ -255,60 +785,16 @@ class RedisCommandAwaitable {
       }
     };
 
-    auto* waiter = new WaitAndExecute{this, state_ptr, Task<void>(nullptr)};
+    auto* waiter = new WaitAndExecute{std::move(issue_), state_, limiter_, cancel_,
+                                      Task<void>(nullptr)};
     waiter->task = waiter->run();
     waiter->task.start();
   }
 
-  void issue_command(CommandState* state_ptr) {
-    // Check if connection is still valid (may have disconnected while waiting)
-    redisAsyncContext* ctx = *ctx_ptr_;
-    if (!ctx) {
-      state_ptr->error = "Connection closed while waiting for permit";
-      state_ptr->handle.resume();
-      return;
-    }
-
-    // Start timeout timer if configured
-    if (timeout_ms_ > 0) {
-      auto* timer = new uv_timer_t;
-      uv_timer_init(loop_.RawLoop(), timer);
-      timer->data = state_ptr;
-      state_ptr->timeout_timer = timer;
-      uv_timer_start(timer, CommandState::OnTimeout, static_cast<uint64_t>(timeout_ms_), 0);
-    }
-
-    // Create callback ref with weak_ptr - allows OnReply to safely check if state
-    // was destroyed after timeout.
-    auto* ref = new CommandStateRef{state_};
-    state_ptr->callback_ref = ref;
-
-    // Issue the async command
-    int status = redisAsyncFormattedCommand(ctx, CommandState::OnReply, ref,
-                                            command_.c_str(), command_.size());
-
-    if (status != REDIS_OK) {
-      // Command failed to queue - cancel timer and resume with error
-      if (state_ptr->timeout_timer) {
-        uv_timer_stop(state_ptr->timeout_timer);
-        uv_close(reinterpret_cast<uv_handle_t*>(state_ptr->timeout_timer),
-                 [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
-        state_ptr->timeout_timer = nullptr;
-      }
-      // Clean up callback ref since no callback will fire
-      delete ref;
-      state_ptr->callback_ref = nullptr;
-      state_ptr->error = ctx->errstr ? ctx->errstr : "Failed to queue Redis command";
-      state_ptr->handle.resume();
-    }
-    // On success, OnReply will be called later and will resume the coroutine
-  }
-
-  EventLoop& loop_;
-  redisAsyncContext** ctx_ptr_;  // Pointer to client's ctx_ member
+  CommandIssue issue_;
   AsyncInflightLimiter& limiter_;
-  std::string command_;
-  int timeout_ms_;  // 0 = no timeout
+  std::shared_ptr<RedisSingleFlight> flights_;  // nullptr = no coalescing
+  CancellationToken cancel_;
   std::shared_ptr<CommandState> state_;
 };
 
@@ -347,13 +833,53 @@ void RedisOpState::OnReply(redisAsyncContext* c, void* reply, void* privdata) {
 // AsyncRedisClient implementation
 
 AsyncRedisClient::AsyncRedisClient(EventLoop& loop, std::string endpoint_id, int max_inflight,
-                                   int request_timeout_ms)
+                                   int request_timeout_ms, int batch_window_us,
+                                   int batch_max_ops, int min_inflight)
     : loop_(loop),
       limiter_(max_inflight > 0 ? static_cast<size_t>(max_inflight) : 64),
       endpoint_id_(std::move(endpoint_id)),
-      request_timeout_ms_(request_timeout_ms) {}
+      request_timeout_ms_(request_timeout_ms),
+      single_flight_(std::make_shared<RedisSingleFlight>()) {
+  if (min_inflight > 0) {
+    limiter_.enable_adaptive(static_cast<size_t>(min_inflight));
+  }
+  if (batch_window_us > 0) {
+    batch_window_ = std::make_unique<RedisBatchWindow>(
+        loop_.RawLoop(), &ctx_, static_cast<uint64_t>(batch_window_us),
+        static_cast<size_t>(batch_max_ops));
+  }
+}
+
+uint64_t AsyncRedisClient::command_count() const {
+  return commands_;
+}
+
+uint64_t AsyncRedisClient::coalesced_count() const {
+  return single_flight_->coalesced;
+}
+
+uint64_t AsyncRedisClient::batch_flush_count() const {
+  return batch_window_ ? batch_window_->flushes : 0;
+}
+
+uint64_t AsyncRedisClient::batched_command_count() const {
+  return batch_window_ ? batch_window_->commands : 0;
+}
+
+uint64_t AsyncRedisClient::hedges_issued() const {
+  return hedger_ ? hedger_->issued : 0;
+}
+
+uint64_t AsyncRedisClient::hedges_won() const {
+  return hedger_ ? hedger_->won : 0;
+}
 
 AsyncRedisClient::~AsyncRedisClient() {
+  // Send anything still held by the batching window before disconnecting
+  if (batch_window_) {
+    batch_window_->flush();
+  }
+
   if (ctx_) {
     // SAFETY: Clear data pointer before disconnect to prevent callbacks from
     // dereferencing freed client memory (use-after-free prevention).
@@ -378,9 +904,16 @@ std::expected<std::unique_ptr<AsyncRedisClient>, std::string> AsyncRedisClient::
   int max_inflight = spec.policy.max_inflight.value_or(64);
   int connect_timeout_ms = spec.policy.connect_timeout_ms.value_or(50);
   int request_timeout_ms = spec.policy.request_timeout_ms.value_or(0);  // 0 = no timeout
+  int batch_window_us = spec.policy.batch_window_us.value_or(0);  // 0 = no batching
+  int batch_max_ops = spec.policy.batch_max_ops.value_or(max_inflight);
+  // 0 = static limit
+  int min_inflight = spec.policy.adaptive_inflight.value_or(false)
+                         ? std::max(spec.policy.min_inflight.value_or(1), 1)
+                         : 0;
 
   auto client = std::unique_ptr<AsyncRedisClient>(
-      new AsyncRedisClient(loop, spec.endpoint_id, max_inflight, request_timeout_ms));
+      new AsyncRedisClient(loop, spec.endpoint_id, max_inflight, request_timeout_ms,
+                           batch_window_us, batch_max_ops, min_inflight));
 
   // Connect
   auto result =
@@ -389,6 +922,25 @@ std::expected<std::unique_ptr<AsyncRedisClient>, std::string> AsyncRedisClient::
     return std::unexpected(result.error());
   }
 
+  // Replica connections for hedged reads (best effort)
+  int hedge_percentile = spec.policy.hedge_percentile.value_or(0);
+  if (hedge_percentile > 0 && !spec.replicas.empty()) {
+    auto hedger = std::make_unique<RedisHedger>(loop.RawLoop(), hedge_percentile,
+                                                spec.policy.hedge_budget_pct.value_or(5));
+    for (const auto& replica : spec.replicas) {
+      rankd::EndpointSpec replica_spec = spec;
+      replica_spec.static_resolver = replica;
+      replica_spec.replicas.clear();
+      replica_spec.policy.batch_window_us.reset();
+      if (auto replica_client = Create(loop, replica_spec)) {
+        hedger->replicas.push_back(std::move(*replica_client));
+      }
+    }
+    if (!hedger->replicas.empty()) {
+      client->hedger_ = std::move(hedger);
+    }
+  }
+
   return client;
 }
 
@@ -447,6 +999,8 @@ void AsyncRedisClient::OnConnect(const redisAsyncContext* c, int status) {
   } else {
     client->connected_ = false;
     client->last_error_ = c->errstr ? c->errstr : "Connection failed";
+    // hiredis frees the context after a failed connect (no disconnect callback)
+    client->ctx_ = nullptr;
   }
 }
 
@@ -464,7 +1018,7 @@ void AsyncRedisClient::OnDisconnect(const redisAsyncContext* c, int status) {
 }
 
 Task<AsyncRedisClient::Result<std::optional<std::string>>> AsyncRedisClient::HGet(
-    std::string_view key, std::string_view field) {
+    std::string_view key, std::string_view field, CancellationToken cancel) {
   if (!ctx_) {
     co_return std::unexpected(Error{"Not connected", REDIS_ERR_OTHER});
   }
@@ -472,9 +1026,12 @@ Task<AsyncRedisClient::Result<std::optional<std::string>>> AsyncRedisClient::HGe
   // Build HGET command
   std::string cmd = build_command({"HGET", key, field});
 
+  ++commands_;
   // Create awaitable and execute
   auto reply_result =
-      co_await RedisCommandAwaitable(loop_, &ctx_, limiter_, std::move(cmd), request_timeout_ms_);
+      co_await RedisCommandAwaitable(loop_, &ctx_, limiter_, single_flight_, batch_window_.get(),
+                                     hedger_.get(), std::move(cmd), request_timeout_ms_,
+                                     std::move(cancel));
 
   if (!reply_result) {
     co_return std::unexpected(reply_result.error());
@@ -497,7 +1054,7 @@ Task<AsyncRedisClient::Result<std::optional<std::string>>> AsyncRedisClient::HGe
 }
 
 Task<AsyncRedisClient::Result<std::vector<std::string>>> AsyncRedisClient::LRange(
-    std::string_view key, int64_t start, int64_t stop) {
+    std::string_view key, int64_t start, int64_t stop, CancellationToken cancel) {
   if (!ctx_) {
     co_return std::unexpected(Error{"Not connected", REDIS_ERR_OTHER});
   }
@@ -505,7 +1062,11 @@ Task<AsyncRedisClient::Result<std::vector<std::string>>> AsyncRedisClient::LRang
   // Build LRANGE command
   std::string cmd = build_command({"LRANGE", key, std::to_string(start), std::to_string(stop)});
 
-  auto reply_result = co_await RedisCommandAwaitable(loop_, &ctx_, limiter_, std::move(cmd), request_timeout_ms_);
+  ++commands_;
+  auto reply_result =
+      co_await RedisCommandAwaitable(loop_, &ctx_, limiter_, single_flight_, batch_window_.get(),
+                                     hedger_.get(), std::move(cmd), request_timeout_ms_,
+                                     std::move(cancel));
 
   if (!reply_result) {
     co_return std::unexpected(reply_result.error());
@@ -522,8 +1083,37 @@ Task<AsyncRedisClient::Result<std::vector<std::string>>> AsyncRedisClient::LRang
   co_return std::move(reply.array_vals);
 }
 
+Task<AsyncRedisClient::Result<AsyncRedisClient::IdList>> AsyncRedisClient::LRangeIds(
+    std::string_view key, int64_t start, int64_t stop,
+    std::shared_ptr<std::pmr::memory_resource> memory, CancellationToken cancel) {
+  if (!ctx_) {
+    co_return std::unexpected(Error{"Not connected", REDIS_ERR_OTHER});
+  }
+
+  std::string cmd = build_command({"LRANGE", key, std::to_string(start), std::to_string(stop)});
+
+  ++commands_;
+  // Ids are parsed in the reply callback straight into column storage; no
+  // per-element strings are built
+  auto reply_result = co_await RedisCommandAwaitable(
+      loop_, &ctx_, limiter_, single_flight_, batch_window_.get(), hedger_.get(),
+      std::move(cmd), request_timeout_ms_, std::move(cancel), ReplyDecode::Int64s, memory);
+
+  if (!reply_result) {
+    co_return std::unexpected(reply_result.error());
+  }
+
+  auto& reply = *reply_result;
+  if (reply.type != REDIS_REPLY_ARRAY) {
+    co_return std::unexpected(
+        Error{"Unexpected reply type for LRANGE: " + std::to_string(reply.type), REDIS_ERR_OTHER});
+  }
+
+  co_return IdList{std::move(memory), std::move(reply.array_ids), reply.array_bytes};
+}
+
 Task<AsyncRedisClient::Result<std::vector<std::string>>> AsyncRedisClient::HGetAll(
-    std::string_view key) {
+    std::string_view key, CancellationToken cancel) {
   if (!ctx_) {
     co_return std::unexpected(Error{"Not connected", REDIS_ERR_OTHER});
   }
@@ -531,7 +1121,11 @@ Task<AsyncRedisClient::Result<std::vector<std::string>>> AsyncRedisClient::HGetA
   // Build HGETALL command
   std::string cmd = build_command({"HGETALL", key});
 
-  auto reply_result = co_await RedisCommandAwaitable(loop_, &ctx_, limiter_, std::move(cmd), request_timeout_ms_);
+  ++commands_;
+  auto reply_result =
+      co_await RedisCommandAwaitable(loop_, &ctx_, limiter_, single_flight_, batch_window_.get(),
+                                     hedger_.get(), std::move(cmd), request_timeout_ms_,
+                                     std::move(cancel));
 
   if (!reply_result) {
     co_return std::unexpected(reply_result.error());
@@ -548,4 +1142,109 @@ Task<AsyncRedisClient::Result<std::vector<std::string>>> AsyncRedisClient::HGetA
   co_return std::move(reply.array_vals);
 }
 
+Task<AsyncRedisClient::Result<std::vector<std::optional<std::string>>>>
+AsyncRedisClient::HMGet(std::string_view key, const std::vector<std::string>& fields,
+                        CancellationToken cancel) {
+  if (!ctx_) {
+    co_return std::unexpected(Error{"Not connected", REDIS_ERR_OTHER});
+  }
+
+  // Build HMGET command
+  std::vector<std::string_view> args;
+  args.reserve(fields.size() + 2);
+  args.push_back("HMGET");
+  args.push_back(key);
+  args.insert(args.end(), fields.begin(), fields.end());
+  std::string cmd = build_command(args);
+
+  ++commands_;
+  auto reply_result =
+      co_await RedisCommandAwaitable(loop_, &ctx_, limiter_, single_flight_, batch_window_.get(),
+                                     hedger_.get(), std::move(cmd), request_timeout_ms_,
+                                     std::move(cancel));
+
+  if (!reply_result) {
+    co_return std::unexpected(reply_result.error());
+  }
+
+  auto& reply = *reply_result;
+
+  // Parse result (one entry per requested field, nil if absent)
+  if (reply.type != REDIS_REPLY_ARRAY || reply.array_vals.size() != fields.size()) {
+    co_return std::unexpected(
+        Error{"Unexpected reply type for HMGET: " + std::to_string(reply.type), REDIS_ERR_OTHER});
+  }
+
+  std::vector<std::optional<std::string>> values(fields.size());
+  for (size_t i = 0; i < fields.size(); ++i) {
+    if (!reply.array_nil[i]) {
+      values[i] = std::move(reply.array_vals[i]);
+    }
+  }
+  co_return values;
+}
+
+Task<std::vector<AsyncRedisClient::Result<std::vector<std::string>>>>
+AsyncRedisClient::LRangeBatch(std::vector<std::string> keys, int64_t start, int64_t stop,
+                              CancellationToken cancel) {
+  // keys lives in this frame, so the string_views held by each op stay valid
+  std::vector<Task<Result<std::vector<std::string>>>> ops;
+  ops.reserve(keys.size());
+  for (const auto& key : keys) {
+    ops.push_back(LRange(key, start, stop, cancel));
+  }
+  co_return co_await WhenAll(std::move(ops));
+}
+
+Task<std::vector<AsyncRedisClient::Result<AsyncRedisClient::IdList>>>
+AsyncRedisClient::LRangeIdsBatch(std::vector<std::string> keys, int64_t start, int64_t stop,
+                                 std::shared_ptr<std::pmr::memory_resource> memory,
+                                 CancellationToken cancel) {
+  std::vector<Task<Result<IdList>>> ops;
+  ops.reserve(keys.size());
+  for (const auto& key : keys) {
+    ops.push_back(LRangeIds(key, start, stop, memory, cancel));
+  }
+  co_return co_await WhenAll(std::move(ops));
+}
+
+std::shared_ptr<rankd::IdColumn> AsyncRedisClient::JoinIds(
+    std::vector<Result<IdList>>& lists, const std::shared_ptr<std::pmr::memory_resource>& memory) {
+  if (lists.size() == 1) {
+    return std::move(lists[0]->ids);
+  }
+  size_t n = 0;
+  for (const auto& list : lists) {
+    n += list->ids->values.size();
+  }
+  auto ids = std::make_shared<rankd::IdColumn>(n, rankd::ColumnInit::Uninitialized,
+                                               resource_of(memory));
+  auto out = ids->values.begin();
+  for (const auto& list : lists) {
+    out = std::copy(list->ids->values.begin(), list->ids->values.end(), out);
+  }
+  return ids;
+}
+
+Task<std::vector<AsyncRedisClient::Result<std::vector<std::string>>>>
+AsyncRedisClient::HGetAllBatch(std::vector<std::string> keys, CancellationToken cancel) {
+  std::vector<Task<Result<std::vector<std::string>>>> ops;
+  ops.reserve(keys.size());
+  for (const auto& key : keys) {
+    ops.push_back(HGetAll(key, cancel));
+  }
+  co_return co_await WhenAll(std::move(ops));
+}
+
+Task<std::vector<AsyncRedisClient::Result<std::vector<std::optional<std::string>>>>>
+AsyncRedisClient::HMGetBatch(std::vector<std::string> keys, std::vector<std::string> fields,
+                             CancellationToken cancel) {
+  std::vector<Task<Result<std::vector<std::optional<std::string>>>>> ops;
+  ops.reserve(keys.size());
+  for (const auto& key : keys) {
+    ops.push_back(HMGet(key, fields, cancel));
+  }
+  co_return co_await WhenAll(std::move(ops));
+}
+
 }  // namespace ranking
@@ -0,0 +1,176 @@
+#include "bench_dag.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "bench_stats.h"
+#include "critical_path.h"
+#include "dag_scheduler.h"
+#include "executor.h"
+#include "param_table.h"
+#include "request.h"
+
+using json = nlohmann::ordered_json;
+using namespace std::chrono;
+using ranking::LatencyStats;
+using ranking::compute_latency_stats;
+
+namespace rankd {
+
+namespace {
+
+// fixed_source -> width x sleep(node_ms)       (side branches)
+//              -> sleep(node_ms) x depth chain  (critical path)
+//
+// Side branches come first in node order, as a compiler may emit them, so a
+// FIFO ready queue hands them every slot before the chain starts. sleep
+// holds a slot without spinning, so results do not depend on core count.
+Plan make_wide_plan(int width, int depth, int node_ms) {
+  Plan plan;
+  plan.schema_version = 1;
+  plan.plan_name = "bench_wide_dag_" + std::to_string(width);
+
+  Node source;
+  source.node_id = "source";
+  source.op = "test::fixed_source";
+  source.params = nlohmann::json::object();
+  plan.nodes.push_back(source);
+
+  auto sleep_node = [&](const std::string& id, const std::string& input) {
+    Node node;
+    node.node_id = id;
+    node.op = "test::sleep";
+    node.inputs = {input};
+    node.params = nlohmann::json::object();
+    node.params["duration_ms"] = node_ms;
+    plan.nodes.push_back(node);
+  };
+
+  for (int i = 0; i < width; ++i) {
+    sleep_node("side_" + std::to_string(i), "source");
+    plan.outputs.push_back("side_" + std::to_string(i));
+  }
+  std::string prev = "source";
+  for (int i = 0; i < depth; ++i) {
+    std::string id = "chain_" + std::to_string(i);
+    sleep_node(id, prev);
+    prev = id;
+  }
+  plan.outputs.push_back(prev);
+  return plan;
+}
+
+LatencyStats run_policy(const Plan& plan, int iterations, int slots, bool critical_path) {
+  auto& model = NodeCostModel::instance();
+  model.setEnabled(critical_path);
+  model.clear();
+
+  ParamTable params;
+  RequestContext request;
+  request.user_id = 1;
+  request.request_id = "bench_dag";
+
+  ExecCtx ctx;
+  ctx.params = &params;
+  ctx.expr_table = &plan.expr_table;
+  ctx.pred_table = &plan.pred_table;
+  ctx.request = &request;
+  ctx.parallel = true;
+
+  std::vector<double> latencies_us;
+  latencies_us.reserve(iterations);
+  for (int i = 0; i < iterations; ++i) {
+    auto start = steady_clock::now();
+    execute_plan_parallel(plan, ctx, slots);
+    latencies_us.push_back(duration<double, std::micro>(steady_clock::now() - start).count());
+  }
+  return compute_latency_stats(latencies_us);
+}
+
+struct WidthResult {
+  int width = 0;
+  LatencyStats fifo;
+  LatencyStats critical_path;
+};
+
+json latency_to_json(const LatencyStats& l) {
+  json j;
+  j["mean_us"] = l.mean_us;
+  j["p50_us"] = l.p50_us;
+  j["p90_us"] = l.p90_us;
+  j["p99_us"] = l.p99_us;
+  j["count"] = l.count;
+  return j;
+}
+
+void print_width_human(const BenchDagConfig& config, const WidthResult& r) {
+  std::cout << "=== DAG Benchmark: width " << r.width << ", depth " << config.depth << " x "
+            << config.node_ms << "ms, " << config.slots << " slots ===" << std::endl;
+  std::cout << "  FIFO          p50/p99/mean: " << std::fixed << std::setprecision(1)
+            << r.fifo.p50_us / 1000.0 << "/" << r.fifo.p99_us / 1000.0 << "/"
+            << r.fifo.mean_us / 1000.0 << " ms" << std::endl;
+  std::cout << "  Critical path p50/p99/mean: " << std::fixed << std::setprecision(1)
+            << r.critical_path.p50_us / 1000.0 << "/" << r.critical_path.p99_us / 1000.0 << "/"
+            << r.critical_path.mean_us / 1000.0 << " ms" << std::endl;
+  double speedup = r.critical_path.mean_us > 0 ? r.fifo.mean_us / r.critical_path.mean_us : 0.0;
+  std::cout << "  Speedup (mean, fifo/cp): " << std::fixed << std::setprecision(2) << speedup
+            << "x" << std::endl;
+  std::cout << std::endl;
+}
+
+}  // namespace
+
+int run_bench_dag(const BenchDagConfig& config) {
+  if (config.iterations <= 0 || config.max_width <= 0 || config.depth <= 0 ||
+      config.node_ms < 0 || config.slots <= 0) {
+    std::cerr << "Error: invalid bench_dag configuration" << std::endl;
+    return 1;
+  }
+
+  // Sweep 8, 16, 32, ... side branches up to config.max_width
+  std::vector<int> widths;
+  for (int w = 8; w < config.max_width; w *= 2) {
+    widths.push_back(w);
+  }
+  widths.push_back(config.max_width);
+
+  bool was_enabled = NodeCostModel::instance().enabled();
+  json results = json::array();
+  for (int width : widths) {
+    Plan plan = make_wide_plan(width, config.depth, config.node_ms);
+    validate_plan(plan, nullptr);
+
+    WidthResult r;
+    r.width = width;
+    r.fifo = run_policy(plan, config.iterations, config.slots, false);
+    r.critical_path = run_policy(plan, config.iterations, config.slots, true);
+
+    if (config.json_output) {
+      json j;
+      j["width"] = width;
+      j["depth"] = config.depth;
+      j["node_ms"] = config.node_ms;
+      j["slots"] = config.slots;
+      j["fifo"] = latency_to_json(r.fifo);
+      j["critical_path"] = latency_to_json(r.critical_path);
+      results.push_back(std::move(j));
+    } else {
+      print_width_human(config, r);
+    }
+  }
+  NodeCostModel::instance().setEnabled(was_enabled);
+
+  if (config.json_output) {
+    json output;
+    output["dag"] = std::move(results);
+    std::cout << output.dump(2) << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace rankd
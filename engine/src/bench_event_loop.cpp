@@ -1,5 +1,6 @@
 #include "bench_event_loop.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <future>
@@ -13,7 +14,9 @@
 
 #include "bench_stats.h"
 #include "coro_task.h"
+#include "cpu_offload.h"
 #include "event_loop.h"
+#include "frame_pool.h"
 #include "thread_pool.h"
 #include "uv_sleep.h"
 
@@ -28,19 +31,53 @@ namespace ranking {
 
 struct PostsBenchResult {
   int total_posts = 0;
-  int producers = 0;
+  int producers = 0;  // 0 = posted from the loop thread
+  bool pooled = true;  // PostNodes from FramePool (false: thread cache limit 0)
   double wall_ms = 0.0;
   double posts_per_sec = 0.0;
+  uint64_t wakeups = 0;  // uv_async wakeups that drained the queue
+  double system_allocs_per_post = 0.0;  // PostNodes the pool could not serve
   int64_t rss_start_kb = 0;
   int64_t rss_end_kb = 0;
 };
 
-static PostsBenchResult bench_posts(int n, int producers) {
+// Loop-thread posts: each callback posts the next one, as a resumed coroutine
+// posting its continuation does. kChains chains run interleaved.
+struct PostChains {
+  static constexpr int kChains = 64;
+
+  EventLoop* loop;
+  int total;
+  int issued = 0;  // Loop thread only
+  int ran = 0;
+  std::promise<void>* done;
+
+  void post() {
+    ++issued;
+    loop->Post([this]() { run(); });
+  }
+  void run() {
+    if (++ran == total) {
+      done->set_value();
+    } else if (issued < total) {
+      post();
+    }
+  }
+};
+
+static PostsBenchResult bench_posts(int n, int producers, bool pooled = true) {
   PostsBenchResult result;
   result.total_posts = n;
   result.producers = producers;
+  result.pooled = pooled;
   result.rss_start_kb = get_current_rss_kb();
 
+  auto& pool = FramePool::instance();
+  size_t prev_limit = pool.threadCacheLimit();
+  if (!pooled) {
+    pool.setThreadCacheLimit(0);
+  }
+
   EventLoop loop;
   loop.Start();
 
@@ -59,9 +96,17 @@ static PostsBenchResult bench_posts(int n, int producers) {
     }
   };
 
+  PostChains chains{&loop, n, 0, 0, &done};
+  uint64_t system_start = pool.systemAllocations();
   auto start = steady_clock::now();
 
-  if (producers == 1) {
+  if (producers == 0) {
+    loop.Post([&chains, n]() {
+      for (int i = 0; i < std::min(n, PostChains::kChains); ++i) {
+        chains.post();
+      }
+    });
+  } else if (producers == 1) {
     // Single producer: tight loop
     for (int i = 0; i < n; ++i) {
       loop.Post(callback);
@@ -89,54 +134,76 @@ static PostsBenchResult bench_posts(int n, int producers) {
 
   done_future.wait();
   auto end = steady_clock::now();
+  uint64_t system_allocs = pool.systemAllocations() - system_start;
 
+  result.wakeups = loop.WakeupCount();
   loop.Stop();
+  pool.setThreadCacheLimit(prev_limit);
 
   result.wall_ms = duration<double, std::milli>(end - start).count();
   result.posts_per_sec = static_cast<double>(n) / (result.wall_ms / 1000.0);
+  result.system_allocs_per_post = static_cast<double>(system_allocs) / n;
   result.rss_end_kb = get_current_rss_kb();
 
   return result;
 }
 
 // =============================================================================
-// Mode B: timers - Raw uv_timer_t throughput (actual timer scheduling)
+// Mode B: timers - uv_timer_t per deadline vs TimerWheel
 // =============================================================================
 
 struct TimersBenchResult {
+  std::string approach;  // "uv_timer" or "timer_wheel"
   int total_timers = 0;
   int timeout_ms = 0;
   double wall_ms = 0.0;
   double timers_per_sec = 0.0;
   LatencyStats latency;
+  // Arm n far-off deadlines, then cancel them all - the common case for
+  // node deadlines, which rarely fire
+  double arm_cancel_ns = 0.0;
+  uint64_t wheel_ticks = 0;  // timer_wheel: tick callbacks during the fire pass
   int64_t rss_start_kb = 0;
   int64_t rss_end_kb = 0;
 };
 
-// State for raw timer benchmark - uses actual uv_timer_t scheduling
-struct TimerBenchState {
+// Shared by every timer of one fire pass
+struct TimerBenchShared {
   std::vector<double>* latencies;
   std::mutex* latencies_mutex;
   std::atomic<int>* completed;
   std::promise<void>* done;
   int total;
+};
+
+// State for one timer - uses actual uv_timer_t scheduling or a wheel entry
+struct TimerBenchState {
+  TimerBenchState(TimerBenchShared* s, steady_clock::time_point start)
+      : shared(s), start_time(start) {}
+
+  TimerBenchShared* shared;
   steady_clock::time_point start_time;
+  TimerWheel::Entry entry;  // timer_wheel only
 };
 
-static void OnTimerBenchCallback(uv_timer_t* t) {
+static void RecordTimerFired(TimerBenchState* state) {
   auto end = steady_clock::now();
-  auto* state = static_cast<TimerBenchState*>(t->data);
+  auto* shared = state->shared;
 
   double latency_us = duration<double, std::micro>(end - state->start_time).count();
   {
-    std::lock_guard<std::mutex> lock(*state->latencies_mutex);
-    state->latencies->push_back(latency_us);
+    std::lock_guard<std::mutex> lock(*shared->latencies_mutex);
+    shared->latencies->push_back(latency_us);
   }
 
-  int prev = state->completed->fetch_add(1);
-  if (prev == state->total - 1) {
-    state->done->set_value();
+  int prev = shared->completed->fetch_add(1);
+  if (prev == shared->total - 1) {
+    shared->done->set_value();
   }
+}
+
+static void OnTimerBenchCallback(uv_timer_t* t) {
+  RecordTimerFired(static_cast<TimerBenchState*>(t->data));
 
   // Clean up timer
   uv_timer_stop(t);
@@ -147,8 +214,47 @@ static void OnTimerBenchCallback(uv_timer_t* t) {
   });
 }
 
-static TimersBenchResult bench_timers(int n, int timeout_ms) {
+static void OnWheelBenchCallback(TimerWheel::Entry* e) {
+  auto* state = static_cast<TimerBenchState*>(e->data);
+  RecordTimerFired(state);
+  delete state;  // Entry already disarmed
+}
+
+// Cost of arming and cancelling n deadlines, on the loop thread
+static double bench_arm_cancel(EventLoop& loop, int n, bool wheel) {
+  constexpr uint64_t kFarMs = 60'000;
+  std::promise<double> result;
+  auto result_future = result.get_future();
+  loop.Post([&]() {
+    auto start = steady_clock::now();
+    if (wheel) {
+      auto entries = std::make_unique<TimerWheel::Entry[]>(n);
+      auto& timers = loop.Timers();
+      for (int i = 0; i < n; ++i) {
+        timers.schedule(entries[i], kFarMs, [](TimerWheel::Entry*) {});
+      }
+      for (int i = 0; i < n; ++i) {
+        entries[i].cancel();
+      }
+    } else {
+      std::vector<uv_timer_t*> timers(n);
+      for (int i = 0; i < n; ++i) {
+        timers[i] = NewPooledTimer();
+        uv_timer_init(loop.RawLoop(), timers[i]);
+        uv_timer_start(timers[i], [](uv_timer_t*) {}, kFarMs, 0);
+      }
+      for (int i = 0; i < n; ++i) {
+        ClosePooledTimer(timers[i]);
+      }
+    }
+    result.set_value(duration<double, std::nano>(steady_clock::now() - start).count() / n);
+  });
+  return result_future.get();
+}
+
+static TimersBenchResult bench_timers(int n, int timeout_ms, bool wheel) {
   TimersBenchResult result;
+  result.approach = wheel ? "timer_wheel" : "uv_timer";
   result.total_timers = n;
   result.timeout_ms = timeout_ms;
   result.rss_start_kb = get_current_rss_kb();
@@ -156,21 +262,33 @@ static TimersBenchResult bench_timers(int n, int timeout_ms) {
   EventLoop loop;
   loop.Start();
 
+  result.arm_cancel_ns = bench_arm_cancel(loop, n, wheel);
+
   std::vector<double> latencies;
   latencies.reserve(n);
   std::mutex latencies_mutex;
   std::atomic<int> completed{0};
   std::promise<void> done;
   auto done_future = done.get_future();
+  TimerBenchShared shared{&latencies, &latencies_mutex, &completed, &done, n};
+  uint64_t ticks_start = 0;
+  if (wheel) {
+    loop.Post([&]() { ticks_start = loop.Timers().ticks(); });
+  }
 
   auto start = steady_clock::now();
 
   // Schedule all timers via Post to loop thread
   for (int i = 0; i < n; ++i) {
-    bool posted = loop.Post([&loop, &latencies, &latencies_mutex, &completed, &done, n, timeout_ms]() {
+    bool posted = loop.Post([&loop, &shared, timeout_ms, wheel]() {
+      auto* state = new TimerBenchState(&shared, steady_clock::now());
+      if (wheel) {
+        state->entry.data = state;
+        loop.Timers().schedule(state->entry, static_cast<uint64_t>(timeout_ms),
+                               OnWheelBenchCallback);
+        return;
+      }
       auto* timer = new uv_timer_t;
-      auto* state = new TimerBenchState{
-          &latencies, &latencies_mutex, &completed, &done, n, steady_clock::now()};
       timer->data = state;
       uv_timer_init(loop.RawLoop(), timer);
       uv_timer_start(timer, OnTimerBenchCallback, static_cast<uint64_t>(timeout_ms), 0);
@@ -185,6 +303,13 @@ static TimersBenchResult bench_timers(int n, int timeout_ms) {
   done_future.wait();
   auto end = steady_clock::now();
 
+  if (wheel) {
+    std::promise<uint64_t> ticks;
+    auto ticks_future = ticks.get_future();
+    loop.Post([&]() { ticks.set_value(loop.Timers().ticks() - ticks_start); });
+    result.wheel_ticks = ticks_future.get();
+  }
+
   loop.Stop();
 
   result.wall_ms = duration<double, std::milli>(end - start).count();
@@ -331,6 +456,113 @@ static SleepVsPoolResult bench_sleep_vs_pool(int tasks_count, int sleep_ms) {
   return result;
 }
 
+// =============================================================================
+// Mode D: frames - allocations per async node, FramePool off vs on
+// =============================================================================
+
+struct FramesPassResult {
+  double wall_ms = 0.0;
+  double allocs_per_node = 0.0;         // Frames, states and timers
+  double system_allocs_per_node = 0.0;  // Those that reached the allocator
+};
+
+struct FramesBenchResult {
+  int nodes = 0;
+  int workers = 0;
+  int sleep_ms = 0;
+  FramesPassResult unpooled;  // thread cache limit 0
+  FramesPassResult pooled;    // default thread cache limit
+};
+
+// Same coroutine shape as an IO node under the async scheduler:
+// run_node_async -> run_task -> AsyncWithTimeout(runner) -> run_async -> sleep
+static Task<int> frames_run_async(EventLoop& loop, int sleep_ms) {
+  co_await SleepMs(loop, sleep_ms);
+  co_return 1;
+}
+
+static Task<int> frames_run_task(EventLoop& loop, int sleep_ms) {
+  auto deadline = steady_clock::now() + seconds(10);
+  co_return co_await AsyncWithTimeout(loop, deadline, frames_run_async(loop, sleep_ms));
+}
+
+static Task<int> frames_run_node(EventLoop& loop, int sleep_ms) {
+  co_return co_await frames_run_task(loop, sleep_ms);
+}
+
+// Runs `nodes` nodes back to back, so each reuses the blocks the last freed
+static Task<void> frames_worker(EventLoop& loop, int nodes, int sleep_ms,
+                                std::atomic<int>& completed, std::promise<void>& done,
+                                int total_workers) {
+  for (int i = 0; i < nodes; ++i) {
+    co_await frames_run_node(loop, sleep_ms);
+  }
+  if (completed.fetch_add(1) == total_workers - 1) {
+    done.set_value();
+  }
+}
+
+static FramesPassResult bench_frames_pass(int workers, int nodes_per_worker, int sleep_ms,
+                                          size_t cache_limit) {
+  FramesPassResult result;
+  auto& pool = FramePool::instance();
+  size_t prev_limit = pool.threadCacheLimit();
+  pool.setThreadCacheLimit(cache_limit);
+
+  EventLoop loop;
+  loop.Start();
+
+  std::vector<Task<void>> tasks;
+  tasks.reserve(workers);
+  std::atomic<int> completed{0};
+  std::promise<void> done;
+  auto done_future = done.get_future();
+
+  uint64_t allocs_start = pool.allocations();
+  uint64_t system_start = pool.systemAllocations();
+  auto start = steady_clock::now();
+
+  // Frames are created (and freed) on the loop thread, as in the scheduler
+  if (!loop.Post([&]() {
+        for (int i = 0; i < workers; ++i) {
+          tasks.push_back(
+              frames_worker(loop, nodes_per_worker, sleep_ms, completed, done, workers));
+          tasks.back().start();
+        }
+      })) {
+    std::cerr << "Error: loop.Post() failed in frames benchmark" << std::endl;
+    pool.setThreadCacheLimit(prev_limit);
+    return result;
+  }
+
+  done_future.wait();
+  auto end = steady_clock::now();
+  uint64_t allocs = pool.allocations() - allocs_start;
+  uint64_t system_allocs = pool.systemAllocations() - system_start;
+
+  loop.Stop();
+  pool.setThreadCacheLimit(prev_limit);
+
+  double nodes = static_cast<double>(workers) * nodes_per_worker;
+  result.wall_ms = duration<double, std::milli>(end - start).count();
+  result.allocs_per_node = static_cast<double>(allocs) / nodes;
+  result.system_allocs_per_node = static_cast<double>(system_allocs) / nodes;
+  return result;
+}
+
+static FramesBenchResult bench_frames(int n, int workers, int sleep_ms) {
+  FramesBenchResult result;
+  result.workers = std::max(1, std::min(workers, n));
+  int nodes_per_worker = std::max(1, n / result.workers);
+  result.nodes = nodes_per_worker * result.workers;
+  result.sleep_ms = sleep_ms;
+
+  result.unpooled = bench_frames_pass(result.workers, nodes_per_worker, sleep_ms, 0);
+  result.pooled = bench_frames_pass(result.workers, nodes_per_worker, sleep_ms,
+                                    FramePool::kDefaultThreadCacheBlocks);
+  return result;
+}
+
 // =============================================================================
 // Output formatting
 // =============================================================================
@@ -346,7 +578,13 @@ static void format_throughput(std::ostream& os, double value) {
 }
 
 static void print_posts_human(const PostsBenchResult& r) {
-  std::cout << "=== EventLoop Benchmark: posts ===" << std::endl;
+  std::cout << "=== EventLoop Benchmark: posts (";
+  if (r.producers == 0) {
+    std::cout << "loop thread, pool " << (r.pooled ? "on" : "off");
+  } else {
+    std::cout << r.producers << " producers";
+  }
+  std::cout << ") ===" << std::endl;
   std::cout << "  Total posts:     " << r.total_posts << std::endl;
   std::cout << "  Producers:       " << r.producers << std::endl;
   std::cout << "  Wall time:       " << std::fixed << std::setprecision(1) << r.wall_ms << " ms"
@@ -354,13 +592,19 @@ static void print_posts_human(const PostsBenchResult& r) {
   std::cout << "  Throughput:      ";
   format_throughput(std::cout, r.posts_per_sec);
   std::cout << " posts/sec" << std::endl;
+  std::cout << "  Wakeups:         " << r.wakeups << " (" << std::fixed << std::setprecision(1)
+            << (r.wakeups > 0 ? static_cast<double>(r.total_posts) / r.wakeups : 0.0)
+            << " posts/wakeup)" << std::endl;
+  std::cout << "  System allocs:   " << std::fixed << std::setprecision(2)
+            << r.system_allocs_per_post << " per post" << std::endl;
   std::cout << "  RSS start/end:   " << std::fixed << std::setprecision(1)
             << (r.rss_start_kb / 1024.0) << " / " << (r.rss_end_kb / 1024.0) << " MB" << std::endl;
   std::cout << std::endl;
 }
 
 static void print_timers_human(const TimersBenchResult& r) {
-  std::cout << "=== EventLoop Benchmark: timers (uv_timer " << r.timeout_ms << "ms) ===" << std::endl;
+  std::cout << "=== EventLoop Benchmark: timers (" << r.approach << " " << r.timeout_ms
+            << "ms) ===" << std::endl;
   std::cout << "  Total timers:    " << r.total_timers << std::endl;
   std::cout << "  Timeout:         " << r.timeout_ms << " ms" << std::endl;
   std::cout << "  Wall time:       " << std::fixed << std::setprecision(1) << r.wall_ms << " ms"
@@ -372,6 +616,11 @@ static void print_timers_human(const TimersBenchResult& r) {
             << "/" << r.latency.p90_us << "/" << r.latency.p99_us << " us" << std::endl;
   std::cout << "  Latency max/mean:    " << std::fixed << std::setprecision(0) << r.latency.max_us
             << "/" << r.latency.mean_us << " us" << std::endl;
+  std::cout << "  Arm + cancel:    " << std::fixed << std::setprecision(1) << r.arm_cancel_ns
+            << " ns/timer" << std::endl;
+  if (r.approach == "timer_wheel") {
+    std::cout << "  Wheel ticks:     " << r.wheel_ticks << std::endl;
+  }
   std::cout << "  RSS start/end:   " << std::fixed << std::setprecision(1)
             << (r.rss_start_kb / 1024.0) << " / " << (r.rss_end_kb / 1024.0) << " MB" << std::endl;
   std::cout << std::endl;
@@ -406,6 +655,20 @@ static void print_sleep_vs_pool_human(const SleepVsPoolResult& r) {
   std::cout << std::endl;
 }
 
+static void print_frames_pass(const char* label, const FramesPassResult& r) {
+  std::cout << "  " << label << std::fixed << std::setprecision(1) << r.wall_ms << " ms, "
+            << std::setprecision(2) << r.allocs_per_node << " allocs/node, "
+            << r.system_allocs_per_node << " from the system allocator" << std::endl;
+}
+
+static void print_frames_human(const FramesBenchResult& r) {
+  std::cout << "=== EventLoop Benchmark: frames (" << r.nodes << " IO nodes, " << r.workers
+            << " concurrent, sleep " << r.sleep_ms << "ms) ===" << std::endl;
+  print_frames_pass("Pool off: ", r.unpooled);
+  print_frames_pass("Pool on:  ", r.pooled);
+  std::cout << std::endl;
+}
+
 static json latency_to_json(const LatencyStats& l) {
   json j;
   j["min_us"] = l.min_us;
@@ -422,8 +685,11 @@ static json posts_to_json(const PostsBenchResult& r) {
   json j;
   j["total_posts"] = r.total_posts;
   j["producers"] = r.producers;
+  j["pooled"] = r.pooled;
   j["wall_ms"] = r.wall_ms;
   j["posts_per_sec"] = r.posts_per_sec;
+  j["wakeups"] = r.wakeups;
+  j["system_allocs_per_post"] = r.system_allocs_per_post;
   j["rss_start_kb"] = r.rss_start_kb;
   j["rss_end_kb"] = r.rss_end_kb;
   return j;
@@ -431,11 +697,16 @@ static json posts_to_json(const PostsBenchResult& r) {
 
 static json timers_to_json(const TimersBenchResult& r) {
   json j;
+  j["approach"] = r.approach;
   j["total_timers"] = r.total_timers;
   j["timeout_ms"] = r.timeout_ms;
   j["wall_ms"] = r.wall_ms;
   j["timers_per_sec"] = r.timers_per_sec;
   j["latency"] = latency_to_json(r.latency);
+  j["arm_cancel_ns"] = r.arm_cancel_ns;
+  if (r.approach == "timer_wheel") {
+    j["wheel_ticks"] = r.wheel_ticks;
+  }
   j["rss_start_kb"] = r.rss_start_kb;
   j["rss_end_kb"] = r.rss_end_kb;
   return j;
@@ -455,6 +726,24 @@ static json sleep_vs_pool_to_json(const SleepVsPoolResult& r) {
   return j;
 }
 
+static json frames_pass_to_json(const FramesPassResult& r) {
+  json j;
+  j["wall_ms"] = r.wall_ms;
+  j["allocs_per_node"] = r.allocs_per_node;
+  j["system_allocs_per_node"] = r.system_allocs_per_node;
+  return j;
+}
+
+static json frames_to_json(const FramesBenchResult& r) {
+  json j;
+  j["nodes"] = r.nodes;
+  j["workers"] = r.workers;
+  j["sleep_ms"] = r.sleep_ms;
+  j["unpooled"] = frames_pass_to_json(r.unpooled);
+  j["pooled"] = frames_pass_to_json(r.pooled);
+  return j;
+}
+
 // =============================================================================
 // Main entry point
 // =============================================================================
@@ -463,11 +752,12 @@ int run_bench_eventloop(const BenchEventLoopConfig& config) {
   bool run_posts = (config.mode == "all" || config.mode == "posts");
   bool run_timers = (config.mode == "all" || config.mode == "timers");
   bool run_sleep = (config.mode == "all" || config.mode == "sleep_vs_pool");
+  bool run_frames = (config.mode == "all" || config.mode == "frames");
 
   // Validate mode
-  if (!run_posts && !run_timers && !run_sleep) {
+  if (!run_posts && !run_timers && !run_sleep && !run_frames) {
     std::cerr << "Error: invalid bench_eventloop_mode '" << config.mode << "'" << std::endl;
-    std::cerr << "Valid modes: posts, timers, sleep_vs_pool, all" << std::endl;
+    std::cerr << "Valid modes: posts, timers, sleep_vs_pool, frames, all" << std::endl;
     return 1;
   }
 
@@ -480,16 +770,38 @@ int run_bench_eventloop(const BenchEventLoopConfig& config) {
       n = 1000000;  // 1M posts - same for all producer counts for fair comparison
     }
 
-    auto result = bench_posts(n, config.producers);
-
+    // Sweep 1, 2, 4, ... producers up to config.producers
+    std::vector<int> producer_counts;
+    for (int p = 1; p < config.producers; p *= 2) {
+      producer_counts.push_back(p);
+    }
+    producer_counts.push_back(config.producers);
+
+    json posts_json = json::array();
+    // Loop-thread posts with FramePool off (every PostNode from the system
+    // allocator) and on
+    for (bool pooled : {false, true}) {
+      auto result = bench_posts(n, 0, pooled);
+      if (config.json_output) {
+        posts_json.push_back(posts_to_json(result));
+      } else {
+        print_posts_human(result);
+      }
+    }
+    for (int producers : producer_counts) {
+      auto result = bench_posts(n, producers);
+      if (config.json_output) {
+        posts_json.push_back(posts_to_json(result));
+      } else {
+        print_posts_human(result);
+      }
+    }
     if (config.json_output) {
-      json_output["posts"] = posts_to_json(result);
-    } else {
-      print_posts_human(result);
+      json_output["posts"] = std::move(posts_json);
     }
   }
 
-  // Mode B: timers (raw uv_timer_t scheduling)
+  // Mode B: timers (uv_timer_t per deadline vs the loop's TimerWheel)
   if (run_timers) {
     int n = config.n;
     if (n == 0) {
@@ -497,12 +809,17 @@ int run_bench_eventloop(const BenchEventLoopConfig& config) {
     }
 
     // Use config.sleep_ms for timer timeout (default 0 = immediate fire)
-    auto result = bench_timers(n, config.sleep_ms);
-
+    json timers_json = json::array();
+    for (bool wheel : {false, true}) {
+      auto result = bench_timers(n, config.sleep_ms, wheel);
+      if (config.json_output) {
+        timers_json.push_back(timers_to_json(result));
+      } else {
+        print_timers_human(result);
+      }
+    }
     if (config.json_output) {
-      json_output["timers"] = timers_to_json(result);
-    } else {
-      print_timers_human(result);
+      json_output["timers"] = std::move(timers_json);
     }
   }
 
@@ -517,6 +834,21 @@ int run_bench_eventloop(const BenchEventLoopConfig& config) {
     }
   }
 
+  // Mode D: frames
+  if (run_frames) {
+    int n = config.n;
+    if (n == 0) {
+      n = 20000;
+    }
+    auto result = bench_frames(n, config.tasks, config.sleep_ms);
+
+    if (config.json_output) {
+      json_output["frames"] = frames_to_json(result);
+    } else {
+      print_frames_human(result);
+    }
+  }
+
   if (config.json_output) {
     std::cout << json_output.dump(2) << std::endl;
   }
@@ -0,0 +1,132 @@
+#include "column_buffer_pool.h"
+
+#include <bit>
+#include <new>
+
+namespace rankd {
+
+// Per-thread free lists: up to kThreadCacheBuffersPerClass buffers per class.
+// Retained bytes already account for these buffers.
+struct ColumnBufferPool::ThreadCache {
+  std::array<std::array<void *, kThreadCacheBuffersPerClass>, kNumClasses> buffers{};
+  std::array<size_t, kNumClasses> counts{};
+
+  ~ThreadCache() {
+    // Thread exit: hand cached buffers to the shared lists
+    auto &pool = ColumnBufferPool::instance();
+    std::lock_guard<std::mutex> lock(pool.mu_);
+    for (size_t i = 0; i < kNumClasses; ++i) {
+      for (size_t j = 0; j < counts[i]; ++j) {
+        pool.shared_[i].push_back(buffers[i][j]);
+      }
+      counts[i] = 0;
+    }
+  }
+};
+
+ColumnBufferPool &ColumnBufferPool::instance() {
+  // Leaked on purpose: thread caches flush into it during thread exit
+  static ColumnBufferPool *pool = new ColumnBufferPool();
+  return *pool;
+}
+
+ColumnBufferPool::ThreadCache &ColumnBufferPool::threadCache() {
+  thread_local ThreadCache cache;
+  return cache;
+}
+
+size_t ColumnBufferPool::classIndex(size_t bytes, size_t alignment) {
+  if (bytes < (size_t{1} << kMinClassShift) ||
+      bytes > (size_t{1} << kMaxClassShift) || alignment > kMaxAlignment) {
+    return kNumClasses;
+  }
+  size_t shift = std::bit_width(bytes - 1); // ceil(log2(bytes))
+  return shift - kMinClassShift;
+}
+
+void ColumnBufferPool::freeBuffer(size_t index, void *p) {
+  ::operator delete(p, classBytes(index), std::align_val_t{kMaxAlignment});
+}
+
+void *ColumnBufferPool::do_allocate(size_t bytes, size_t alignment) {
+  size_t index = classIndex(bytes, alignment);
+  if (index == kNumClasses) {
+    return ::operator new(bytes, std::align_val_t{alignment});
+  }
+
+  void *p = nullptr;
+  ThreadCache &cache = threadCache();
+  if (cache.counts[index] > 0) {
+    p = cache.buffers[index][--cache.counts[index]];
+  } else {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto &list = shared_[index];
+    if (!list.empty()) {
+      p = list.back();
+      list.pop_back();
+    }
+  }
+
+  if (p) {
+    retained_bytes_.fetch_sub(classBytes(index), std::memory_order_relaxed);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return p;
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return ::operator new(classBytes(index), std::align_val_t{kMaxAlignment});
+}
+
+void ColumnBufferPool::do_deallocate(void *p, size_t bytes, size_t alignment) {
+  size_t index = classIndex(bytes, alignment);
+  if (index == kNumClasses) {
+    ::operator delete(p, bytes, std::align_val_t{alignment});
+    return;
+  }
+  release(index, p, &threadCache());
+}
+
+void ColumnBufferPool::release(size_t index, void *p, ThreadCache *cache) {
+  // Reserve retain budget; over the cap the buffer goes back to the system
+  size_t size = classBytes(index);
+  size_t limit = retainLimit();
+  size_t cur = retained_bytes_.load(std::memory_order_relaxed);
+  do {
+    if (cur + size > limit) {
+      freeBuffer(index, p);
+      return;
+    }
+  } while (!retained_bytes_.compare_exchange_weak(cur, cur + size,
+                                                  std::memory_order_relaxed));
+
+  if (cache && cache->counts[index] < kThreadCacheBuffersPerClass) {
+    cache->buffers[index][cache->counts[index]++] = p;
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mu_);
+  shared_[index].push_back(p);
+}
+
+void ColumnBufferPool::trim() {
+  ThreadCache &cache = threadCache();
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    for (size_t j = 0; j < cache.counts[i]; ++j) {
+      freeBuffer(i, cache.buffers[i][j]);
+      retained_bytes_.fetch_sub(classBytes(i), std::memory_order_relaxed);
+    }
+    cache.counts[i] = 0;
+  }
+
+  std::array<std::vector<void *>, kNumClasses> shared;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    shared.swap(shared_);
+  }
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    for (void *p : shared[i]) {
+      freeBuffer(i, p);
+      retained_bytes_.fetch_sub(classBytes(i), std::memory_order_relaxed);
+    }
+  }
+}
+
+} // namespace rankd
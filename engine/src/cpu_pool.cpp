@@ -6,17 +6,17 @@
 namespace rankd {
 
 namespace {
-std::unique_ptr<ThreadPool> g_cpu_pool;
+std::unique_ptr<WorkStealingPool> g_cpu_pool;
 }  // namespace
 
 void InitCPUThreadPool(size_t num_threads) {
   if (g_cpu_pool) {
     throw std::runtime_error("CPU thread pool already initialized");
   }
-  g_cpu_pool = std::make_unique<ThreadPool>(num_threads);
+  g_cpu_pool = std::make_unique<WorkStealingPool>(num_threads);
 }
 
-ThreadPool& GetCPUThreadPool() {
+WorkStealingPool& GetCPUThreadPool() {
   if (!g_cpu_pool) {
     throw std::runtime_error("CPU thread pool not initialized. Call InitCPUThreadPool() first.");
   }
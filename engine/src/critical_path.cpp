@@ -0,0 +1,128 @@
+#include "critical_path.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace rankd {
+
+NodeCostModel &NodeCostModel::instance() {
+  // Leaked on purpose: late-completing nodes may still record during exit
+  static NodeCostModel *model = new NodeCostModel();
+  return *model;
+}
+
+double NodeCostModel::estimateUs(const Plan &plan, const Node &node,
+                                 const TaskSpec &spec) const {
+  const NodeCostSlot *slot =
+      node.cost_slot != nullptr ? node.cost_slot : findSlot(plan, node);
+  if (slot != nullptr) {
+    double ewma_us = slot->ewma_us.load(std::memory_order_relaxed);
+    if (ewma_us != NodeCostSlot::kNoHistory) {
+      return ewma_us;
+    }
+  }
+  if (spec.estimate_cost_us) {
+    return std::max(0.0, spec.estimate_cost_us(node.params));
+  }
+  return spec.is_io ? kDefaultIoCostUs : kDefaultCpuCostUs;
+}
+
+void NodeCostModel::record(const Plan &plan, const Node &node,
+                           double elapsed_us) {
+  if (!enabled()) {
+    return;
+  }
+  NodeCostSlot *slot =
+      node.cost_slot != nullptr ? node.cost_slot : this->slot(plan, node);
+  if (slot == nullptr) {
+    return;
+  }
+  // Concurrent samples for one node (parallel requests) retry; each one is
+  // folded in exactly once
+  double ewma_us = slot->ewma_us.load(std::memory_order_relaxed);
+  double next_us;
+  do {
+    next_us = ewma_us == NodeCostSlot::kNoHistory
+                  ? elapsed_us
+                  : ewma_us + kEwmaAlpha * (elapsed_us - ewma_us);
+  } while (!slot->ewma_us.compare_exchange_weak(ewma_us, next_us,
+                                                std::memory_order_relaxed));
+}
+
+NodeCostSlot *NodeCostModel::slot(const Plan &plan, const Node &node) {
+  std::string key = historyKey(plan, node);
+  {
+    std::shared_lock<std::shared_mutex> lock(mu_);
+    auto it = slots_.find(key);
+    if (it != slots_.end()) {
+      return it->second.get();
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mu_);
+  auto it = slots_.find(key);
+  if (it == slots_.end()) {
+    if (slots_.size() >= kMaxHistoryEntries) {
+      return nullptr;
+    }
+    it = slots_.emplace(std::move(key), std::make_unique<NodeCostSlot>()).first;
+  }
+  return it->second.get();
+}
+
+const NodeCostSlot *NodeCostModel::findSlot(const Plan &plan,
+                                            const Node &node) const {
+  std::shared_lock<std::shared_mutex> lock(mu_);
+  auto it = slots_.find(historyKey(plan, node));
+  return it != slots_.end() ? it->second.get() : nullptr;
+}
+
+void NodeCostModel::clear() {
+  std::shared_lock<std::shared_mutex> lock(mu_);
+  for (auto &[key, slot] : slots_) {
+    slot->ewma_us.store(NodeCostSlot::kNoHistory, std::memory_order_relaxed);
+  }
+}
+
+size_t NodeCostModel::size() const {
+  std::shared_lock<std::shared_mutex> lock(mu_);
+  return static_cast<size_t>(
+      std::count_if(slots_.begin(), slots_.end(), [](const auto &entry) {
+        return entry.second->ewma_us.load(std::memory_order_relaxed) !=
+               NodeCostSlot::kNoHistory;
+      }));
+}
+
+std::vector<double>
+compute_critical_path(const std::vector<double> &cost,
+                      const std::vector<std::vector<size_t>> &successors,
+                      const std::vector<size_t> &topo_order) {
+  std::vector<double> priority(cost.size(), 0.0);
+  // Children before parents
+  for (auto it = topo_order.rbegin(); it != topo_order.rend(); ++it) {
+    size_t idx = *it;
+    double longest_tail = 0.0;
+    for (size_t succ : successors[idx]) {
+      longest_tail = std::max(longest_tail, priority[succ]);
+    }
+    priority[idx] = cost[idx] + longest_tail;
+  }
+  return priority;
+}
+
+std::vector<double>
+plan_critical_path(const Plan &plan, const TaskRegistry &registry,
+                   const std::vector<std::vector<size_t>> &successors,
+                   const std::vector<size_t> &topo_order) {
+  const auto &model = NodeCostModel::instance();
+  if (!model.enabled()) {
+    return {};
+  }
+  std::vector<double> cost(plan.nodes.size());
+  for (size_t i = 0; i < plan.nodes.size(); ++i) {
+    const auto &node = plan.nodes[i];
+    cost[i] = model.estimateUs(plan, node, registry.get_spec(node.op));
+  }
+  return compute_critical_path(cost, successors, topo_order);
+}
+
+} // namespace rankd
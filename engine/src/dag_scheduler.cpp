@@ -1,6 +1,8 @@
 #include "dag_scheduler.h"
 
 #include "cpu_pool.h"
+#include "critical_path.h"
+#include "node_results.h"
 #include "output_contract.h"
 #include "pred_eval.h"  // For clearRegexCache
 #include "schema_delta.h"
@@ -9,6 +11,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
@@ -31,13 +34,15 @@ struct SchedulerState {
 
   // Mutable state (protected by mutex)
   std::unique_ptr<std::atomic<int>[]> deps_remaining;    // countdown to 0
-  std::vector<std::optional<RowSet>> results;            // output per node
+  NodeResults results;                                   // output per node, freed after last consumer
   std::vector<std::optional<NodeSchemaDelta>> schema_deltas;  // per node
+  std::unique_ptr<NodeIoStats[]> io_stats;               // per node
   size_t num_nodes = 0;
+  bool full_validation = true;                           // OutputValidation level for this request
 
   std::mutex mutex;
   std::condition_variable cv;
-  std::queue<size_t> ready_queue;                        // nodes ready to run
+  ReadyQueue ready_queue;                                // nodes ready to run, critical path first
   std::atomic<int> inflight{0};                          // currently running
   std::optional<std::string> first_error;                // fail-fast
 
@@ -50,6 +55,7 @@ struct SchedulerState {
 void init_scheduler_state(SchedulerState& state) {
   size_t n = state.plan.nodes.size();
   state.num_nodes = n;
+  state.full_validation = OutputValidation::instance().beginRequest();
 
   // Build node_id -> index map
   for (size_t i = 0; i < n; ++i) {
@@ -62,8 +68,9 @@ void init_scheduler_state(SchedulerState& state) {
     state.deps_remaining[i].store(0, std::memory_order_relaxed);
   }
   state.successors.resize(n);
-  state.results.resize(n);
+  state.results.reset(n);
   state.schema_deltas.resize(n);
+  state.io_stats = std::make_unique<NodeIoStats[]>(n);
 
   // Compute indegrees and build successor edges
   // Dependencies = inputs + NodeRef params
@@ -89,8 +96,12 @@ void init_scheduler_state(SchedulerState& state) {
     for (const auto& dep_id : deps) {
       size_t parent_idx = state.node_index.at(dep_id);
       state.successors[parent_idx].push_back(i);
+      state.results.addEdge(parent_idx, i);
     }
   }
+  for (const auto& out_id : state.plan.outputs) {
+    state.results.addOutput(state.node_index.at(out_id));
+  }
 
   // Compute topo order (for deterministic schema_deltas output)
   // Using Kahn's algorithm
@@ -118,6 +129,11 @@ void init_scheduler_state(SchedulerState& state) {
     }
   }
 
+  // Rank ready nodes by longest remaining path so that, when more nodes are
+  // ready than max_nodes_inflight, the critical path is dispatched first
+  state.ready_queue.setPriorities(
+      plan_critical_path(state.plan, state.registry, state.successors, state.topo_order));
+
   // Push nodes with indegree 0 to ready_queue
   for (size_t i = 0; i < n; ++i) {
     if (state.deps_remaining[i].load(std::memory_order_relaxed) == 0) {
@@ -139,7 +155,7 @@ void run_node_job(SchedulerState& state, size_t node_idx) {
     for (const auto& parent_id : node.inputs) {
       size_t parent_idx = state.node_index.at(parent_id);
       // Parent is guaranteed complete (deps_remaining was 0)
-      inputs.push_back(*state.results[parent_idx]);
+      inputs.push_back(state.results.get(parent_idx));
     }
 
     // 2. Validate params
@@ -149,15 +165,22 @@ void run_node_job(SchedulerState& state, size_t node_idx) {
     std::unordered_map<std::string, RowSet> resolved_refs;
     for (const auto& [param_name, ref_node_id] : validated.node_ref_params) {
       size_t ref_idx = state.node_index.at(ref_node_id);
-      resolved_refs.emplace(param_name, *state.results[ref_idx]);
+      resolved_refs.emplace(param_name, state.results.get(ref_idx));
     }
 
     // 4. Build execution context for this node
     ExecCtx ctx = state.base_ctx;
     ctx.resolved_node_refs = resolved_refs.empty() ? nullptr : &resolved_refs;
+    ctx.live_keys = node.live_keys;
+    ctx.io_stats = &state.io_stats[node_idx];
 
     // 5. Execute the task
+    auto start_time = std::chrono::steady_clock::now();
     RowSet output = state.registry.execute(node.op, inputs, validated, ctx);
+    NodeCostModel::instance().record(
+        state.plan, node,
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time)
+            .count());
 
     // 6. Validate output contract
     const auto& spec = state.registry.get_spec(node.op);
@@ -166,7 +189,7 @@ void run_node_job(SchedulerState& state, size_t node_idx) {
       contract_inputs.push_back(resolved_refs.at("rhs"));
     }
     validateTaskOutput(node.node_id, node.op, spec.output_pattern, contract_inputs,
-                       validated, output);
+                       validated, output, state.full_validation);
 
     // 7. Compute schema delta
     NodeSchemaDelta node_delta;
@@ -183,7 +206,8 @@ void run_node_job(SchedulerState& state, size_t node_idx) {
     {
       std::lock_guard<std::mutex> lock(state.mutex);
 
-      state.results[node_idx] = std::move(output);
+      // Releases parents with no consumers left
+      state.results.complete(node_idx, std::move(output));
       state.schema_deltas[node_idx] = std::move(node_delta);
 
       // Decrement deps for each successor
@@ -243,8 +267,7 @@ ExecutionResult execute_plan_parallel(
     // Dispatch ready nodes up to max_nodes_inflight
     while (!state.ready_queue.empty() &&
            state.inflight.load(std::memory_order_acquire) < state.max_nodes_inflight) {
-      size_t node_idx = state.ready_queue.front();
-      state.ready_queue.pop();
+      size_t node_idx = state.ready_queue.pop();
       state.inflight.fetch_add(1, std::memory_order_acq_rel);
 
       // Check if this is an IO task to dispatch to the appropriate pool
@@ -259,8 +282,8 @@ ExecutionResult execute_plan_parallel(
           run_node_job(state, node_idx);
         });
       } else {
-        // Dispatch compute tasks to CPU pool
-        cpu_pool.submit([&state, node_idx] {
+        // Dispatch compute tasks to CPU pool (fire-and-forget)
+        cpu_pool.post([&state, node_idx] {
           run_node_job(state, node_idx);
         });
       }
@@ -283,8 +306,9 @@ ExecutionResult execute_plan_parallel(
   // Collect outputs (copy instead of move to handle duplicate output IDs)
   for (const auto& out_id : plan.outputs) {
     size_t idx = state.node_index.at(out_id);
-    result.outputs.push_back(*state.results[idx]);
+    result.outputs.push_back(state.results.get(idx));
   }
+  result.peak_result_working_set_bytes = state.results.peakWorkingSetBytes();
 
   // Collect schema_deltas in topo order (deterministic)
   for (size_t idx : state.topo_order) {
@@ -293,6 +317,15 @@ ExecutionResult execute_plan_parallel(
     }
   }
 
+  // Collect IO trace in topo order (deterministic)
+  for (size_t idx : state.topo_order) {
+    const auto& node = plan.nodes[idx];
+    if (registry.get_spec(node.op).is_io) {
+      result.io_trace.push_back(
+          {node.node_id, state.io_stats[idx].bytes_received.load()});
+    }
+  }
+
   return result;
 }
 
@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <stdexcept>
+#include <thread>
 
 #include "uv_sleep.h"
 
@@ -46,7 +47,8 @@ void CloseWalkCallback(uv_handle_t* handle, void* arg) {
 }
 }  // namespace
 
-EventLoop::EventLoop() : exit_state_(std::make_shared<EventLoopExitState>()) {
+EventLoop::EventLoop()
+    : head_(&stub_), tail_(&stub_), exit_state_(std::make_shared<EventLoopExitState>()) {
   int r = uv_loop_init(&loop_);
   if (r != 0) {
     throw std::runtime_error("uv_loop_init failed: " + std::string(uv_strerror(r)));
@@ -76,6 +78,11 @@ EventLoop::~EventLoop() {
 
   // Always close the loop - uv_loop_init is called in constructor
   uv_loop_close(&loop_);
+
+  // DoStop drains the queue; free anything left if the loop never ran it
+  while (PostNode* node = Pop()) {
+    delete node;
+  }
 }
 
 void EventLoop::Start() {
@@ -179,12 +186,9 @@ void EventLoop::Stop() {
             loop_thread_.detach();
           }
         } else {
-          // Queue shutdown to loop thread
-          {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            queue_.push([this]() { DoStop(); });
-          }
-          uv_async_send(&async_);
+          // Queue shutdown to loop thread (Post() rejects once Stopping)
+          Push(new PostNode{{}, PostCallback([this]() { DoStop(); })});
+          Wake();
 
           if (loop_thread_.joinable()) {
             loop_thread_.join();
@@ -201,9 +205,23 @@ void EventLoop::Stop() {
   }
 }
 
+TimerWheel& EventLoop::Timers() {
+  assert(IsLoopThread());
+  if (!timers_) {
+    timers_ = std::make_unique<TimerWheel>(&loop_);
+  }
+  return *timers_;
+}
+
 void EventLoop::DoStop() {
+  // Wait out Post() calls that saw Running before the transition to
+  // Stopping; their callbacks were accepted and must run.
+  while (posters_.load() != 0) {
+    std::this_thread::yield();
+  }
+
   // Drain any pending callbacks
-  DrainQueue();
+  DrainQueue(/*all=*/true);
 
   // Close all pending handles
   uv_walk(&loop_, CloseWalkCallback, &async_);
@@ -218,37 +236,86 @@ void EventLoop::DoStop() {
   state_.store(State::Stopped);
 }
 
-bool EventLoop::Post(std::function<void()> fn) {
-  // Only accept posts in Running state
+bool EventLoop::Enqueue(PostNode* node) {
+  // posters_ and state_ are both seq_cst: either DoStop sees this poster
+  // and waits for it, or this poster sees Stopping and backs out.
+  posters_.fetch_add(1);
   if (state_.load() != State::Running) {
+    posters_.fetch_sub(1);
+    delete node;
     return false;
   }
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    // Re-check under lock to prevent race with Stop() draining queue
-    if (state_.load() != State::Running) {
-      return false;
+  Push(node);
+  // Signal before leaving so DoStop cannot close async_ under us
+  Wake();
+  posters_.fetch_sub(1);
+  return true;
+}
+
+void EventLoop::Push(PostNode* node) {
+  node->next.store(nullptr, std::memory_order_relaxed);
+  PostNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+  // Between the exchange and this store the consumer sees a gap and stops;
+  // our Wake() that follows brings it back.
+  prev->next.store(node, std::memory_order_release);
+}
+
+EventLoop::PostNode* EventLoop::Pop() {
+  PostNode* tail = tail_;
+  PostNode* next = tail->next.load(std::memory_order_acquire);
+  if (tail == &stub_) {
+    if (next == nullptr) {
+      return nullptr;
     }
-    queue_.push(std::move(fn));
+    tail_ = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next != nullptr) {
+    tail_ = next;
+    return tail;
+  }
+  if (tail != head_.load(std::memory_order_acquire)) {
+    return nullptr;  // A producer is mid-push
+  }
+  // tail is the last node: re-insert the stub so it can be handed out
+  Push(&stub_);
+  next = tail->next.load(std::memory_order_acquire);
+  if (next != nullptr) {
+    tail_ = next;
+    return tail;
+  }
+  return nullptr;
+}
+
+void EventLoop::Wake() {
+  if (!async_pending_.exchange(true, std::memory_order_acq_rel)) {
+    uv_async_send(&async_);
   }
-  uv_async_send(&async_);
-  return true;
 }
 
 void EventLoop::OnAsync(uv_async_t* handle) {
   auto* self = static_cast<EventLoop*>(handle->data);
+  self->wakeups_.fetch_add(1, std::memory_order_relaxed);
+  // Clear before draining: a push that lands after this either gets
+  // drained below or re-arms the wakeup.
+  self->async_pending_.exchange(false, std::memory_order_acq_rel);
   self->DrainQueue();
 }
 
-void EventLoop::DrainQueue() {
-  std::queue<std::function<void()>> local_queue;
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    std::swap(local_queue, queue_);
+void EventLoop::DrainQueue(bool all) {
+  for (int i = 0; all || i < kMaxDrainBatch; ++i) {
+    PostNode* node = Pop();
+    if (node == nullptr) {
+      return;
+    }
+    node->fn();
+    delete node;
   }
-  while (!local_queue.empty()) {
-    local_queue.front()();
-    local_queue.pop();
+  // Batch limit hit: continue on the next loop iteration (unless the last
+  // callback stopped the loop and closed async_)
+  if (state_.load() == State::Running) {
+    Wake();
   }
 }
 
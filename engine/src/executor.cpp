@@ -1,7 +1,10 @@
 #include "executor.h"
 #include "capability_registry.h"
+#include "critical_path.h"
 #include "dag_scheduler.h"
 #include "endpoint_registry.h"
+#include "node_results.h"
+#include <algorithm>
 #include <queue>
 #include <stdexcept>
 #include <unordered_map>
@@ -28,6 +31,100 @@ static EffectGamma build_param_bindings(const ValidatedParams &params) {
   return bindings;
 }
 
+// Compute node.live_keys: the keys descendants may read from each node's
+// output. Conservative: a consumer's own writes are not subtracted, and a node
+// whose columns reach a plan output has every key live (outputs emit all
+// columns). VariableDense consumers build fresh batches, so only their own
+// reads count against their inputs. Requires an acyclic plan with resolvable
+// inputs.
+static void compute_live_keys(Plan &plan,
+                              const std::unordered_map<std::string, size_t> &node_index) {
+  const auto &registry = TaskRegistry::instance();
+  size_t n = plan.nodes.size();
+
+  // Keys each node reads from its inputs, and its producers (inputs + NodeRefs)
+  std::vector<std::vector<uint32_t>> reads(n);
+  std::vector<std::vector<size_t>> producers(n);
+  std::vector<size_t> consumers_remaining(n, 0);
+  std::vector<uint8_t> forwards_columns(n, 1);
+  for (size_t i = 0; i < n; ++i) {
+    const auto &node = plan.nodes[i];
+    const auto &spec = registry.get_spec(node.op);
+    forwards_columns[i] = spec.output_pattern != OutputPattern::VariableDense;
+    for (KeyId k : spec.reads) {
+      reads[i].push_back(static_cast<uint32_t>(k));
+    }
+    std::vector<std::string> deps = node.inputs;
+    for (const auto &field : spec.params_schema) {
+      if (!node.params.contains(field.name)) {
+        continue;
+      }
+      const auto &value = node.params[field.name];
+      if (field.type == TaskParamType::ExprId && value.is_string()) {
+        auto it = plan.expr_table.find(value.get<std::string>());
+        if (it != plan.expr_table.end() && it->second) {
+          collect_key_refs(*it->second, reads[i]);
+        }
+      } else if (field.type == TaskParamType::PredId && value.is_string()) {
+        auto it = plan.pred_table.find(value.get<std::string>());
+        if (it != plan.pred_table.end() && it->second) {
+          collect_key_refs(*it->second, reads[i]);
+        }
+      } else if (field.type == TaskParamType::Int && field.reads_key &&
+                 value.is_number_integer() && value.get<int64_t>() > 0) {
+        reads[i].push_back(static_cast<uint32_t>(value.get<int64_t>()));
+      } else if (field.type == TaskParamType::NodeRef && value.is_string()) {
+        deps.push_back(value.get<std::string>());
+      }
+    }
+    for (const auto &dep : deps) {
+      size_t p = node_index.at(dep);
+      producers[i].push_back(p);
+      ++consumers_remaining[p];
+    }
+  }
+
+  std::vector<std::vector<uint32_t>> live(n);
+  std::vector<uint8_t> all_live(n, 0);
+  for (const auto &out : plan.outputs) {
+    all_live[node_index.at(out)] = 1;
+  }
+
+  // Reverse topological order: a node is final once all consumers are done
+  std::queue<size_t> ready;
+  for (size_t i = 0; i < n; ++i) {
+    if (consumers_remaining[i] == 0) {
+      ready.push(i);
+    }
+  }
+  while (!ready.empty()) {
+    size_t i = ready.front();
+    ready.pop();
+
+    auto &keys = live[i];
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    plan.nodes[i].live_keys =
+        all_live[i] ? nullptr
+                    : std::make_shared<const std::vector<uint32_t>>(keys);
+
+    for (size_t p : producers[i]) {
+      if (forwards_columns[i]) {
+        all_live[p] |= all_live[i];
+      }
+      if (!all_live[p]) {
+        live[p].insert(live[p].end(), reads[i].begin(), reads[i].end());
+        if (forwards_columns[i]) {
+          live[p].insert(live[p].end(), keys.begin(), keys.end());
+        }
+      }
+      if (--consumers_remaining[p] == 0) {
+        ready.push(p);
+      }
+    }
+  }
+}
+
 void validate_plan(Plan &plan, const EndpointRegistry *endpoints) {
   // Check schema_version
   if (plan.schema_version != 1) {
@@ -238,6 +335,13 @@ void validate_plan(Plan &plan, const EndpointRegistry *endpoints) {
   if (processed != plan.nodes.size()) {
     throw std::runtime_error("Plan contains a cycle");
   }
+
+  compute_live_keys(plan, node_index);
+
+  auto &cost_model = NodeCostModel::instance();
+  for (auto &node : plan.nodes) {
+    node.cost_slot = cost_model.slot(plan, node);
+  }
 }
 
 // Sequential execution (original implementation)
@@ -245,6 +349,7 @@ static ExecutionResult execute_plan_sequential(const Plan &plan, const ExecCtx &
   ExecutionResult result;
 
   const auto &registry = TaskRegistry::instance();
+  bool full_validation = OutputValidation::instance().beginRequest();
 
   // Build node_id -> index map
   std::unordered_map<std::string, size_t> node_index;
@@ -256,6 +361,8 @@ static ExecutionResult execute_plan_sequential(const Plan &plan, const ExecCtx &
   // Dependencies include both inputs and NodeRef params
   std::unordered_map<std::string, int> in_degree;
   std::unordered_map<std::string, std::vector<std::string>> successors;
+  // Node results, each freed once its last consumer has run
+  NodeResults results(plan.nodes.size());
 
   for (const auto &node : plan.nodes) {
     if (in_degree.find(node.node_id) == in_degree.end()) {
@@ -274,8 +381,12 @@ static ExecutionResult execute_plan_sequential(const Plan &plan, const ExecCtx &
     for (const auto &dep : deps) {
       successors[dep].push_back(node.node_id);
       in_degree[node.node_id]++;
+      results.addEdge(node_index.at(dep), node_index.at(node.node_id));
     }
   }
+  for (const auto &out : plan.outputs) {
+    results.addOutput(node_index.at(out));
+  }
 
   std::queue<std::string> ready;
   for (const auto &[id, deg] : in_degree) {
@@ -298,14 +409,12 @@ static ExecutionResult execute_plan_sequential(const Plan &plan, const ExecCtx &
   }
 
   // Execute in topological order
-  std::unordered_map<std::string, RowSet> results;
-
   for (const auto &node_id : topo_order) {
     const auto &node = plan.nodes[node_index[node_id]];
 
     std::vector<RowSet> inputs;
     for (const auto &inp : node.inputs) {
-      inputs.push_back(results.at(inp));
+      inputs.push_back(results.get(node_index.at(inp)));
     }
 
     auto validated_params = registry.validate_params(node.op, node.params);
@@ -313,17 +422,23 @@ static ExecutionResult execute_plan_sequential(const Plan &plan, const ExecCtx &
     // Resolve NodeRef params and build execution context
     std::unordered_map<std::string, RowSet> resolved_node_refs;
     for (const auto &[param_name, ref_node_id] : validated_params.node_ref_params) {
-      resolved_node_refs.emplace(param_name, results.at(ref_node_id));
+      resolved_node_refs.emplace(param_name, results.get(node_index.at(ref_node_id)));
     }
 
     // Create execution context with resolved NodeRefs
+    NodeIoStats io_stats;
     ExecCtx ctx = base_ctx;
     ctx.resolved_node_refs = resolved_node_refs.empty() ? nullptr : &resolved_node_refs;
+    ctx.live_keys = node.live_keys;
+    ctx.io_stats = &io_stats;
 
     RowSet output = registry.execute(node.op, inputs, validated_params, ctx);
 
     // Validate output against task's output contract
     const auto &spec = registry.get_spec(node.op);
+    if (spec.is_io) {
+      result.io_trace.push_back({node_id, io_stats.bytes_received.load()});
+    }
     // For ConcatDense, we need to provide the rhs RowSet as a virtual input
     std::vector<RowSet> contract_inputs = inputs;
     if (spec.output_pattern == OutputPattern::ConcatDense && !resolved_node_refs.empty()) {
@@ -331,7 +446,7 @@ static ExecutionResult execute_plan_sequential(const Plan &plan, const ExecCtx &
       contract_inputs.push_back(resolved_node_refs.at("rhs"));
     }
     validateTaskOutput(node_id, node.op, spec.output_pattern, contract_inputs,
-                       validated_params, output);
+                       validated_params, output, full_validation);
 
     // RFC0005: Compute schema delta for this node (runtime audit)
     // Use contract_inputs (which includes resolved NodeRefs) for schema delta
@@ -348,13 +463,14 @@ static ExecutionResult execute_plan_sequential(const Plan &plan, const ExecCtx &
       result.schema_deltas.push_back({node_id, delta});
     }
 
-    results.emplace(node_id, std::move(output));
+    results.complete(node_index.at(node_id), std::move(output));
   }
 
   // Collect outputs
   for (const auto &out : plan.outputs) {
-    result.outputs.push_back(results.at(out));
+    result.outputs.push_back(results.get(node_index.at(out)));
   }
+  result.peak_result_working_set_bytes = results.peakWorkingSetBytes();
 
   return result;
 }
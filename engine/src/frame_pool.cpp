@@ -0,0 +1,109 @@
+#include "frame_pool.h"
+
+#include <array>
+#include <bit>
+
+namespace ranking {
+
+namespace {
+
+// Set once the calling thread's cache has been destroyed (thread exit).
+// Trivially destructible, so it stays readable while later thread_local
+// destructors free their frames.
+thread_local bool t_cache_destroyed = false;
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+} // namespace
+
+// Per-thread intrusive free lists, one per size class
+struct FramePool::ThreadCache {
+  std::array<FreeBlock *, kNumClasses> heads{};
+  std::array<size_t, kNumClasses> counts{};
+
+  void release() {
+    for (size_t i = 0; i < kNumClasses; ++i) {
+      while (FreeBlock *block = heads[i]) {
+        heads[i] = block->next;
+        ::operator delete(block, classBytes(i));
+      }
+      counts[i] = 0;
+    }
+  }
+
+  ~ThreadCache() {
+    release();
+    t_cache_destroyed = true;
+  }
+};
+
+FramePool &FramePool::instance() {
+  // Leaked on purpose: frames may be freed during static destruction
+  static FramePool *pool = new FramePool();
+  return *pool;
+}
+
+FramePool::ThreadCache *FramePool::threadCache() {
+  if (t_cache_destroyed) {
+    return nullptr;
+  }
+  thread_local ThreadCache cache;
+  return &cache;
+}
+
+size_t FramePool::classIndex(size_t bytes) {
+  if (bytes > (size_t{1} << kMaxClassShift)) {
+    return kNumClasses;
+  }
+  if (bytes <= (size_t{1} << kMinClassShift)) {
+    return 0;
+  }
+  return std::bit_width(bytes - 1) - kMinClassShift; // ceil(log2(bytes))
+}
+
+void *FramePool::allocate(size_t bytes) {
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  size_t index = classIndex(bytes);
+  if (index == kNumClasses) {
+    system_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(bytes);
+  }
+
+  ThreadCache *cache = threadCache();
+  if (cache && cache->heads[index]) {
+    FreeBlock *block = cache->heads[index];
+    cache->heads[index] = block->next;
+    --cache->counts[index];
+    return block;
+  }
+  system_allocations_.fetch_add(1, std::memory_order_relaxed);
+  return ::operator new(classBytes(index));
+}
+
+void FramePool::deallocate(void *p, size_t bytes) noexcept {
+  size_t index = classIndex(bytes);
+  if (index == kNumClasses) {
+    ::operator delete(p, bytes);
+    return;
+  }
+
+  ThreadCache *cache = threadCache();
+  if (cache && cache->counts[index] < threadCacheLimit()) {
+    auto *block = static_cast<FreeBlock *>(p);
+    block->next = cache->heads[index];
+    cache->heads[index] = block;
+    ++cache->counts[index];
+    return;
+  }
+  ::operator delete(p, classBytes(index));
+}
+
+void FramePool::trim() {
+  if (ThreadCache *cache = threadCache()) {
+    cache->release();
+  }
+}
+
+} // namespace ranking
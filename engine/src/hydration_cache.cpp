@@ -0,0 +1,151 @@
+#include "hydration_cache.h"
+
+#include <mutex>
+
+namespace rankd {
+
+HydrationCache &HydrationCache::instance() {
+  // Leaked on purpose: late-completing tasks may still insert during exit
+  static HydrationCache *cache = new HydrationCache();
+  return *cache;
+}
+
+bool HydrationCache::lookupAt(const Key &key, Clock::time_point now,
+                              std::optional<std::string> &value) {
+  Shard &shard = shardFor(key);
+  std::shared_lock<std::shared_mutex> lock(shard.mu);
+  auto it = shard.map.find(key);
+  if (it == shard.map.end() || it->second.expires_at <= now) {
+    // Expired entries are replaced on the next insert or evicted first
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  const Entry &entry = it->second;
+  if (!entry.referenced.load(std::memory_order_relaxed)) {
+    entry.referenced.store(true, std::memory_order_relaxed);
+  }
+  value = entry.value;
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  if (!value) {
+    negative_hits_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+bool HydrationCache::lookup(std::string_view endpoint, int64_t id,
+                            uint32_t key_id,
+                            std::optional<std::string> &value) {
+  if (!enabled()) {
+    return false;
+  }
+  return lookupAt(Key{std::string(endpoint), id, key_id}, Clock::now(), value);
+}
+
+std::vector<size_t>
+HydrationCache::lookupMany(std::string_view endpoint,
+                           std::span<const int64_t> ids, uint32_t key_id,
+                           std::vector<std::optional<std::string>> &values) {
+  std::vector<size_t> missed;
+  if (!enabled()) {
+    missed.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+      missed.push_back(i);
+    }
+    return missed;
+  }
+
+  auto now = Clock::now();
+  Key key{std::string(endpoint), 0, key_id};
+  for (size_t i = 0; i < ids.size(); ++i) {
+    key.id = ids[i];
+    if (!lookupAt(key, now, values[i])) {
+      missed.push_back(i);
+    }
+  }
+  return missed;
+}
+
+void HydrationCache::eraseSlot(Shard &shard, size_t slot) {
+  shard.map.erase(shard.ring[slot]);
+  // Move the last ring entry into the hole
+  if (slot + 1 != shard.ring.size()) {
+    shard.ring[slot] = shard.ring.back();
+  }
+  shard.ring.pop_back();
+  if (shard.hand >= shard.ring.size()) {
+    shard.hand = 0;
+  }
+}
+
+void HydrationCache::evictOne(Shard &shard) {
+  auto now = Clock::now();
+  // Second chance: clear reference bits until an unreferenced entry comes up.
+  // Terminates within two sweeps.
+  while (true) {
+    Entry &entry = shard.map.find(shard.ring[shard.hand])->second;
+    if (entry.expires_at <= now) {
+      expirations_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+    if (!entry.referenced.exchange(false, std::memory_order_relaxed)) {
+      evictions_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+    shard.hand = (shard.hand + 1) % shard.ring.size();
+  }
+  eraseSlot(shard, shard.hand);
+}
+
+void HydrationCache::insert(std::string_view endpoint, int64_t id,
+                            uint32_t key_id,
+                            std::optional<std::string> value) {
+  if (!enabled()) {
+    return;
+  }
+  size_t shard_capacity = (capacity() + kNumShards - 1) / kNumShards;
+  auto expires_at = Clock::now() + ttl();
+
+  Key key{std::string(endpoint), id, key_id};
+  Shard &shard = shardFor(key);
+  std::unique_lock<std::shared_mutex> lock(shard.mu);
+
+  auto it = shard.map.find(key);
+  if (it != shard.map.end()) {
+    // Refresh in place (keeps its CLOCK slot)
+    if (it->second.expires_at <= Clock::now()) {
+      expirations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    it->second.value = std::move(value);
+    it->second.expires_at = expires_at;
+    return;
+  }
+
+  while (!shard.ring.empty() && shard.ring.size() >= shard_capacity) {
+    evictOne(shard);
+  }
+
+  auto [pos, inserted] = shard.map.try_emplace(key);
+  pos->second.value = std::move(value);
+  pos->second.expires_at = expires_at;
+  shard.ring.push_back(std::move(key));
+}
+
+void HydrationCache::clear() {
+  for (auto &shard : shards_) {
+    std::unique_lock<std::shared_mutex> lock(shard.mu);
+    shard.map.clear();
+    shard.ring.clear();
+    shard.hand = 0;
+  }
+}
+
+size_t HydrationCache::size() const {
+  size_t total = 0;
+  for (const auto &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock(shard.mu);
+    total += shard.map.size();
+  }
+  return total;
+}
+
+} // namespace rankd
@@ -3,12 +3,17 @@
 #include "endpoint_registry.h"
 #include "param_table.h"
 #include "redis_client.h"
+#include "redis_connection_pool.h"
 #include <stdexcept>
 
 namespace rankd {
 
-// Destructor - unique_ptrs clean up automatically
-IoClients::~IoClients() = default;
+IoClients::~IoClients() {
+  auto& pool = RedisConnectionPool::instance();
+  for (auto& [endpoint_id, redis] : redis_by_endpoint_) {
+    pool.checkin(redis.endpoint, std::move(redis.client));
+  }
+}
 
 RedisClient& IoClients::getRedis(const EndpointRegistry& endpoints,
                                   std::string_view endpoint_id) {
@@ -19,13 +24,13 @@ RedisClient& IoClients::getRedis(const EndpointRegistry& endpoints,
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = redis_by_endpoint_.find(endpoint_key);
     if (it != redis_by_endpoint_.end()) {
-      return *it->second;
+      return *it->second.client;
     }
   }
 
-  // Slow path: resolve endpoint and create client
-  // We hold the lock during creation for simplicity (MVP)
-  // Connection happens lazily on first Redis command anyway
+  // Slow path: resolve endpoint and check a client out of the pool
+  // We hold the lock during checkout for simplicity (MVP); a pooled client
+  // may be PINGed, a new one connects lazily on its first command
   const EndpointSpec* endpoint = endpoints.by_id(endpoint_key);
   if (!endpoint) {
     throw std::runtime_error(
@@ -38,18 +43,18 @@ RedisClient& IoClients::getRedis(const EndpointRegistry& endpoints,
         "IoClients::getRedis: endpoint '" + endpoint_key + "' is not a Redis endpoint");
   }
 
-  // Create client and cache it
+  // Check out a client and cache it
   std::lock_guard<std::mutex> lock(mutex_);
 
   // Double-check: another thread may have created it while we were outside the lock
   auto it = redis_by_endpoint_.find(endpoint_key);
   if (it != redis_by_endpoint_.end()) {
-    return *it->second;
+    return *it->second.client;
   }
 
-  auto client = std::make_unique<RedisClient>(*endpoint);
+  auto client = RedisConnectionPool::instance().checkout(*endpoint);
   auto& ref = *client;
-  redis_by_endpoint_[endpoint_key] = std::move(client);
+  redis_by_endpoint_[endpoint_key] = PooledRedis{*endpoint, std::move(client)};
 
   return ref;
 }
@@ -16,21 +16,29 @@
 
 #include "async_dag_scheduler.h"
 #include "async_io_clients.h"
+#include "bench_dag.h"
 #include "bench_event_loop.h"
 #include "capability_registry.h"
+#include "column_buffer_pool.h"
 #include "cpu_pool.h"
 #include "capability_registry_gen.h"
+#include "critical_path.h"
 #include "endpoint_registry.h"
 #include "event_loop.h"
 #include "executor.h"
 #include "feature_registry.h"
+#include "frame_pool.h"
+#include "hydration_cache.h"
 #include "io_clients.h"
 #include "key_registry.h"
+#include "output_contract.h"
 #include "param_registry.h"
 #include "param_table.h"
 #include "plan.h"
 #include "pred_eval.h"
+#include "redis_connection_pool.h"
 #include "request.h"
+#include "request_arena.h"
 #include "task_registry.h"
 #include "validation.h"
 
@@ -73,6 +81,16 @@ int main(int argc, char *argv[]) {
   int bench_iterations = 0;
   int bench_concurrency = 1;
   int cpu_threads = 8;
+  int buffer_pool_mb = static_cast<int>(
+      rankd::ColumnBufferPool::kDefaultRetainLimitBytes >> 20);
+  int frame_pool_blocks =
+      static_cast<int>(ranking::FramePool::kDefaultThreadCacheBlocks);
+  int hydration_cache_entries =
+      static_cast<int>(rankd::HydrationCache::kDefaultCapacity);
+  int hydration_cache_ttl_ms =
+      static_cast<int>(rankd::HydrationCache::kDefaultTtl.count());
+  int redis_pool_max_idle =
+      static_cast<int>(rankd::RedisConnectionPool::kDefaultMaxIdle);
   bool within_request_parallelism = false;
   bool async_scheduler = false;
   int deadline_ms = 0;
@@ -84,6 +102,16 @@ int main(int argc, char *argv[]) {
   int bench_sleep_ms = 1;
   int bench_tasks = 1000;
   bool bench_json = false;
+  bool bench_dag = false;
+  int bench_dag_width = 32;
+  int bench_dag_depth = 4;
+  int bench_dag_node_ms = 5;
+  int bench_dag_slots = 4;
+  std::string ready_queue_policy = "critical_path";
+  double inline_cost_us = rankd::NodeCostModel::kDefaultInlineThresholdUs;
+  std::string validation_level = "full";
+  int validation_sample_every =
+      static_cast<int>(rankd::OutputValidation::kDefaultSampleEvery);
 
   app.add_option("--plan", plan_path, "Path to plan JSON file");
   app.add_flag("--async_scheduler", async_scheduler,
@@ -116,6 +144,27 @@ int main(int argc, char *argv[]) {
   app.add_option("--cpu_threads", cpu_threads,
                  "Number of CPU pool threads (default: 8)")
       ->check(CLI::PositiveNumber);
+  app.add_option("--buffer_pool_mb", buffer_pool_mb,
+                 "Max MiB of freed column buffers kept for reuse across requests "
+                 "(default: 256, 0 = disabled)")
+      ->check(CLI::NonNegativeNumber);
+  app.add_option("--frame_pool_blocks", frame_pool_blocks,
+                 "Freed coroutine frames and awaitable states kept for reuse per "
+                 "thread and size class (default: 1024, 0 = disabled)")
+      ->check(CLI::NonNegativeNumber);
+  app.add_option("--hydration_cache_entries", hydration_cache_entries,
+                 "Max cached user:{id} fields shared across requests; hits "
+                 "may be up to --hydration_cache_ttl_ms stale "
+                 "(default: 0 = disabled)")
+      ->check(CLI::NonNegativeNumber);
+  app.add_option("--hydration_cache_ttl_ms", hydration_cache_ttl_ms,
+                 "TTL for cached user:{id} fields in milliseconds "
+                 "(default: 30000, 0 = disabled)")
+      ->check(CLI::NonNegativeNumber);
+  app.add_option("--redis_pool_max_idle", redis_pool_max_idle,
+                 "Idle sync Redis connections kept per endpoint across requests "
+                 "(default: 64, 0 = connect per request)")
+      ->check(CLI::NonNegativeNumber);
   app.add_flag("--within_request_parallelism", within_request_parallelism,
                "Enable within-request DAG parallelism (default: ON in bench, OFF otherwise)");
   app.add_option("--deadline_ms", deadline_ms,
@@ -127,12 +176,12 @@ int main(int argc, char *argv[]) {
   app.add_flag("--bench_eventloop", bench_eventloop,
                "Run EventLoop microbenchmarks and exit");
   app.add_option("--bench_eventloop_mode", bench_eventloop_mode,
-                 "EventLoop benchmark mode: posts|timers|sleep_vs_pool|all (default: all)");
+                 "EventLoop benchmark mode: posts|timers|sleep_vs_pool|frames|all (default: all)");
   app.add_option("--bench_n", bench_n,
                  "Number of operations for bench_eventloop (0 = use mode default)")
       ->check(CLI::NonNegativeNumber);
   app.add_option("--bench_producers", bench_producers,
-                 "Number of producer threads for posts mode (default: 1)")
+                 "Max producer threads for posts mode; runs 1, 2, 4, ... up to N (default: 1)")
       ->check(CLI::PositiveNumber);
   app.add_option("--bench_sleep_ms", bench_sleep_ms,
                  "Timer timeout in ms for timers mode, sleep duration for sleep_vs_pool (default: 1, 0 = immediate)")
@@ -142,6 +191,40 @@ int main(int argc, char *argv[]) {
       ->check(CLI::PositiveNumber);
   app.add_flag("--bench_json", bench_json,
                "Output benchmark results as JSON");
+  app.add_flag("--bench_dag", bench_dag,
+               "Run the wide-DAG FIFO vs critical-path scheduling benchmark and exit "
+               "(iterations: --bench_n, default 20)");
+  app.add_option("--bench_dag_width", bench_dag_width,
+                 "Max side branches for bench_dag; runs 8, 16, ... up to N (default: 32)")
+      ->check(CLI::PositiveNumber);
+  app.add_option("--bench_dag_depth", bench_dag_depth,
+                 "Critical chain length for bench_dag (default: 4)")
+      ->check(CLI::PositiveNumber);
+  app.add_option("--bench_dag_node_ms", bench_dag_node_ms,
+                 "Runtime of each bench_dag node in ms (default: 5)")
+      ->check(CLI::NonNegativeNumber);
+  app.add_option("--bench_dag_slots", bench_dag_slots,
+                 "max_nodes_inflight for bench_dag (default: 4)")
+      ->check(CLI::PositiveNumber);
+  app.add_option("--ready_queue_policy", ready_queue_policy,
+                 "Order of ready DAG nodes: critical_path (longest remaining path "
+                 "first) or fifo (default: critical_path)")
+      ->check(CLI::IsMember({"critical_path", "fifo"}));
+  app.add_option("--inline_cost_us", inline_cost_us,
+                 "Async scheduler: run CPU tasks whose estimated work (input rows x "
+                 "per-row op cost) is below this many us on the event loop thread "
+                 "instead of the CPU pool (default: 20, 0 = always offload)")
+      ->check(CLI::NonNegativeNumber);
+  app.add_option("--validation_level", validation_level,
+                 "Output contract checks: full (every node), structural (O(1) "
+                 "checks from RowSet provenance, full check when unproven) or "
+                 "sampled (full on 1 in --validation_sample_every requests, "
+                 "structural otherwise) (default: full)")
+      ->check(CLI::IsMember({"full", "structural", "sampled"}));
+  app.add_option("--validation_sample_every", validation_sample_every,
+                 "Sampled validation: run full checks on 1 in N requests "
+                 "(default: 100)")
+      ->check(CLI::PositiveNumber);
 
   CLI11_PARSE(app, argc, argv);
 
@@ -160,6 +243,48 @@ int main(int argc, char *argv[]) {
   // Initialize CPU thread pool (for within-request parallelism)
   rankd::InitCPUThreadPool(static_cast<size_t>(cpu_threads));
 
+  // Rank ready nodes by estimated remaining path (or plain FIFO)
+  rankd::NodeCostModel::instance().setEnabled(ready_queue_policy == "critical_path");
+  rankd::NodeCostModel::instance().setInlineThresholdUs(inline_cost_us);
+
+  // Handle --bench_dag (early exit, needs the CPU pool but no endpoints)
+  if (bench_dag) {
+    rankd::BenchDagConfig config;
+    if (bench_n > 0) {
+      config.iterations = bench_n;
+    }
+    config.max_width = bench_dag_width;
+    config.depth = bench_dag_depth;
+    config.node_ms = bench_dag_node_ms;
+    config.slots = bench_dag_slots;
+    config.json_output = bench_json;
+    return rankd::run_bench_dag(config);
+  }
+
+  // Output contract checking level
+  rankd::OutputValidation::instance().setLevel(
+      *rankd::parseValidationLevel(validation_level));
+  rankd::OutputValidation::instance().setSampleEvery(
+      static_cast<uint64_t>(validation_sample_every));
+
+  // Cap memory retained by the cross-request column buffer pool
+  rankd::ColumnBufferPool::instance().setRetainLimit(
+      static_cast<size_t>(buffer_pool_mb) << 20);
+
+  // Cap coroutine frames and awaitable states cached per thread
+  ranking::FramePool::instance().setThreadCacheLimit(
+      static_cast<size_t>(frame_pool_blocks));
+
+  // Bound the cross-request hydration cache
+  rankd::HydrationCache::instance().setCapacity(
+      static_cast<size_t>(hydration_cache_entries));
+  rankd::HydrationCache::instance().setTtl(
+      std::chrono::milliseconds(hydration_cache_ttl_ms));
+
+  // Keep sync Redis connections open across requests
+  rankd::RedisConnectionPool::instance().setMaxIdle(
+      static_cast<size_t>(redis_pool_max_idle));
+
   // Load endpoint registry
   std::string endpoints_path = artifacts_dir + "/endpoints." + env + ".json";
   auto endpoints_result =
@@ -351,6 +476,14 @@ int main(int argc, char *argv[]) {
       latencies_us.reserve(bench_iterations);
       std::mutex latencies_mutex;
 
+      // Per-request arena high-water marks (for arena sizing)
+      std::atomic<uint64_t> arena_bytes_sum{0};
+      std::atomic<uint64_t> arena_bytes_max{0};
+
+      // Async scheduler: CPU nodes run inline vs offloaded, summed over requests
+      std::atomic<uint64_t> nodes_inlined_sum{0};
+      std::atomic<uint64_t> nodes_offloaded_sum{0};
+
       std::cerr << "Running " << bench_iterations << " iterations of "
                 << plan.plan_name << " (concurrency=" << bench_concurrency
                 << ", parallel=" << (parallel ? "true" : "false")
@@ -368,8 +501,15 @@ int main(int argc, char *argv[]) {
         loop = std::make_unique<ranking::EventLoop>();
         loop->Start();
         async_clients = std::make_unique<ranking::AsyncIoClients>();
+        // Open Redis connection pools before the first timed request
+        loop->Post([&]() { async_clients->WarmUp(*loop, *endpoint_registry); });
       }
 
+      // Coroutine frame / awaitable state allocations during the timed run
+      const auto &frame_pool = ranking::FramePool::instance();
+      uint64_t frame_allocs_start = frame_pool.allocations();
+      uint64_t frame_system_allocs_start = frame_pool.systemAllocations();
+
       auto total_start = std::chrono::steady_clock::now();
 
       // Run iterations with specified concurrency
@@ -379,6 +519,9 @@ int main(int argc, char *argv[]) {
         bench_request.request_id = "bench-" + std::to_string(iter_id);
         bench_request.user_id = 1;
 
+        // Per-request arena for column storage, released in bulk at the end
+        auto arena = std::make_shared<rankd::RequestArena>();
+
         auto start = std::chrono::steady_clock::now();
 
         if (async_scheduler) {
@@ -396,8 +539,9 @@ int main(int argc, char *argv[]) {
           auto exec_result = ranking::execute_plan_async_blocking(
               plan, *loop, *async_clients, bench_params, plan.expr_table,
               plan.pred_table, *endpoint_registry, bench_request, nullptr,
-              iter_deadline, iter_node_timeout);
-          (void)exec_result;
+              iter_deadline, iter_node_timeout, arena);
+          nodes_inlined_sum.fetch_add(exec_result.nodes_inlined, std::memory_order_relaxed);
+          nodes_offloaded_sum.fetch_add(exec_result.nodes_offloaded, std::memory_order_relaxed);
         } else {
           // Sync execution path
           rankd::IoClients bench_clients;
@@ -408,6 +552,7 @@ int main(int argc, char *argv[]) {
           bench_ctx.clients = &bench_clients;
           bench_ctx.expr_table = &plan.expr_table;
           bench_ctx.pred_table = &plan.pred_table;
+          bench_ctx.arena = arena;
           bench_ctx.parallel = parallel;
 
           auto exec_result = rankd::execute_plan(plan, bench_ctx);
@@ -415,6 +560,15 @@ int main(int argc, char *argv[]) {
         }
 
         auto end = std::chrono::steady_clock::now();
+
+        uint64_t arena_bytes = arena->highWaterBytes();
+        arena_bytes_sum.fetch_add(arena_bytes, std::memory_order_relaxed);
+        uint64_t prev_max = arena_bytes_max.load(std::memory_order_relaxed);
+        while (prev_max < arena_bytes &&
+               !arena_bytes_max.compare_exchange_weak(prev_max, arena_bytes,
+                                                      std::memory_order_relaxed)) {
+        }
+
         return std::chrono::duration<double, std::micro>(end - start).count();
       };
 
@@ -469,7 +623,28 @@ int main(int argc, char *argv[]) {
       }
 
       // Stop async infrastructure if used
+      uint64_t redis_reconnects = 0;
+      uint64_t redis_commands = 0;
+      json redis_limits = json::object();
+      json redis_hedges = json::object();
       if (loop) {
+        redis_reconnects = async_clients->redis_reconnects();
+        redis_commands = async_clients->redis_commands();
+        // Final (possibly adapted) inflight limit and queueing delay per endpoint
+        for (const auto &ep : endpoint_registry->all()) {
+          if (size_t limit = async_clients->redis_inflight_limit(ep.endpoint_id)) {
+            redis_limits[ep.endpoint_id] = {
+                {"inflight_limit", limit},
+                {"queue_delay_us",
+                 async_clients->redis_queue_delay(ep.endpoint_id).count()}};
+          }
+          if (!ep.replicas.empty() && ep.policy.hedge_percentile) {
+            redis_hedges[ep.endpoint_id] = {
+                {"issued", async_clients->redis_hedges_issued(ep.endpoint_id)},
+                {"won", async_clients->redis_hedges_won(ep.endpoint_id)}};
+          }
+        }
+
         // Clean up async clients BEFORE stopping loop - they need the loop
         // to process disconnect callbacks. Skipping this causes hiredis's
         // UV_POLL handles to interfere with loop shutdown.
@@ -513,6 +688,7 @@ int main(int argc, char *argv[]) {
       output["within_request_parallelism"] = parallel;
       output["async_scheduler"] = async_scheduler;
       output["cpu_threads"] = cpu_threads;
+      output["cpu_pool_steals"] = rankd::GetCPUThreadPool().steals();
       output["total_ms"] = total_ms;
       output["throughput_rps"] = throughput_rps;
       output["avg_us"] = avg_us;
@@ -520,6 +696,46 @@ int main(int argc, char *argv[]) {
       output["p99_us"] = p99_us;
       output["min_us"] = min_us;
       output["max_us"] = max_us;
+      output["arena_avg_bytes"] = arena_bytes_sum.load() / bench_iterations;
+      output["arena_max_bytes"] = arena_bytes_max.load();
+      const auto &buffer_pool = rankd::ColumnBufferPool::instance();
+      output["buffer_pool_hits"] = buffer_pool.hits();
+      output["buffer_pool_misses"] = buffer_pool.misses();
+      output["buffer_pool_retained_bytes"] = buffer_pool.retainedBytes();
+      const auto &hydration_cache = rankd::HydrationCache::instance();
+      output["hydration_cache_hits"] = hydration_cache.hits();
+      output["hydration_cache_negative_hits"] = hydration_cache.negativeHits();
+      output["hydration_cache_misses"] = hydration_cache.misses();
+      output["hydration_cache_evictions"] = hydration_cache.evictions();
+      output["hydration_cache_expirations"] = hydration_cache.expirations();
+      if (async_scheduler) {
+        output["redis_reconnects"] = redis_reconnects;
+        output["redis_limits"] = redis_limits;
+        output["redis_hedges"] = redis_hedges;
+        output["nodes_inlined_per_request"] =
+            static_cast<double>(nodes_inlined_sum.load()) / bench_iterations;
+        output["nodes_offloaded_per_request"] =
+            static_cast<double>(nodes_offloaded_sum.load()) / bench_iterations;
+        output["redis_commands_per_request"] =
+            static_cast<double>(redis_commands) / bench_iterations;
+        // Pooled allocations (frames, awaitable states, timers) per executed
+        // node; "system" ones missed the pool and hit the allocator
+        double nodes_run = static_cast<double>(bench_iterations) *
+                           static_cast<double>(plan.nodes.size());
+        output["frame_allocs_per_node"] =
+            static_cast<double>(frame_pool.allocations() - frame_allocs_start) /
+            nodes_run;
+        output["frame_system_allocs_per_node"] =
+            static_cast<double>(frame_pool.systemAllocations() -
+                                frame_system_allocs_start) /
+            nodes_run;
+      } else {
+        const auto &redis_pool = rankd::RedisConnectionPool::instance();
+        output["redis_pool_reuses"] = redis_pool.reuses();
+        output["redis_pool_creates"] = redis_pool.creates();
+        output["redis_pool_health_check_failures"] =
+            redis_pool.healthCheckFailures();
+      }
 
       std::cout << output.dump(2) << std::endl;
       return 0;
@@ -585,11 +801,15 @@ int main(int argc, char *argv[]) {
   // IoClients owns per-request client cache (Redis, etc.)
   rankd::IoClients io_clients;
 
+  // Per-request arena for column storage, released in bulk at request end
+  auto arena = std::make_shared<rankd::RequestArena>();
+
   rankd::ExecCtx ctx;
   ctx.params = &param_table;
   ctx.request = &request_context;
   ctx.endpoints = endpoint_registry;
   ctx.clients = &io_clients;
+  ctx.arena = arena;
   ctx.parallel = within_request_parallelism;
 
   // Generate candidates
@@ -641,7 +861,7 @@ int main(int argc, char *argv[]) {
           exec_result = ranking::execute_plan_async_blocking(
               plan, loop, async_clients, param_table, plan.expr_table,
               plan.pred_table, *endpoint_registry, request_context, nullptr,
-              request_deadline, node_timeout);
+              request_deadline, node_timeout, arena);
         } catch (...) {
           // Drain CPU pool WHILE loop running, then stop
           rankd::GetCPUThreadPool().wait_idle();
@@ -724,6 +944,17 @@ int main(int argc, char *argv[]) {
           schema_deltas.push_back(delta_json);
         }
         response["schema_deltas"] = schema_deltas;
+        response["arena_high_water_bytes"] = arena->highWaterBytes();
+        response["peak_result_working_set_bytes"] = exec_result.peak_result_working_set_bytes;
+        json node_bytes_received = json::object();
+        for (const auto &io : exec_result.io_trace) {
+          node_bytes_received[io.node_id] = io.bytes_received;
+        }
+        response["node_bytes_received"] = node_bytes_received;
+        if (async_scheduler) {
+          response["nodes_inlined"] = exec_result.nodes_inlined;
+          response["nodes_offloaded"] = exec_result.nodes_offloaded;
+        }
       }
     } catch (const std::exception &e) {
       std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,59 @@
+#include "node_results.h"
+
+#include <algorithm>
+
+namespace rankd {
+
+void NodeResults::reset(size_t num_nodes) {
+  results_.assign(num_nodes, std::nullopt);
+  consumers_.assign(num_nodes, 0);
+  parents_.assign(num_nodes, {});
+  buffers_.clear();
+  working_set_bytes_ = 0;
+  peak_working_set_bytes_ = 0;
+}
+
+void NodeResults::addEdge(size_t parent_idx, size_t child_idx) {
+  ++consumers_[parent_idx];
+  parents_[child_idx].push_back(parent_idx);
+}
+
+void NodeResults::addOutput(size_t node_idx) { ++consumers_[node_idx]; }
+
+void NodeResults::complete(size_t node_idx, RowSet result) {
+  result.forEachBuffer([this](const void *buffer, size_t bytes) {
+    BufferRef &ref = buffers_[buffer];
+    if (ref.refs++ == 0) {
+      ref.bytes = bytes;
+      working_set_bytes_ += bytes;
+    }
+  });
+  results_[node_idx] = std::move(result);
+  // Parents are still held here, so this is the node's peak
+  peak_working_set_bytes_ = std::max(peak_working_set_bytes_, working_set_bytes_);
+
+  for (size_t parent_idx : parents_[node_idx]) {
+    if (consumers_[parent_idx] > 0 && --consumers_[parent_idx] == 0) {
+      release(parent_idx);
+    }
+  }
+  if (consumers_[node_idx] == 0) {
+    release(node_idx); // Nothing reads it
+  }
+}
+
+void NodeResults::release(size_t node_idx) {
+  if (!results_[node_idx]) {
+    return;
+  }
+  results_[node_idx]->forEachBuffer([this](const void *buffer, size_t) {
+    auto it = buffers_.find(buffer);
+    if (it != buffers_.end() && --it->second.refs == 0) {
+      working_set_bytes_ -= it->second.bytes;
+      buffers_.erase(it);
+    }
+  });
+  results_[node_idx].reset();
+}
+
+} // namespace rankd
@@ -26,12 +26,52 @@ const char *outputPatternToString(OutputPattern pattern) {
   return "Unknown";
 }
 
+std::optional<ValidationLevel> parseValidationLevel(const std::string &name) {
+  if (name == "full") {
+    return ValidationLevel::Full;
+  }
+  if (name == "structural") {
+    return ValidationLevel::Structural;
+  }
+  if (name == "sampled") {
+    return ValidationLevel::Sampled;
+  }
+  return std::nullopt;
+}
+
+OutputValidation &OutputValidation::instance() {
+  // Leaked on purpose: late-completing nodes may still validate during exit
+  static OutputValidation *validation = new OutputValidation();
+  return *validation;
+}
+
+bool OutputValidation::beginRequest() {
+  switch (level()) {
+  case ValidationLevel::Full:
+    return true;
+  case ValidationLevel::Structural:
+    return false;
+  case ValidationLevel::Sampled: {
+    uint64_t every = std::max<uint64_t>(sampleEvery(), 1);
+    return requests_.fetch_add(1, std::memory_order_relaxed) % every == 0;
+  }
+  }
+  return true;
+}
+
 // Helper: check if output active rows are dense [0..N)
 static bool isDenseActive(const RowSet &rs) {
   size_t expected = rs.rowCount();
+  auto active = rs.activeRows();
+  if (active.isAllRows()) {
+    return true;
+  }
+  if (active.bitmap()) {
+    return active.size() == expected; // ascending, so dense iff all bits set
+  }
   size_t count = 0;
   bool ok = true;
-  rs.activeRows().forEachIndex([&](RowIndex idx) -> bool {
+  active.forEachIndex([&](RowIndex idx) -> bool {
     if (idx != count) {
       ok = false;
       return false; // stop
@@ -44,6 +84,16 @@ static bool isDenseActive(const RowSet &rs) {
 
 // Helper: check if 'output' activeRows equals 'input' activeRows exactly
 static bool activeRowsEqual(const RowSet &input, const RowSet &output) {
+  // Shared selection/order buffers (e.g. withBatch) are trivially equal
+  if (input.selectionBuffer() == output.selectionBuffer() &&
+      input.selectionBitmap() == output.selectionBitmap() &&
+      input.orderBuffer() == output.orderBuffer()) {
+    return true;
+  }
+  if (!input.hasOrder() && !output.hasOrder() && input.selectionBitmap() &&
+      output.selectionBitmap()) {
+    return *input.selectionBitmap() == *output.selectionBitmap();
+  }
   // Compare sequences
   auto inActive = input.activeRows().toVector(input.rowCount());
   auto outActive = output.activeRows().toVector(output.rowCount());
@@ -52,8 +102,30 @@ static bool activeRowsEqual(const RowSet &input, const RowSet &output) {
 
 // Helper: check if 'output' activeRows is a subsequence of 'input' activeRows
 static bool isSubsequence(const RowSet &input, const RowSet &output) {
-  auto inActive = input.activeRows().toVector(input.rowCount());
-  auto outActive = output.activeRows().toVector(output.rowCount());
+  auto in = input.activeRows();
+  auto out = output.activeRows();
+  if (!in.indices()) {
+    // Input is ascending (all rows or bitmap): output must be strictly
+    // ascending and drawn from the input's active rows
+    if (in.bitmap() && out.bitmap()) {
+      return out.bitmap()->isSubsetOf(*in.bitmap());
+    }
+    bool ok = true;
+    int64_t prev = -1;
+    out.forEachIndex([&](RowIndex idx) -> bool {
+      if (static_cast<int64_t>(idx) <= prev || idx >= input.rowCount() ||
+          (in.bitmap() && !in.bitmap()->test(idx))) {
+        ok = false;
+        return false;
+      }
+      prev = idx;
+      return true;
+    });
+    return ok;
+  }
+
+  auto inActive = in.toVector(input.rowCount());
+  auto outActive = out.toVector(output.rowCount());
 
   size_t j = 0; // index into outActive
   for (size_t i = 0; i < inActive.size() && j < outActive.size(); ++i) {
@@ -96,10 +168,45 @@ static bool isPermutation(const RowSet &input, const RowSet &output) {
   return inActive == outActive;
 }
 
+// Structural proofs, O(1): the output is the input's own view, or was built
+// from it by a builder whose result holds the contract by construction
+// (RowSet::Derivation). False means "not proven": the caller falls back to
+// the full check.
+
+// filterActive applied to input, or a truncateTo prefix of it
+static bool provenSubsequence(const RowSet &input, const RowSet &output) {
+  if (output.sameView(input)) {
+    return true;
+  }
+  return (output.derivation() == RowSet::Derivation::Filter ||
+          output.derivation() == RowSet::Derivation::Truncate) &&
+         output.derivedFrom(input);
+}
+
+// truncateTo applied to input (or returned it unchanged)
+static bool provenPrefix(const RowSet &input, const RowSet &output,
+                         size_t expected_count) {
+  if (output.sameView(input)) {
+    return input.logicalSize() == expected_count;
+  }
+  return output.derivation() == RowSet::Derivation::Truncate &&
+         output.derivedFrom(input) && output.logicalSize() == expected_count;
+}
+
+// sortActive applied to input (or input unchanged)
+static bool provenPermutation(const RowSet &input, const RowSet &output) {
+  if (output.sameView(input)) {
+    return true;
+  }
+  return output.derivation() == RowSet::Derivation::Sort &&
+         output.derivedFrom(input);
+}
+
 void validateTaskOutput(const std::string &node_id, const std::string &op,
                         OutputPattern pattern,
                         const std::vector<RowSet> &inputs,
-                        const ValidatedParams &params, const RowSet &output) {
+                        const ValidatedParams &params, const RowSet &output,
+                        bool full) {
   auto makeError = [&](const std::string &detail) {
     std::ostringstream oss;
     oss << "Error: Node '" << node_id << "': op '" << op
@@ -107,6 +214,17 @@ void validateTaskOutput(const std::string &node_id, const std::string &op,
     throw std::runtime_error(oss.str());
   };
 
+  // Structural level: accept a proven contract, otherwise run the full check
+  auto check = [full](bool proven, auto &&full_check) {
+    if (!full) {
+      if (proven) {
+        return true;
+      }
+      OutputValidation::instance().noteStructuralFallback();
+    }
+    return full_check();
+  };
+
   switch (pattern) {
   case OutputPattern::SourceFanoutDense: {
     // Expected rowCount = params.fanout
@@ -154,7 +272,8 @@ void validateTaskOutput(const std::string &node_id, const std::string &op,
           << " (StableFilter), got " << output.rowCount();
       makeError(oss.str());
     }
-    if (!isSubsequence(inputs[0], output)) {
+    if (!check(!full && provenSubsequence(inputs[0], output),
+               [&] { return isSubsequence(inputs[0], output); })) {
       makeError("StableFilter requires output activeRows to be subsequence of "
                 "input[0]");
     }
@@ -178,7 +297,8 @@ void validateTaskOutput(const std::string &node_id, const std::string &op,
           << " (PrefixOfInput), got " << output.rowCount();
       makeError(oss.str());
     }
-    if (!isPrefix(inputs[0], output, expected_k)) {
+    if (!check(!full && provenPrefix(inputs[0], output, expected_k),
+               [&] { return isPrefix(inputs[0], output, expected_k); })) {
       std::ostringstream oss;
       oss << "PrefixOfInput requires output activeRows to be first " << expected_k
           << " of input[0] activeRows";
@@ -197,7 +317,8 @@ void validateTaskOutput(const std::string &node_id, const std::string &op,
           << " (PermutationOfInput), got " << output.rowCount();
       makeError(oss.str());
     }
-    if (!isPermutation(inputs[0], output)) {
+    if (!check(!full && provenPermutation(inputs[0], output),
+               [&] { return isPermutation(inputs[0], output); })) {
       makeError("PermutationOfInput requires output activeRows to be a "
                 "permutation of input[0]");
     }
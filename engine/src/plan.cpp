@@ -210,6 +210,36 @@ PredNodePtr parse_pred_node(const nlohmann::json &j) {
   return node;
 }
 
+void collect_key_refs(const ExprNode &node, std::vector<uint32_t> &out) {
+  if (node.op == "key_ref") {
+    out.push_back(node.key_id);
+  }
+  if (node.a) {
+    collect_key_refs(*node.a, out);
+  }
+  if (node.b) {
+    collect_key_refs(*node.b, out);
+  }
+}
+
+void collect_key_refs(const PredNode &node, std::vector<uint32_t> &out) {
+  if (node.op == "regex") {
+    out.push_back(node.regex_key_id);
+  }
+  if (node.value_a) {
+    collect_key_refs(*node.value_a, out);
+  }
+  if (node.value_b) {
+    collect_key_refs(*node.value_b, out);
+  }
+  if (node.pred_a) {
+    collect_key_refs(*node.pred_a, out);
+  }
+  if (node.pred_b) {
+    collect_key_refs(*node.pred_b, out);
+  }
+}
+
 Plan parse_plan(const std::string &path) {
   std::ifstream file(path);
   if (!file) {
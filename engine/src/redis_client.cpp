@@ -1,8 +1,139 @@
 #include "redis_client.h"
 #include <hiredis.h>
 
+#include <algorithm>
+
 namespace rankd {
 
+namespace {
+
+// Reply parsers shared by the single-key and pipelined paths. They do not
+// free the reply.
+
+std::expected<std::vector<std::string>, std::string> parse_lrange_reply(
+    redisReply* reply) {
+  // Handle error reply
+  if (reply->type == REDIS_REPLY_ERROR) {
+    return std::unexpected("redis: LRANGE error: " + std::string(reply->str));
+  }
+
+  // Expect array reply
+  if (reply->type != REDIS_REPLY_ARRAY) {
+    return std::unexpected("redis: LRANGE unexpected reply type: " +
+                           std::to_string(reply->type));
+  }
+
+  std::vector<std::string> result;
+  result.reserve(reply->elements);
+
+  for (size_t i = 0; i < reply->elements; ++i) {
+    redisReply* elem = reply->element[i];
+    if (elem->type == REDIS_REPLY_STRING || elem->type == REDIS_REPLY_STATUS) {
+      result.emplace_back(elem->str, elem->len);
+    } else if (elem->type == REDIS_REPLY_NIL) {
+      result.emplace_back("");  // nil -> empty string
+    } else {
+      // Unexpected element type, skip or treat as empty
+      result.emplace_back("");
+    }
+  }
+
+  return result;
+}
+
+std::expected<std::unordered_map<std::string, std::string>, std::string>
+parse_hgetall_reply(redisReply* reply) {
+  // Handle error reply
+  if (reply->type == REDIS_REPLY_ERROR) {
+    return std::unexpected("redis: HGETALL error: " + std::string(reply->str));
+  }
+
+  // Expect array reply (field, value, field, value, ...)
+  if (reply->type != REDIS_REPLY_ARRAY) {
+    return std::unexpected("redis: HGETALL unexpected reply type: " +
+                           std::to_string(reply->type));
+  }
+
+  // Must have even number of elements
+  if (reply->elements % 2 != 0) {
+    return std::unexpected(std::string("redis: HGETALL odd number of elements"));
+  }
+
+  std::unordered_map<std::string, std::string> result;
+
+  for (size_t i = 0; i < reply->elements; i += 2) {
+    redisReply* field = reply->element[i];
+    redisReply* value = reply->element[i + 1];
+
+    std::string field_str;
+    std::string value_str;
+
+    if (field->type == REDIS_REPLY_STRING || field->type == REDIS_REPLY_STATUS) {
+      field_str = std::string(field->str, field->len);
+    }
+
+    if (value->type == REDIS_REPLY_STRING || value->type == REDIS_REPLY_STATUS) {
+      value_str = std::string(value->str, value->len);
+    }
+
+    result[field_str] = value_str;
+  }
+
+  return result;
+}
+
+std::expected<std::vector<std::optional<std::string>>, std::string>
+parse_hmget_reply(redisReply* reply, size_t num_fields) {
+  // Handle error reply
+  if (reply->type == REDIS_REPLY_ERROR) {
+    return std::unexpected("redis: HMGET error: " + std::string(reply->str));
+  }
+
+  // Expect array reply with one element per requested field
+  if (reply->type != REDIS_REPLY_ARRAY || reply->elements != num_fields) {
+    return std::unexpected("redis: HMGET unexpected reply type: " +
+                           std::to_string(reply->type));
+  }
+
+  std::vector<std::optional<std::string>> result(num_fields);
+  for (size_t i = 0; i < num_fields; ++i) {
+    redisReply* elem = reply->element[i];
+    if (elem->type == REDIS_REPLY_STRING || elem->type == REDIS_REPLY_STATUS) {
+      result[i].emplace(elem->str, elem->len);
+    }
+    // nil (absent field) stays nullopt
+  }
+
+  return result;
+}
+
+// argv for HMGET key field...; views into key and fields
+struct HmgetArgv {
+  std::vector<const char*> argv;
+  std::vector<size_t> argvlen;
+
+  explicit HmgetArgv(const std::vector<std::string>& fields) {
+    argv.reserve(fields.size() + 2);
+    argvlen.reserve(fields.size() + 2);
+    argv.push_back("HMGET");
+    argvlen.push_back(5);
+    argv.push_back(nullptr);  // key, set per command
+    argvlen.push_back(0);
+    for (const auto& field : fields) {
+      argv.push_back(field.data());
+      argvlen.push_back(field.size());
+    }
+  }
+
+  void setKey(const std::string& key) {
+    argv[1] = key.data();
+    argvlen[1] = key.size();
+  }
+  int argc() const { return static_cast<int>(argv.size()); }
+};
+
+}  // namespace
+
 RedisClient::RedisClient(const EndpointSpec& endpoint)
     : host_(endpoint.static_resolver.host),
       port_(endpoint.static_resolver.port),
@@ -81,6 +212,24 @@ std::expected<void, std::string> RedisClient::ensure_connected() {
   return {};
 }
 
+bool RedisClient::ping() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!ensure_connected()) {
+    return false;
+  }
+
+  redisReply* reply = static_cast<redisReply*>(redisCommand(ctx_, "PING"));
+  if (reply == nullptr) {
+    last_error_ = "redis: PING failed: " + std::string(ctx_->errstr);
+    disconnect();
+    return false;
+  }
+  bool ok = reply->type == REDIS_REPLY_STATUS;
+  freeReplyObject(reply);
+  return ok;
+}
+
 std::expected<std::vector<std::string>, std::string> RedisClient::lrange(
     const std::string& key, int64_t start, int64_t stop) {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -99,37 +248,11 @@ std::expected<std::vector<std::string>, std::string> RedisClient::lrange(
     return std::unexpected(last_error_);
   }
 
-  // Handle error reply
-  if (reply->type == REDIS_REPLY_ERROR) {
-    last_error_ = "redis: LRANGE error: " + std::string(reply->str);
-    freeReplyObject(reply);
-    return std::unexpected(last_error_);
-  }
-
-  // Expect array reply
-  if (reply->type != REDIS_REPLY_ARRAY) {
-    last_error_ = "redis: LRANGE unexpected reply type: " +
-                  std::to_string(reply->type);
-    freeReplyObject(reply);
-    return std::unexpected(last_error_);
-  }
-
-  std::vector<std::string> result;
-  result.reserve(reply->elements);
-
-  for (size_t i = 0; i < reply->elements; ++i) {
-    redisReply* elem = reply->element[i];
-    if (elem->type == REDIS_REPLY_STRING || elem->type == REDIS_REPLY_STATUS) {
-      result.emplace_back(elem->str, elem->len);
-    } else if (elem->type == REDIS_REPLY_NIL) {
-      result.emplace_back("");  // nil -> empty string
-    } else {
-      // Unexpected element type, skip or treat as empty
-      result.emplace_back("");
-    }
-  }
-
+  auto result = parse_lrange_reply(reply);
   freeReplyObject(reply);
+  if (!result) {
+    last_error_ = result.error();
+  }
   return result;
 }
 
@@ -151,50 +274,168 @@ RedisClient::hgetall(const std::string& key) {
     return std::unexpected(last_error_);
   }
 
-  // Handle error reply
-  if (reply->type == REDIS_REPLY_ERROR) {
-    last_error_ = "redis: HGETALL error: " + std::string(reply->str);
-    freeReplyObject(reply);
-    return std::unexpected(last_error_);
+  auto result = parse_hgetall_reply(reply);
+  freeReplyObject(reply);
+  if (!result) {
+    last_error_ = result.error();
   }
+  return result;
+}
 
-  // Expect array reply (field, value, field, value, ...)
-  if (reply->type != REDIS_REPLY_ARRAY) {
-    last_error_ = "redis: HGETALL unexpected reply type: " +
-                  std::to_string(reply->type);
-    freeReplyObject(reply);
-    return std::unexpected(last_error_);
+std::expected<std::vector<std::optional<std::string>>, std::string>
+RedisClient::hmget(const std::string& key, const std::vector<std::string>& fields) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto conn_result = ensure_connected();
+  if (!conn_result) {
+    return std::unexpected(conn_result.error());
   }
 
-  // Must have even number of elements
-  if (reply->elements % 2 != 0) {
-    last_error_ = "redis: HGETALL odd number of elements";
-    freeReplyObject(reply);
+  HmgetArgv args(fields);
+  args.setKey(key);
+  redisReply* reply = static_cast<redisReply*>(redisCommandArgv(
+      ctx_, args.argc(), args.argv.data(), args.argvlen.data()));
+
+  if (reply == nullptr) {
+    last_error_ = "redis: HMGET failed: " + std::string(ctx_->errstr);
+    disconnect();  // Connection may be broken
     return std::unexpected(last_error_);
   }
 
-  std::unordered_map<std::string, std::string> result;
-
-  for (size_t i = 0; i < reply->elements; i += 2) {
-    redisReply* field = reply->element[i];
-    redisReply* value = reply->element[i + 1];
+  auto result = parse_hmget_reply(reply, fields.size());
+  freeReplyObject(reply);
+  if (!result) {
+    last_error_ = result.error();
+  }
+  return result;
+}
 
-    std::string field_str;
-    std::string value_str;
+template <typename Format, typename OnReply>
+std::expected<void, std::string> RedisClient::pipeline(const char* cmd_name,
+                                                       size_t count,
+                                                       Format&& format,
+                                                       OnReply&& on_reply) {
+  auto conn_result = ensure_connected();
+  if (!conn_result) {
+    return std::unexpected(conn_result.error());
+  }
 
-    if (field->type == REDIS_REPLY_STRING || field->type == REDIS_REPLY_STATUS) {
-      field_str = std::string(field->str, field->len);
+  std::string first_error;
+  for (size_t base = 0; base < count; base += kMaxPipelineDepth) {
+    size_t end = std::min(count, base + kMaxPipelineDepth);
+
+    // Buffer this window of commands; the first redisGetReply writes them all
+    for (size_t i = base; i < end; ++i) {
+      if (format(i) != REDIS_OK) {
+        last_error_ = "redis: " + std::string(cmd_name) +
+                      " failed: " + std::string(ctx_->errstr);
+        disconnect();  // Unsent commands would desync the connection
+        return std::unexpected(last_error_);
+      }
     }
 
-    if (value->type == REDIS_REPLY_STRING || value->type == REDIS_REPLY_STATUS) {
-      value_str = std::string(value->str, value->len);
+    for (size_t i = base; i < end; ++i) {
+      void* raw = nullptr;
+      if (redisGetReply(ctx_, &raw) != REDIS_OK || raw == nullptr) {
+        last_error_ = "redis: " + std::string(cmd_name) +
+                      " failed: " + std::string(ctx_->errstr);
+        disconnect();  // Connection may be broken
+        return std::unexpected(last_error_);
+      }
+      redisReply* reply = static_cast<redisReply*>(raw);
+      if (first_error.empty()) {
+        auto parsed = on_reply(i, reply);
+        if (!parsed) {
+          first_error = parsed.error();
+        }
+      }
+      freeReplyObject(reply);
     }
+  }
 
-    result[field_str] = value_str;
+  if (!first_error.empty()) {
+    last_error_ = first_error;
+    return std::unexpected(last_error_);
   }
+  return {};
+}
 
-  freeReplyObject(reply);
-  return result;
+std::expected<std::vector<std::vector<std::string>>, std::string>
+RedisClient::lrange_batch(const std::vector<std::string>& keys, int64_t start,
+                          int64_t stop) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::vector<std::vector<std::string>> results(keys.size());
+  auto status = pipeline(
+      "LRANGE", keys.size(),
+      [&](size_t i) {
+        return redisAppendCommand(ctx_, "LRANGE %s %lld %lld", keys[i].c_str(),
+                                  start, stop);
+      },
+      [&](size_t i, redisReply* reply) -> std::expected<void, std::string> {
+        auto parsed = parse_lrange_reply(reply);
+        if (!parsed) {
+          return std::unexpected(parsed.error());
+        }
+        results[i] = std::move(*parsed);
+        return {};
+      });
+  if (!status) {
+    return std::unexpected(status.error());
+  }
+  return results;
+}
+
+std::expected<std::vector<std::unordered_map<std::string, std::string>>, std::string>
+RedisClient::hgetall_batch(const std::vector<std::string>& keys) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::vector<std::unordered_map<std::string, std::string>> results(keys.size());
+  auto status = pipeline(
+      "HGETALL", keys.size(),
+      [&](size_t i) {
+        return redisAppendCommand(ctx_, "HGETALL %s", keys[i].c_str());
+      },
+      [&](size_t i, redisReply* reply) -> std::expected<void, std::string> {
+        auto parsed = parse_hgetall_reply(reply);
+        if (!parsed) {
+          return std::unexpected(parsed.error());
+        }
+        results[i] = std::move(*parsed);
+        return {};
+      });
+  if (!status) {
+    return std::unexpected(status.error());
+  }
+  return results;
+}
+
+std::expected<std::vector<std::vector<std::optional<std::string>>>, std::string>
+RedisClient::hmget_batch(const std::vector<std::string>& keys,
+                         const std::vector<std::string>& fields) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  HmgetArgv args(fields);
+  std::vector<std::vector<std::optional<std::string>>> results(keys.size());
+  auto status = pipeline(
+      "HMGET", keys.size(),
+      [&](size_t i) {
+        args.setKey(keys[i]);
+        return redisAppendCommandArgv(ctx_, args.argc(), args.argv.data(),
+                                      args.argvlen.data());
+      },
+      [&](size_t i, redisReply* reply) -> std::expected<void, std::string> {
+        auto parsed = parse_hmget_reply(reply, fields.size());
+        if (!parsed) {
+          return std::unexpected(parsed.error());
+        }
+        results[i] = std::move(*parsed);
+        return {};
+      });
+  if (!status) {
+    return std::unexpected(status.error());
+  }
+  return results;
 }
 
 }  // namespace rankd
@@ -0,0 +1,73 @@
+#include "redis_connection_pool.h"
+
+namespace rankd {
+
+RedisConnectionPool &RedisConnectionPool::instance() {
+  // Leaked on purpose: connections may still be returned during exit
+  static RedisConnectionPool *pool = new RedisConnectionPool();
+  return *pool;
+}
+
+std::string RedisConnectionPool::poolKey(const EndpointSpec &endpoint) {
+  return endpoint.endpoint_id + "@" + endpoint.static_resolver.host + ":" +
+         std::to_string(endpoint.static_resolver.port);
+}
+
+std::unique_ptr<RedisClient>
+RedisConnectionPool::checkout(const EndpointSpec &endpoint) {
+  if (maxIdle() > 0) {
+    Idle idle;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      auto it = idle_.find(poolKey(endpoint));
+      if (it != idle_.end() && !it->second.empty()) {
+        idle = std::move(it->second.back());
+        it->second.pop_back();
+      }
+    }
+    if (idle.client) {
+      reuses_.fetch_add(1, std::memory_order_relaxed);
+      // PING outside the lock; on failure the client reconnects on next use
+      if (Clock::now() - idle.since > kHealthCheckAfterIdle &&
+          !idle.client->ping()) {
+        health_check_failures_.fetch_add(1, std::memory_order_relaxed);
+      }
+      return std::move(idle.client);
+    }
+  }
+  creates_.fetch_add(1, std::memory_order_relaxed);
+  return std::make_unique<RedisClient>(endpoint);
+}
+
+void RedisConnectionPool::checkin(const EndpointSpec &endpoint,
+                                  std::unique_ptr<RedisClient> client) {
+  // Never-used or broken connections are not worth keeping
+  if (!client || !client->connected()) {
+    return;
+  }
+  std::unique_ptr<RedisClient> dropped;
+  std::lock_guard<std::mutex> lock(mu_);
+  auto &idle = idle_[poolKey(endpoint)];
+  if (idle.size() >= maxIdle()) {
+    dropped = std::move(client); // Closed after the lock is released
+    return;
+  }
+  idle.push_back(Idle{std::move(client), Clock::now()});
+}
+
+void RedisConnectionPool::clear() {
+  std::unordered_map<std::string, std::vector<Idle>> closing;
+  std::lock_guard<std::mutex> lock(mu_);
+  closing.swap(idle_);
+}
+
+size_t RedisConnectionPool::idleCount() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  size_t total = 0;
+  for (const auto &[key, idle] : idle_) {
+    total += idle.size();
+  }
+  return total;
+}
+
+} // namespace rankd
@@ -26,6 +26,7 @@ public:
         .default_budget = {.timeout_ms = 50},
         .output_pattern = OutputPattern::ConcatDense,
         // writes_effect omitted - no column writes
+        .inline_row_cost_ns = 20,
     };
   }
 
@@ -52,8 +53,9 @@ public:
     size_t rhsN = rhsIdx.size();
     size_t outN = lhsN + rhsN;
 
-    // Create new batch
-    auto outBatch = std::make_shared<ColumnBatch>(outN);
+    // Create new batch (every id and every valid value is written below)
+    auto outBatch = std::make_shared<ColumnBatch>(outN, nullptr, ctx.arena,
+                                                  ColumnInit::Uninitialized);
 
     // Copy ids: lhs active rows, then rhs active rows
     for (size_t i = 0; i < lhsN; ++i) {
@@ -71,7 +73,8 @@ public:
       float_keys.insert(k);
 
     for (uint32_t key_id : float_keys) {
-      auto col = std::make_shared<FloatColumn>(outN);
+      auto col = std::make_shared<FloatColumn>(outN, ColumnInit::Uninitialized,
+                                               outBatch->resource());
       const FloatColumn *lhsCol = lhs.batch().getFloatCol(key_id);
       const FloatColumn *rhsCol = rhs.batch().getFloatCol(key_id);
 
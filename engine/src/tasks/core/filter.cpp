@@ -24,6 +24,7 @@ public:
         .default_budget = {.timeout_ms = 50},
         .output_pattern = OutputPattern::StableFilter,
         // writes_effect omitted - no column writes
+        .inline_row_cost_ns = 50,
     };
   }
 
@@ -50,17 +51,12 @@ public:
     const PredNode &pred = *pred_it->second;
 
     const auto &input = inputs[0];
+    const ColumnBatch &batch = input.batch();
 
-    // Build new selection by filtering active rows
-    SelectionVector new_selection;
-    input.activeRows().forEachIndex([&](RowIndex idx) {
-      if (eval_pred(pred, idx, input.batch(), ctx)) {
-        new_selection.push_back(idx);
-      }
-    });
-
-    // Return new RowSet with same batch, updated selection
-    return input.withSelectionClearOrder(std::move(new_selection));
+    // filterActive keeps the selection representation cheapest for the
+    // result (see RowSet), and marks the output as a refinement of the input
+    return input.filterActive(
+        [&](RowIndex idx) { return eval_pred(pred, idx, batch, ctx); });
   }
 };
 
@@ -66,31 +66,29 @@ class MediaTask {
     // Get endpoint ID for Redis calls
     const std::string& endpoint_id = params.get_string("endpoint");
 
-    // Collect all media IDs
-    std::vector<int64_t> media_ids;
     const auto& input = inputs[0];
 
-    // Note: Can't throw from lambda, so collect errors
-    std::string error_msg;
+    // Fetch all media lists in one pipelined batch (one inflight permit)
+    std::vector<std::string> keys;
     input.activeRows().forEachIndex([&](RowIndex idx) {
-      if (!error_msg.empty()) return;  // Skip if already errored
-
-      int64_t row_id = input.batch().getId(idx);
-
-      // Fetch media list for this row's ID (with inflight limiting)
-      std::string key = "media:" + std::to_string(row_id);
-      auto result = WithInflightLimit(ctx, endpoint_id,
-          [&key, fanout](RedisClient& redis) {
-            return redis.lrange(key, 0, fanout - 1);
-          });
-
-      if (!result) {
-        // Fail on Redis errors (consistent with follow/recommendation)
-        error_msg = "media: " + result.error();
-        return;
-      }
+      keys.push_back("media:" + std::to_string(input.batch().getId(idx)));
+    });
+    auto lists = WithInflightLimit(ctx, endpoint_id,
+        [&keys, fanout](RedisClient& redis) {
+          return redis.lrange_batch(keys, 0, fanout - 1);
+        });
+
+    if (!lists) {
+      // Fail on Redis errors (consistent with follow/recommendation)
+      throw std::runtime_error("media: " + lists.error());
+    }
 
-      for (const auto& id_str : result.value()) {
+    // Collect all media IDs
+    std::vector<int64_t> media_ids;
+    uint64_t received = 0;
+    for (const auto& list : lists.value()) {
+      for (const auto& id_str : list) {
+        received += id_str.size();
         int64_t media_id = 0;
         auto [ptr, ec] = std::from_chars(
             id_str.data(), id_str.data() + id_str.size(), media_id);
@@ -98,15 +96,13 @@ class MediaTask {
           media_ids.push_back(media_id);
         }
       }
-    });
-
-    if (!error_msg.empty()) {
-      throw std::runtime_error(error_msg);
     }
+    ctx.addBytesReceived(received);
 
     // Create batch with media IDs
     size_t n = media_ids.size();
-    auto batch = std::make_shared<ColumnBatch>(n);
+    auto batch = std::make_shared<ColumnBatch>(n, nullptr, ctx.arena,
+                                               ColumnInit::Uninitialized);
 
     for (size_t i = 0; i < n; ++i) {
       batch->setId(i, media_ids[i]);
@@ -143,39 +139,31 @@ class MediaTask {
     }
     ranking::AsyncRedisClient& redis = **client_result;
 
-    // Collect all media IDs
-    std::vector<int64_t> media_ids;
     const auto& input = inputs[0];
-
     auto input_indices = input.materializeIndexViewForOutput(input.batch().size());
-    for (uint32_t idx : input_indices) {
-      int64_t row_id = input.batch().getId(idx);
 
-      // Fetch media list for this row's ID
-      std::string key = "media:" + std::to_string(row_id);
-      auto result = co_await redis.LRange(key, 0, fanout - 1);
+    // Fetch all media lists in one pipelined batch
+    std::vector<std::string> keys;
+    keys.reserve(input_indices.size());
+    for (uint32_t idx : input_indices) {
+      keys.push_back("media:" + std::to_string(input.batch().getId(idx)));
+    }
+    auto lists = co_await redis.LRangeIdsBatch(std::move(keys), 0, fanout - 1, ctx.arena,
+                                               ctx.cancel);
 
+    // Ids were decoded straight into arena columns; the batch adopts them
+    uint64_t received = 0;
+    for (const auto& result : lists) {
       if (!result) {
         throw std::runtime_error("media: " + result.error().message);
       }
-
-      for (const auto& id_str : result.value()) {
-        int64_t media_id = 0;
-        auto [ptr, ec] = std::from_chars(
-            id_str.data(), id_str.data() + id_str.size(), media_id);
-        if (ec == std::errc{}) {
-          media_ids.push_back(media_id);
-        }
-      }
+      received += result->bytes_received;
     }
+    ctx.addBytesReceived(received);
 
     // Create batch with media IDs
-    size_t n = media_ids.size();
-    auto batch = std::make_shared<ColumnBatch>(n);
-
-    for (size_t i = 0; i < n; ++i) {
-      batch->setId(i, media_ids[i]);
-    }
+    auto batch = std::make_shared<ColumnBatch>(
+        ranking::AsyncRedisClient::JoinIds(lists, ctx.arena), nullptr, ctx.arena);
 
     co_return RowSet(std::make_shared<ColumnBatch>(*batch));
   }
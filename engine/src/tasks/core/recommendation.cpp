@@ -2,12 +2,15 @@
 #include "async_io_clients.h"
 #include "coro_task.h"
 #include "endpoint_registry.h"
+#include "hydration_cache.h"
 #include "io_clients.h"
 #include "key_registry.h"
 #include "param_table.h"
 #include "redis_client.h"
 #include "task_registry.h"
 #include <charconv>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -42,7 +45,7 @@ class RecommendationTask {
         .default_budget = {.timeout_ms = 100},
         .output_pattern = OutputPattern::VariableDense,
         .writes_effect = std::nullopt,
-        .is_io = true,  // Redis LRANGE + HGETALL per recommendation
+        .is_io = true,  // Redis LRANGE + HMGET per recommendation
         .run_async = run_async,
     };
   }
@@ -74,25 +77,27 @@ class RecommendationTask {
     // Materialize input indices
     auto input_indices = input.materializeIndexViewForOutput(input.batch().size());
 
-    // Collect all recommendation IDs
-    std::vector<int64_t> all_recs;
-
+    // Fetch all recommendation lists in one pipelined batch (one inflight permit)
+    std::vector<std::string> list_keys;
+    list_keys.reserve(input_indices.size());
     for (uint32_t idx : input_indices) {
-      int64_t user_id = input.batch().getId(idx);
-
-      // Fetch recommendation list for this user (with inflight limiting)
-      std::string key = "recommendation:" + std::to_string(user_id);
-      auto result = WithInflightLimit(ctx, endpoint_id,
-          [&key, fanout](RedisClient& redis) {
-            return redis.lrange(key, 0, fanout - 1);
-          });
+      list_keys.push_back("recommendation:" + std::to_string(input.batch().getId(idx)));
+    }
+    auto lists = WithInflightLimit(ctx, endpoint_id,
+        [&list_keys, fanout](RedisClient& redis) {
+          return redis.lrange_batch(list_keys, 0, fanout - 1);
+        });
 
-      if (!result) {
-        throw std::runtime_error("recommendation: " + result.error());
-      }
+    if (!lists) {
+      throw std::runtime_error("recommendation: " + lists.error());
+    }
 
-      // Parse and collect recommendation IDs
-      for (const auto& rec_str : result.value()) {
+    // Collect all recommendation IDs
+    std::vector<int64_t> all_recs;
+    uint64_t received = 0;
+    for (const auto& list : lists.value()) {
+      for (const auto& rec_str : list) {
+        received += rec_str.size();
         int64_t id = 0;
         auto [ptr, ec] = std::from_chars(
             rec_str.data(), rec_str.data() + rec_str.size(), id);
@@ -102,51 +107,52 @@ class RecommendationTask {
         // Skip invalid IDs silently
       }
     }
+    ctx.addBytesReceived(received);
 
-    // Create batch with all recommendation IDs and hydrate country
+    // Create batch with all recommendation IDs
     size_t n = all_recs.size();
-    auto batch = std::make_shared<ColumnBatch>(n);
-
-    // Build country column (dictionary-encoded strings)
-    auto country_dict = std::make_shared<std::vector<std::string>>();
-    auto country_codes = std::make_shared<std::vector<int32_t>>(n, -1);
-    auto country_valid = std::make_shared<std::vector<uint8_t>>(n, 0);
-    std::unordered_map<std::string, int32_t> country_to_code;
-
+    auto batch = std::make_shared<ColumnBatch>(n, nullptr, ctx.arena,
+                                               ColumnInit::Uninitialized);
     for (size_t i = 0; i < n; ++i) {
-      int64_t rec_id = all_recs[i];
-      batch->setId(i, rec_id);
+      batch->setId(i, all_recs[i]);
+    }
 
-      // Fetch user data for this recommendation (with inflight limiting)
-      std::string user_key = "user:" + std::to_string(rec_id);
-      auto user_result = WithInflightLimit(ctx, endpoint_id,
-          [&user_key](RedisClient& redis) { return redis.hgetall(user_key); });
-      if (!user_result) {
-        // Fail on Redis errors (consistent with LRANGE above)
-        throw std::runtime_error("recommendation: " + user_result.error());
-      }
-      // Empty result means user doesn't exist - leave country as null
-      auto country_it = user_result.value().find("country");
-      if (country_it != user_result.value().end()) {
-        const std::string& country = country_it->second;
-        auto it = country_to_code.find(country);
-        if (it == country_to_code.end()) {
-          int32_t code = static_cast<int32_t>(country_dict->size());
-          country_dict->push_back(country);
-          country_to_code[country] = code;
-          (*country_codes)[i] = code;
-        } else {
-          (*country_codes)[i] = it->second;
+    // Always write the declared country column, but hydrate it only if a
+    // downstream node reads it; otherwise every row stays null
+    std::vector<std::optional<std::string>> countries(n);
+    if (ctx.isKeyLive(key_id(KeyId::country))) {
+      // Serve cached countries; HMGET only the misses in a second
+      // pipelined batch
+      auto& cache = HydrationCache::instance();
+      auto missed = cache.lookupMany(endpoint_id, all_recs, key_id(KeyId::country), countries);
+      if (!missed.empty()) {
+        std::vector<std::string> user_keys;
+        user_keys.reserve(missed.size());
+        for (size_t i : missed) {
+          user_keys.push_back("user:" + std::to_string(all_recs[i]));
         }
-        (*country_valid)[i] = 1;
+        const std::vector<std::string> fields = {"country"};
+        auto users = WithInflightLimit(ctx, endpoint_id,
+            [&user_keys, &fields](RedisClient& redis) {
+              return redis.hmget_batch(user_keys, fields);
+            });
+        if (!users) {
+          // Fail on Redis errors (consistent with LRANGE above)
+          throw std::runtime_error("recommendation: " + users.error());
+        }
+
+        received = 0;
+        for (size_t j = 0; j < missed.size(); ++j) {
+          auto& country = users.value()[j][0];
+          received += country ? country->size() : 0;
+          cache.insert(endpoint_id, all_recs[missed[j]], key_id(KeyId::country), country);
+          countries[missed[j]] = std::move(country);
+        }
+        ctx.addBytesReceived(received);
       }
-      // If user not found or no country field, leave as null (valid=0, code=-1)
     }
-
-    // Add country column
-    auto country_col = std::make_shared<StringDictColumn>(
-        country_dict, country_codes, country_valid);
-    *batch = batch->withStringColumn(key_id(KeyId::country), country_col);
+    *batch = batch->withStringColumn(key_id(KeyId::country),
+                                     build_country_column(countries));
 
     return RowSet(std::make_shared<ColumnBatch>(*batch));
   }
@@ -185,82 +191,98 @@ class RecommendationTask {
     // Materialize input indices
     auto input_indices = input.materializeIndexViewForOutput(input.batch().size());
 
-    // Collect all recommendation IDs
-    std::vector<int64_t> all_recs;
-
+    // Fetch all recommendation lists in one pipelined batch
+    std::vector<std::string> list_keys;
+    list_keys.reserve(input_indices.size());
     for (uint32_t idx : input_indices) {
-      int64_t user_id = input.batch().getId(idx);
-
-      // Fetch recommendation list for this user
-      std::string key = "recommendation:" + std::to_string(user_id);
-      auto result = co_await redis.LRange(key, 0, fanout - 1);
+      list_keys.push_back("recommendation:" + std::to_string(input.batch().getId(idx)));
+    }
+    auto lists = co_await redis.LRangeIdsBatch(std::move(list_keys), 0, fanout - 1,
+                                              ctx.arena, ctx.cancel);
 
+    // Ids were decoded straight into arena columns; the batch adopts them
+    uint64_t received = 0;
+    for (const auto& result : lists) {
       if (!result) {
         throw std::runtime_error("recommendation: " + result.error().message);
       }
+      received += result->bytes_received;
+    }
+    ctx.addBytesReceived(received);
 
-      // Parse and collect recommendation IDs
-      for (const auto& rec_str : result.value()) {
-        int64_t id = 0;
-        auto [ptr, ec] = std::from_chars(
-            rec_str.data(), rec_str.data() + rec_str.size(), id);
-        if (ec == std::errc{}) {
-          all_recs.push_back(id);
+    auto ids = ranking::AsyncRedisClient::JoinIds(lists, ctx.arena);
+    std::span<const int64_t> all_recs(ids->values);
+    size_t n = all_recs.size();
+    auto batch = std::make_shared<ColumnBatch>(std::move(ids), nullptr, ctx.arena);
+
+    // Always write the declared country column, but hydrate it only if a
+    // downstream node reads it; otherwise every row stays null
+    std::vector<std::optional<std::string>> countries(n);
+    if (ctx.isKeyLive(key_id(KeyId::country))) {
+      // Serve cached countries; HMGET only the misses in a second
+      // pipelined batch
+      auto& cache = HydrationCache::instance();
+      auto missed = cache.lookupMany(endpoint_id, all_recs, key_id(KeyId::country), countries);
+      if (!missed.empty()) {
+        std::vector<std::string> user_keys;
+        user_keys.reserve(missed.size());
+        for (size_t i : missed) {
+          user_keys.push_back("user:" + std::to_string(all_recs[i]));
+        }
+        std::vector<std::string> fields = {"country"};
+        auto users = co_await redis.HMGetBatch(std::move(user_keys), std::move(fields),
+                                               ctx.cancel);
+
+        received = 0;
+        for (size_t j = 0; j < missed.size(); ++j) {
+          auto& user_result = users[j];
+          if (!user_result) {
+            throw std::runtime_error("recommendation: " + user_result.error().message);
+          }
+          auto& country = user_result.value()[0];
+          received += country ? country->size() : 0;
+          cache.insert(endpoint_id, all_recs[missed[j]], key_id(KeyId::country), country);
+          countries[missed[j]] = std::move(country);
         }
+        ctx.addBytesReceived(received);
       }
     }
+    *batch = batch->withStringColumn(key_id(KeyId::country),
+                                     build_country_column(countries));
 
-    // Create batch with all recommendation IDs and hydrate country
-    size_t n = all_recs.size();
-    auto batch = std::make_shared<ColumnBatch>(n);
+    co_return RowSet(std::make_shared<ColumnBatch>(*batch));
+  }
 
-    // Build country column (dictionary-encoded strings)
+ private:
+  // Dictionary-encode hydrated country values; nullopt (user or field
+  // absent) leaves the row null (valid=0, code=-1)
+  static std::shared_ptr<StringDictColumn> build_country_column(
+      const std::vector<std::optional<std::string>>& countries) {
+    size_t n = countries.size();
     auto country_dict = std::make_shared<std::vector<std::string>>();
     auto country_codes = std::make_shared<std::vector<int32_t>>(n, -1);
     auto country_valid = std::make_shared<std::vector<uint8_t>>(n, 0);
     std::unordered_map<std::string, int32_t> country_to_code;
 
     for (size_t i = 0; i < n; ++i) {
-      int64_t rec_id = all_recs[i];
-      batch->setId(i, rec_id);
-
-      // Fetch user data for this recommendation
-      std::string user_key = "user:" + std::to_string(rec_id);
-      auto user_result = co_await redis.HGetAll(user_key);
-      if (!user_result) {
-        throw std::runtime_error("recommendation: " + user_result.error().message);
+      if (!countries[i]) {
+        continue;
       }
-
-      // Parse HGETALL result (alternating field/value pairs)
-      const auto& pairs = user_result.value();
-      std::string country_value;
-      for (size_t j = 0; j + 1 < pairs.size(); j += 2) {
-        if (pairs[j] == "country") {
-          country_value = pairs[j + 1];
-          break;
-        }
-      }
-
-      if (!country_value.empty()) {
-        auto it = country_to_code.find(country_value);
-        if (it == country_to_code.end()) {
-          int32_t code = static_cast<int32_t>(country_dict->size());
-          country_dict->push_back(country_value);
-          country_to_code[country_value] = code;
-          (*country_codes)[i] = code;
-        } else {
-          (*country_codes)[i] = it->second;
-        }
-        (*country_valid)[i] = 1;
+      const std::string& country = *countries[i];
+      auto it = country_to_code.find(country);
+      if (it == country_to_code.end()) {
+        int32_t code = static_cast<int32_t>(country_dict->size());
+        country_dict->push_back(country);
+        country_to_code[country] = code;
+        (*country_codes)[i] = code;
+      } else {
+        (*country_codes)[i] = it->second;
       }
+      (*country_valid)[i] = 1;
     }
 
-    // Add country column
-    auto country_col = std::make_shared<StringDictColumn>(
-        country_dict, country_codes, country_valid);
-    *batch = batch->withStringColumn(key_id(KeyId::country), country_col);
-
-    co_return RowSet(std::make_shared<ColumnBatch>(*batch));
+    return std::make_shared<StringDictColumn>(country_dict, country_codes,
+                                              country_valid);
   }
 };
 
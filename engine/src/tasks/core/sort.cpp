@@ -16,7 +16,10 @@ public:
     return TaskSpec{
         .op = "sort",
         .params_schema = {
-            {.name = "by", .type = TaskParamType::Int, .required = true},
+            {.name = "by",
+             .type = TaskParamType::Int,
+             .required = true,
+             .reads_key = true},
             {.name = "order",
              .type = TaskParamType::String,
              .required = false,
@@ -32,6 +35,7 @@ public:
         .default_budget = {.timeout_ms = 50},
         .output_pattern = OutputPattern::PermutationOfInput,
         // writes_effect omitted - no column writes
+        .inline_row_cost_ns = 100,  // n log n, but cheap at inline sizes
     };
   }
 
@@ -75,8 +79,8 @@ public:
                                "' is blocked");
     }
 
-    // Gather active rows in current iteration order for stable sorting.
-    Permutation active_rows = input.activeRows().toVector(input.rowCount());
+    // Active rows in current iteration order, stably sorted by the key
+    RowSet sorted = input;
 
     auto null_first_cmp = [ascending](bool a_null,
                                       bool b_null) -> std::optional<bool> {
@@ -114,7 +118,7 @@ public:
         }
         return ascending ? av < bv : av > bv;
       };
-      std::stable_sort(active_rows.begin(), active_rows.end(), comp);
+      sorted = input.sortActive(comp);
       break;
     }
 
@@ -141,7 +145,7 @@ public:
         }
         return ascending ? av < bv : av > bv;
       };
-      std::stable_sort(active_rows.begin(), active_rows.end(), comp);
+      sorted = input.sortActive(comp);
       break;
     }
 
@@ -181,7 +185,7 @@ public:
         return ascending ? *a_val < *b_val : *a_val > *b_val;
       };
 
-      std::stable_sort(active_rows.begin(), active_rows.end(), comp);
+      sorted = input.sortActive(comp);
       break;
     }
 
@@ -192,7 +196,7 @@ public:
     }
     }
 
-    return input.withOrder(std::move(active_rows));
+    return sorted;
   }
 };
 
@@ -21,6 +21,7 @@ public:
         .default_budget = {.timeout_ms = 10},
         .output_pattern = OutputPattern::PrefixOfInput,
         // writes_effect omitted - no column writes
+        .inline_row_cost_ns = 1,  // truncateTo: a selection, no copies
     };
   }
 
@@ -2,12 +2,14 @@
 #include "async_io_clients.h"
 #include "coro_task.h"
 #include "endpoint_registry.h"
+#include "hydration_cache.h"
 #include "io_clients.h"
 #include "param_table.h"
 #include "redis_client.h"
 #include "request.h"
 #include "task_registry.h"
 #include <coroutine>
+#include <optional>
 #include <stdexcept>
 
 namespace rankd {
@@ -37,7 +39,7 @@ class ViewerTask {
         .default_budget = {.timeout_ms = 100},
         .output_pattern = OutputPattern::VariableDense,
         .writes_effect = std::nullopt,
-        .is_io = true,  // Redis HGETALL
+        .is_io = true,  // Redis HMGET
         .run_async = run_async,
     };
   }
@@ -55,42 +57,34 @@ class ViewerTask {
     }
     uint32_t user_id = ctx.request->user_id;
 
-    // Get endpoint and fetch user data with inflight limiting
-    const std::string& endpoint_id = params.get_string("endpoint");
-    std::string key = "user:" + std::to_string(user_id);
-
-    auto result = WithInflightLimit(ctx, endpoint_id,
-        [&key](RedisClient& redis) { return redis.hgetall(key); });
-
-    if (!result) {
-      throw std::runtime_error("viewer: " + result.error());
-    }
-
-    const auto& user_data = result.value();
-
     // Create single-row batch
-    auto batch = std::make_shared<ColumnBatch>(1);
+    auto batch = std::make_shared<ColumnBatch>(1, nullptr, ctx.arena);
     batch->setId(0, static_cast<int64_t>(user_id));
 
-    // Add country column
-    auto country_it = user_data.find("country");
-    if (country_it != user_data.end()) {
-      auto country_dict =
-          std::make_shared<std::vector<std::string>>(1, country_it->second);
-      auto country_codes = std::make_shared<std::vector<int32_t>>(1, 0);
-      auto country_valid = std::make_shared<std::vector<uint8_t>>(1, 1);
-      auto country_col = std::make_shared<StringDictColumn>(
-          country_dict, country_codes, country_valid);
-      *batch = batch->withStringColumn(key_id(KeyId::country), country_col);
-    } else {
-      // No country data - create null column
-      auto country_dict = std::make_shared<std::vector<std::string>>();
-      auto country_codes = std::make_shared<std::vector<int32_t>>(1, -1);
-      auto country_valid = std::make_shared<std::vector<uint8_t>>(1, 0);
-      auto country_col = std::make_shared<StringDictColumn>(
-          country_dict, country_codes, country_valid);
-      *batch = batch->withStringColumn(key_id(KeyId::country), country_col);
+    // Always write the declared country column, but fetch it only if a
+    // downstream node reads it; otherwise the row stays null
+    std::optional<std::string> country;
+    if (ctx.isKeyLive(key_id(KeyId::country))) {
+      auto& cache = HydrationCache::instance();
+      const std::string& endpoint_id = params.get_string("endpoint");
+      if (!cache.lookup(endpoint_id, user_id, key_id(KeyId::country), country)) {
+        std::string key = "user:" + std::to_string(user_id);
+        const std::vector<std::string> fields = {"country"};
+
+        auto result = WithInflightLimit(ctx, endpoint_id,
+            [&key, &fields](RedisClient& redis) { return redis.hmget(key, fields); });
+
+        if (!result) {
+          throw std::runtime_error("viewer: " + result.error());
+        }
+
+        country = std::move(result.value()[0]);
+        ctx.addBytesReceived(country ? country->size() : 0);
+        cache.insert(endpoint_id, user_id, key_id(KeyId::country), country);
+      }
     }
+    *batch = batch->withStringColumn(key_id(KeyId::country),
+                                     build_country_column(country));
 
     return RowSet(std::make_shared<ColumnBatch>(*batch));
   }
@@ -109,56 +103,60 @@ class ViewerTask {
     }
     uint32_t user_id = ctx.request->user_id;
 
-    // Get endpoint and Redis client
-    const std::string& endpoint_id = params.get_string("endpoint");
-    std::string key = "user:" + std::to_string(user_id);
-
-    // Get async Redis client
-    auto client_result = ctx.async_clients->GetRedis(
-        *ctx.loop, *ctx.endpoints, endpoint_id);
-    if (!client_result) {
-      throw std::runtime_error("viewer: " + client_result.error());
-    }
-    ranking::AsyncRedisClient& redis = **client_result;
-
-    // Fetch user data asynchronously
-    auto result = co_await redis.HGetAll(key);
-    if (!result) {
-      throw std::runtime_error("viewer: " + result.error().message);
-    }
+    // Create single-row batch
+    auto batch = std::make_shared<ColumnBatch>(1, nullptr, ctx.arena);
+    batch->setId(0, static_cast<int64_t>(user_id));
 
-    // Parse result (alternating field/value pairs)
-    const auto& pairs = result.value();
-    std::unordered_map<std::string, std::string> user_data;
-    for (size_t i = 0; i + 1 < pairs.size(); i += 2) {
-      user_data[pairs[i]] = pairs[i + 1];
+    // Always write the declared country column, but fetch it only if a
+    // downstream node reads it; otherwise the row stays null
+    std::optional<std::string> country;
+    if (ctx.isKeyLive(key_id(KeyId::country))) {
+      auto& cache = HydrationCache::instance();
+      const std::string& endpoint_id = params.get_string("endpoint");
+      if (!cache.lookup(endpoint_id, user_id, key_id(KeyId::country), country)) {
+        // Get async Redis client
+        auto client_result = ctx.async_clients->GetRedis(
+            *ctx.loop, *ctx.endpoints, endpoint_id);
+        if (!client_result) {
+          throw std::runtime_error("viewer: " + client_result.error());
+        }
+        ranking::AsyncRedisClient& redis = **client_result;
+
+        // Fetch the country field asynchronously
+        std::string key = "user:" + std::to_string(user_id);
+        std::vector<std::string> fields = {"country"};
+        auto result = co_await redis.HMGet(key, fields, ctx.cancel);
+        if (!result) {
+          throw std::runtime_error("viewer: " + result.error().message);
+        }
+
+        country = std::move(result.value()[0]);
+        ctx.addBytesReceived(country ? country->size() : 0);
+        cache.insert(endpoint_id, user_id, key_id(KeyId::country), country);
+      }
     }
+    *batch = batch->withStringColumn(key_id(KeyId::country),
+                                     build_country_column(country));
 
-    // Create single-row batch
-    auto batch = std::make_shared<ColumnBatch>(1);
-    batch->setId(0, static_cast<int64_t>(user_id));
+    co_return RowSet(std::make_shared<ColumnBatch>(*batch));
+  }
 
-    // Add country column
-    auto country_it = user_data.find("country");
-    if (country_it != user_data.end()) {
-      auto country_dict =
-          std::make_shared<std::vector<std::string>>(1, country_it->second);
-      auto country_codes = std::make_shared<std::vector<int32_t>>(1, 0);
-      auto country_valid = std::make_shared<std::vector<uint8_t>>(1, 1);
-      auto country_col = std::make_shared<StringDictColumn>(
-          country_dict, country_codes, country_valid);
-      *batch = batch->withStringColumn(key_id(KeyId::country), country_col);
-    } else {
-      // No country data - create null column
+ private:
+  // Single-row country column; nullopt (user or field absent) is null
+  static std::shared_ptr<StringDictColumn> build_country_column(
+      const std::optional<std::string>& country) {
+    if (!country) {
       auto country_dict = std::make_shared<std::vector<std::string>>();
       auto country_codes = std::make_shared<std::vector<int32_t>>(1, -1);
       auto country_valid = std::make_shared<std::vector<uint8_t>>(1, 0);
-      auto country_col = std::make_shared<StringDictColumn>(
-          country_dict, country_codes, country_valid);
-      *batch = batch->withStringColumn(key_id(KeyId::country), country_col);
+      return std::make_shared<StringDictColumn>(country_dict, country_codes,
+                                                country_valid);
     }
-
-    co_return RowSet(std::make_shared<ColumnBatch>(*batch));
+    auto country_dict = std::make_shared<std::vector<std::string>>(1, *country);
+    auto country_codes = std::make_shared<std::vector<int32_t>>(1, 0);
+    auto country_valid = std::make_shared<std::vector<uint8_t>>(1, 1);
+    return std::make_shared<StringDictColumn>(country_dict, country_codes,
+                                              country_valid);
   }
 };
 
@@ -26,6 +26,7 @@ public:
         .default_budget = {.timeout_ms = 50},
         .output_pattern = OutputPattern::UnaryPreserveView,
         .writes_effect = EffectFromParam{"out_key"},
+        .inline_row_cost_ns = 20,
     };
   }
 
@@ -83,13 +84,17 @@ public:
     const auto &input = inputs[0];
     size_t n = input.batch().size();
 
-    // Create new float column
-    auto col = std::make_shared<FloatColumn>(n);
+    // Create new float column in the input batch's memory resource. Values
+    // are only read where valid, and every valid row is written below, so
+    // skip the zero-fill.
+    auto col = std::make_shared<FloatColumn>(n, ColumnInit::Uninitialized,
+                                             input.batch().resource());
 
     // Evaluate expression for each active row
+    const ColumnBatch &batch = input.batch();
     bool has_null_active = false;
-    input.activeRows().forEachIndex([&](RowIndex row) {
-      ExprResult result = eval_expr(expr, row, input.batch(), ctx);
+    auto eval_row = [&](RowIndex row) {
+      ExprResult result = eval_expr(expr, row, batch, ctx);
 
       if (!result) {
         has_null_active = true;
@@ -105,7 +110,25 @@ public:
         col->values[row] = val;
         col->valid[row] = 1;
       }
-    });
+    };
+
+    // One kernel per selection representation: a plain loop for all rows, a
+    // word scan for a bitmap, a gather for an index list
+    auto active = input.activeRows();
+    if (active.isAllRows()) {
+      for (size_t row = 0; row < n; ++row) {
+        eval_row(static_cast<RowIndex>(row));
+      }
+    } else if (const auto *bits = active.bitmap()) {
+      bits->forEachSet([&](RowIndex row) {
+        eval_row(row);
+        return true;
+      });
+    } else {
+      for (RowIndex row : *active.indices()) {
+        eval_row(row);
+      }
+    }
 
     // If out_key is not nullable and any active row is null => error
     if (!key_meta->nullable && has_null_active) {
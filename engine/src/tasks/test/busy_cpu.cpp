@@ -38,9 +38,16 @@ class BusyCpuTask {
         .writes_effect = std::nullopt,
         .is_io = false,
         // NOTE: No run_async - this forces async scheduler to use OffloadCpu
+        .estimate_cost_us = estimate_cost_us,
     };
   }
 
+  static double estimate_cost_us(const nlohmann::json& params) {
+    const auto it = params.find("busy_wait_ms");
+    return it != params.end() && it->is_number() ? it->get<double>() * 1000.0
+                                                 : 0.0;
+  }
+
   static RowSet run(const std::vector<RowSet>& inputs,
                     const ValidatedParams& params,
                     [[maybe_unused]] const ExecCtx& ctx) {
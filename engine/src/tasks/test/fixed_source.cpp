@@ -45,7 +45,7 @@ class FixedSourceTask {
 
   static RowSet run(const std::vector<RowSet>& inputs,
                     const ValidatedParams& params,
-                    [[maybe_unused]] const ExecCtx& ctx) {
+                    const ExecCtx& ctx) {
     if (!inputs.empty()) {
       throw std::runtime_error("fixed_source: expected 0 inputs");
     }
@@ -56,7 +56,8 @@ class FixedSourceTask {
     }
 
     // Create batch with deterministic IDs
-    auto batch = std::make_shared<ColumnBatch>(static_cast<size_t>(row_count));
+    auto batch = std::make_shared<ColumnBatch>(static_cast<size_t>(row_count), nullptr,
+                                               ctx.arena, ColumnInit::Uninitialized);
     for (size_t i = 0; i < static_cast<size_t>(row_count); ++i) {
       batch->setId(i, static_cast<int64_t>(i + 1));  // IDs: 1, 2, 3, ...
     }
@@ -67,7 +68,7 @@ class FixedSourceTask {
   // Async version - immediately returns (no IO, no busy wait)
   static ranking::Task<RowSet> run_async(const std::vector<RowSet>& inputs,
                                           const ValidatedParams& params,
-                                          [[maybe_unused]] const ranking::ExecCtxAsync& ctx) {
+                                          const ranking::ExecCtxAsync& ctx) {
     if (!inputs.empty()) {
       throw std::runtime_error("fixed_source: expected 0 inputs");
     }
@@ -78,7 +79,8 @@ class FixedSourceTask {
     }
 
     // Create batch with deterministic IDs
-    auto batch = std::make_shared<ColumnBatch>(static_cast<size_t>(row_count));
+    auto batch = std::make_shared<ColumnBatch>(static_cast<size_t>(row_count), nullptr,
+                                               ctx.arena, ColumnInit::Uninitialized);
     for (size_t i = 0; i < static_cast<size_t>(row_count); ++i) {
       batch->setId(i, static_cast<int64_t>(i + 1));  // IDs: 1, 2, 3, ...
     }
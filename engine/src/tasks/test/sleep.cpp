@@ -34,9 +34,16 @@ public:
         .output_pattern = OutputPattern::UnaryPreserveView,
         // writes_effect omitted - identity transform
         .run_async = run_async,
+        .estimate_cost_us = estimate_cost_us,
     };
   }
 
+  static double estimate_cost_us(const nlohmann::json &params) {
+    const auto it = params.find("duration_ms");
+    return it != params.end() && it->is_number() ? it->get<double>() * 1000.0
+                                                 : 0.0;
+  }
+
   static RowSet run(const std::vector<RowSet> &inputs,
                     const ValidatedParams &params,
                     [[maybe_unused]] const ExecCtx &ctx) {
@@ -74,9 +81,12 @@ public:
       throw std::runtime_error("sleep: 'duration_ms' must be >= 0");
     }
 
-    // Async sleep using libuv timer
+    // Async sleep using libuv timer; ends early if the request is cancelled
     if (duration_ms > 0) {
-      co_await ranking::SleepMs(*ctx.loop, static_cast<uint64_t>(duration_ms));
+      co_await ranking::SleepMs(*ctx.loop, static_cast<uint64_t>(duration_ms), ctx.cancel);
+      if (ctx.cancel.cancelled()) {
+        throw std::runtime_error("sleep: cancelled");
+      }
     }
 
     // Fault injection for testing (throws AFTER async sleep completes)
@@ -0,0 +1,150 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace ranking {
+
+void TimerWheel::Entry::cancel() {
+  if (head_) {
+    wheel_->unlink(*this);
+  }
+}
+
+TimerWheel::TimerWheel(uv_loop_t *loop) : loop_(loop) {
+  uv_timer_init(loop_, &tick_timer_);
+  tick_timer_.data = this;
+}
+
+TimerWheel::~TimerWheel() {
+  // Owners may outlive the wheel (e.g. states freed after the loop stops)
+  auto detach = [](Entry *e) {
+    while (e) {
+      Entry *next = e->next_;
+      e->head_ = nullptr;
+      e->prev_ = e->next_ = nullptr;
+      e->wheel_ = nullptr;
+      e = next;
+    }
+  };
+  for (Entry *head : slots_) {
+    detach(head);
+  }
+  detach(expired_);
+}
+
+void TimerWheel::close() {
+  uv_timer_stop(&tick_timer_);
+  running_ = false;
+  armed_tick_ = kNotArmed;
+  if (!uv_is_closing(reinterpret_cast<uv_handle_t *>(&tick_timer_))) {
+    uv_close(reinterpret_cast<uv_handle_t *>(&tick_timer_), nullptr);
+  }
+}
+
+void TimerWheel::link(Entry &entry, Entry **head) {
+  entry.head_ = head;
+  entry.prev_ = nullptr;
+  entry.next_ = *head;
+  if (*head) {
+    (*head)->prev_ = &entry;
+  }
+  *head = &entry;
+  ++size_;
+}
+
+void TimerWheel::unlink(Entry &entry) {
+  if (entry.prev_) {
+    entry.prev_->next_ = entry.next_;
+  } else {
+    *entry.head_ = entry.next_;
+  }
+  if (entry.next_) {
+    entry.next_->prev_ = entry.prev_;
+  }
+  entry.head_ = nullptr;
+  entry.prev_ = entry.next_ = nullptr;
+  --size_;
+}
+
+void TimerWheel::schedule(Entry &entry, uint64_t delay_ms,
+                          Entry::Callback callback) {
+  entry.cancel();
+
+  uint64_t now = uv_now(loop_);
+  if (!running_) {
+    // Idle wheel: nothing pending, so restart the tick count from now
+    current_tick_ = now;
+    running_ = true;
+  }
+
+  entry.wheel_ = this;
+  entry.callback_ = callback;
+  entry.expiry_tick_ = now + std::max<uint64_t>(delay_ms, kTickMs);
+  link(entry, &slots_[entry.expiry_tick_ & (kSlots - 1)]);
+
+  // Cancelled entries do not disarm the timer, so it may already be armed
+  // earlier than needed; only an earlier expiry moves it
+  if (entry.expiry_tick_ < armed_tick_) {
+    arm(entry.expiry_tick_, now);
+  }
+}
+
+void TimerWheel::arm(uint64_t tick, uint64_t now_ms) {
+  armed_tick_ = tick;
+  uv_timer_start(&tick_timer_, OnTick, tick > now_ms ? tick - now_ms : 0, 0);
+}
+
+uint64_t TimerWheel::next_expiry() const {
+  // Everything up to current_tick_ has fired, so the first tick ahead whose
+  // slot holds an entry due on that very tick is the earliest expiry. With
+  // none in a whole lap, every entry was seen: take their minimum.
+  uint64_t earliest = kNotArmed;
+  for (uint64_t tick = current_tick_ + 1; tick <= current_tick_ + kSlots;
+       ++tick) {
+    for (Entry *e = slots_[tick & (kSlots - 1)]; e; e = e->next_) {
+      if (e->expiry_tick_ == tick) {
+        return tick;
+      }
+      earliest = std::min(earliest, e->expiry_tick_);
+    }
+  }
+  return earliest;
+}
+
+void TimerWheel::OnTick(uv_timer_t *timer) {
+  auto *wheel = static_cast<TimerWheel *>(timer->data);
+  wheel->advance(uv_now(wheel->loop_));
+}
+
+void TimerWheel::advance(uint64_t now_ms) {
+  ++ticks_;
+  armed_tick_ = 0;  // Callbacks' schedule() calls leave arming to us
+  // Catch up tick by tick if the loop was busy for longer than kTickMs
+  while (current_tick_ < now_ms) {
+    ++current_tick_;
+    Entry *e = slots_[current_tick_ & (kSlots - 1)];
+    while (e) {
+      Entry *next = e->next_;
+      if (e->expiry_tick_ <= current_tick_) {
+        unlink(*e);
+        link(*e, &expired_);
+      }
+      e = next;
+    }
+    // Callbacks may cancel or schedule other entries, including ones
+    // still waiting in expired_
+    while (Entry *due = expired_) {
+      unlink(*due);
+      due->callback_(due);
+    }
+  }
+
+  if (size_ == 0) {
+    running_ = false;
+    armed_tick_ = kNotArmed;
+    return;
+  }
+  arm(next_expiry(), now_ms);
+}
+
+} // namespace ranking
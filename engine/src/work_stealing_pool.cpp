@@ -0,0 +1,258 @@
+#include "work_stealing_pool.h"
+
+#include <exception>
+#include <iostream>
+
+namespace rankd {
+
+namespace {
+
+constexpr int64_t kInitialDequeCapacity = 256;
+
+// Find-job rounds (with a yield between them) before a worker sleeps
+constexpr int kSpinRounds = 2;
+
+// Pool and worker index of the current thread, if it is a pool worker
+thread_local const void *tls_pool = nullptr;
+thread_local size_t tls_index = 0;
+
+uint64_t next_random(uint64_t &state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+} // namespace
+
+// =============================================================================
+// Deque
+// =============================================================================
+
+WorkStealingPool::Deque::Deque() {
+  arrays_.push_back(std::make_unique<Array>(kInitialDequeCapacity));
+  array_.store(arrays_.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingPool::Deque::~Deque() = default;
+
+WorkStealingPool::Deque::Array *
+WorkStealingPool::Deque::grow(Array *old, int64_t bottom, int64_t top) {
+  auto bigger = std::make_unique<Array>(old->capacity * 2);
+  for (int64_t i = top; i < bottom; ++i) {
+    bigger->put(i, old->get(i));
+  }
+  Array *result = bigger.get();
+  arrays_.push_back(std::move(bigger));
+  array_.store(result, std::memory_order_release);
+  return result;
+}
+
+void WorkStealingPool::Deque::push(Job *job) {
+  int64_t b = bottom_.load(std::memory_order_relaxed);
+  int64_t t = top_.load(std::memory_order_acquire);
+  Array *a = array_.load(std::memory_order_relaxed);
+  if (b - t > a->capacity - 1) {
+    a = grow(a, b, t);
+  }
+  a->put(b, job);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(b + 1, std::memory_order_relaxed);
+}
+
+WorkStealingPool::Job *WorkStealingPool::Deque::pop() {
+  int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+  Array *a = array_.load(std::memory_order_relaxed);
+  bottom_.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t t = top_.load(std::memory_order_relaxed);
+  if (t > b) {
+    // Empty
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  Job *job = a->get(b);
+  if (t == b) {
+    // Last job: race thieves for it
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      job = nullptr;
+    }
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+  return job;
+}
+
+WorkStealingPool::Job *WorkStealingPool::Deque::steal() {
+  int64_t t = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t b = bottom_.load(std::memory_order_acquire);
+  if (t >= b) {
+    return nullptr;
+  }
+  Array *a = array_.load(std::memory_order_acquire);
+  Job *job = a->get(t);
+  if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    return nullptr; // Lost the race to the owner or another thief
+  }
+  return job;
+}
+
+// =============================================================================
+// WorkStealingPool
+// =============================================================================
+
+WorkStealingPool::WorkStealingPool(size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = 1;
+  }
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+    workers_.back()->rng = 0x9e3779b97f4a7c15ULL * (i + 1);
+  }
+  // Start threads only once every worker exists: they steal from each other
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_.store(true);
+  }
+  sleep_cv_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+void WorkStealingPool::enqueue(Job *job) {
+  if (stop_.load()) {
+    delete job;
+    throw std::runtime_error("submit on stopped WorkStealingPool");
+  }
+  in_flight_.fetch_add(1);
+  // Count before publishing so a thief never takes an uncounted job
+  queued_.fetch_add(1);
+
+  if (tls_pool == this) {
+    // Nested submit from one of our workers: LIFO on its own deque
+    workers_[tls_index]->deque.push(job);
+  } else {
+    Worker &worker =
+        *workers_[next_inbox_.fetch_add(1, std::memory_order_relaxed) %
+                  workers_.size()];
+    std::lock_guard<std::mutex> lock(worker.inbox_mutex);
+    worker.inbox.push_back(job);
+  }
+
+  // queued_ and sleepers_ are both seq_cst: either we see the sleeper and
+  // wake it, or it sees the job before waiting.
+  if (sleepers_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_one();
+  }
+}
+
+WorkStealingPool::Job *WorkStealingPool::pop_inbox(Worker &worker) {
+  std::lock_guard<std::mutex> lock(worker.inbox_mutex);
+  if (worker.inbox.empty()) {
+    return nullptr;
+  }
+  Job *job = worker.inbox.front();
+  worker.inbox.pop_front();
+  return job;
+}
+
+WorkStealingPool::Job *WorkStealingPool::find_job(size_t index) {
+  Worker &self = *workers_[index];
+  if (Job *job = self.deque.pop()) {
+    return job;
+  }
+  if (Job *job = pop_inbox(self)) {
+    return job;
+  }
+
+  size_t n = workers_.size();
+  size_t start = static_cast<size_t>(next_random(self.rng) % n);
+  for (size_t k = 0; k < n; ++k) {
+    size_t victim = (start + k) % n;
+    if (victim == index) {
+      continue;
+    }
+    Worker &other = *workers_[victim];
+    Job *job = other.deque.steal();
+    if (job == nullptr) {
+      job = pop_inbox(other);
+    }
+    if (job != nullptr) {
+      steals_.fetch_add(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingPool::run_job(Job *job) {
+  queued_.fetch_sub(1);
+  // Counts the job done even if it throws, so wait_idle() still returns
+  struct Finished {
+    WorkStealingPool *pool;
+    ~Finished() {
+      if (pool->in_flight_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(pool->idle_mutex_);
+        pool->idle_cv_.notify_all();
+      }
+    }
+  } finished{this};
+  std::unique_ptr<Job> owned(job);
+
+  // A post() job has no one to rethrow to: log it and keep the worker alive
+  try {
+    owned->run();
+  } catch (const std::exception &e) {
+    std::cerr << "Error: WorkStealingPool job threw: " << e.what() << std::endl;
+  } catch (...) {
+    std::cerr << "Error: WorkStealingPool job threw a non-std exception" << std::endl;
+  }
+}
+
+void WorkStealingPool::worker_loop(size_t index) {
+  tls_pool = this;
+  tls_index = index;
+
+  while (true) {
+    Job *job = nullptr;
+    for (int round = 0; round < kSpinRounds && job == nullptr; ++round) {
+      if (round > 0) {
+        std::this_thread::yield();
+      }
+      job = find_job(index);
+    }
+    if (job != nullptr) {
+      run_job(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleepers_.fetch_add(1);
+    sleep_cv_.wait(lock, [this] { return stop_.load() || queued_.load() > 0; });
+    sleepers_.fetch_sub(1);
+    // Drain everything before exiting, like ThreadPool
+    if (stop_.load() && queued_.load() == 0) {
+      return;
+    }
+  }
+}
+
+void WorkStealingPool::wait_idle() {
+  std::unique_lock<std::mutex> lock(idle_mutex_);
+  idle_cv_.wait(lock, [this] { return in_flight_.load() == 0; });
+}
+
+} // namespace rankd
@@ -1,16 +1,29 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <fstream>
 #include <thread>
 #include <vector>
 
+#include <nlohmann/json.hpp>
+
 #include "async_inflight_limiter.h"
 #include "async_io_clients.h"
 #include "async_redis_client.h"
+#include "cancellation.h"
 #include "coro_task.h"
 #include "event_loop.h"
+#include "request_arena.h"
 #include "uv_sleep.h"
 
 using namespace ranking;
@@ -172,6 +185,124 @@ TEST_CASE("AsyncInflightLimiter FIFO ordering", "[async_limiter]") {
   REQUIRE(completion_order[2] == 2);
 }
 
+TEST_CASE("AsyncInflightLimiter adaptive limit backs off and recovers", "[async_limiter]") {
+  using std::chrono::milliseconds;
+  using std::chrono::seconds;
+
+  AsyncInflightLimiter limiter(16);
+  limiter.enable_adaptive(2);
+  REQUIRE(limiter.adaptive());
+  REQUIRE(limiter.max_permits() == 16);
+
+  for (int i = 0; i < 16; ++i) {
+    REQUIRE(limiter.try_acquire());
+  }
+
+  // Fast replies at the ceiling keep it there
+  for (int i = 0; i < 10; ++i) {
+    limiter.on_sample(milliseconds(1), false);
+  }
+  REQUIRE(limiter.max_permits() == 16);
+
+  // A dropped command backs off multiplicatively...
+  limiter.on_sample(milliseconds(1), true);
+  REQUIRE(limiter.max_permits() == 14);
+
+  // ...but only once per RTT
+  limiter.on_sample(seconds(1), true);
+  REQUIRE(limiter.max_permits() == 14);
+
+  // Shrinking never revokes permits; releases above the limit are absorbed
+  REQUIRE(limiter.current() == 16);
+  REQUIRE_FALSE(limiter.try_acquire());
+  limiter.release();
+  limiter.release();
+  REQUIRE(limiter.current() == 14);
+  REQUIRE_FALSE(limiter.try_acquire());
+
+  // An RTT well above the minimum is congestion too
+  std::this_thread::sleep_for(milliseconds(20));
+  limiter.on_sample(milliseconds(5), false);
+  REQUIRE(limiter.max_permits() == 12);
+
+  // Fast replies while the limit is in use probe back up to the ceiling
+  for (int i = 0; i < 200; ++i) {
+    limiter.on_sample(milliseconds(1), false);
+  }
+  REQUIRE(limiter.max_permits() == 16);
+
+  // An idle limiter does not grow on fast replies
+  while (limiter.current() > 0) {
+    limiter.release();
+  }
+  std::this_thread::sleep_for(milliseconds(20));
+  limiter.on_sample(milliseconds(1), true);
+  size_t backed_off = limiter.max_permits();
+  REQUIRE(backed_off < 16);
+  for (int i = 0; i < 200; ++i) {
+    limiter.on_sample(milliseconds(1), false);
+  }
+  REQUIRE(limiter.max_permits() == backed_off);
+}
+
+TEST_CASE("AsyncInflightLimiter adaptive floor", "[async_limiter]") {
+  AsyncInflightLimiter limiter(4);
+  limiter.enable_adaptive(3);
+  for (int i = 0; i < 5; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    limiter.on_sample(std::chrono::milliseconds(1), true);
+  }
+  REQUIRE(limiter.max_permits() == 3);
+
+  // Static limiters ignore samples
+  AsyncInflightLimiter fixed(4);
+  fixed.on_sample(std::chrono::milliseconds(1), true);
+  REQUIRE(fixed.max_permits() == 4);
+}
+
+TEST_CASE("WhenAll runs tasks concurrently and keeps order", "[async_limiter]") {
+  EventLoop loop;
+  loop.Start();
+
+  std::atomic<bool> done{false};
+  std::vector<int> results;
+
+  auto sleeper = [&](int id, int ms) -> Task<int> {
+    co_await SleepMs(loop, ms);
+    co_return id;
+  };
+
+  auto full_test = [&]() -> Task<void> {
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 10; ++i) {
+      tasks.push_back(sleeper(i, 50 - i * 5));  // Later tasks finish first
+    }
+    results = co_await WhenAll(std::move(tasks));
+    done = true;
+  };
+
+  auto task = full_test();
+  auto start = std::chrono::steady_clock::now();
+  loop.Post([&]() { task.start(); });
+
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL("Timeout");
+      break;
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  loop.Stop();
+
+  REQUIRE(results == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+  // Concurrent: about the longest sleep (50ms), not the sum (275ms). Awaiting
+  // a started task must wait for it rather than resume it early.
+  REQUIRE(elapsed >= std::chrono::milliseconds(50));
+  REQUIRE(elapsed < std::chrono::milliseconds(200));
+}
+
 // =============================================================================
 // Integration Tests: AsyncRedisClient (requires Redis)
 // =============================================================================
@@ -362,6 +493,70 @@ TEST_CASE("AsyncRedisClient LRange", "[redis]") {
   REQUIRE(done.load());
 }
 
+TEST_CASE("AsyncRedisClient LRangeIds parses ids from the reply", "[redis]") {
+  EventLoop loop;
+  loop.Start();
+
+  auto spec = make_redis_endpoint();
+
+  std::atomic<bool> done{false};
+  std::vector<std::string> strings;
+  AsyncRedisClient::IdList ids;
+  bool ok = false;
+  std::string create_error;
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 50);
+
+    auto as_strings = co_await client->LRange("media:1", 0, -1);
+    auto as_ids = co_await client->LRangeIds("media:1", 0, -1);
+    ok = as_strings.has_value() && as_ids.has_value();
+    if (ok) {
+      strings = std::move(*as_strings);
+      ids = std::move(*as_ids);
+    }
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL("Timeout waiting for LRangeIds");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  if (!create_error.empty()) {
+    WARN("Could not connect to Redis: " << create_error);
+    SKIP("Redis not available");
+    return;
+  }
+
+  REQUIRE(ok);
+  REQUIRE(ids.ids->values.size() == strings.size());
+  REQUIRE(ids.ids->valid.size() == strings.size());
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < strings.size(); ++i) {
+    REQUIRE(std::to_string(ids.ids->values[i]) == strings[i]);
+    bytes += strings[i].size();
+  }
+  REQUIRE(ids.bytes_received == bytes);
+}
+
 TEST_CASE("AsyncRedisClient concurrent LRange with inflight limit", "[redis]") {
   EventLoop loop;
   loop.Start();
@@ -434,6 +629,571 @@ TEST_CASE("AsyncRedisClient concurrent LRange with inflight limit", "[redis]") {
   REQUIRE(completed.load() + errors.load() == num_requests);
 }
 
+TEST_CASE("AsyncRedisClient LRangeBatch with inflight limit", "[redis]") {
+  EventLoop loop;
+  loop.Start();
+
+  auto spec = make_redis_endpoint();
+  spec.policy.max_inflight = 10;  // Batch larger than the limit
+
+  std::atomic<bool> done{false};
+  constexpr int num_keys = 50;
+  size_t num_results = 0;
+  int errors = 0;
+  std::string create_error;
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 50);
+
+    std::vector<std::string> keys(num_keys, "media:1");
+    auto lists = co_await client->LRangeBatch(std::move(keys), 0, 10);
+    num_results = lists.size();
+    for (const auto& list : lists) {
+      if (!list) ++errors;
+    }
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+      FAIL("Timeout waiting for LRangeBatch");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  if (!create_error.empty()) {
+    WARN("Could not connect to Redis: " << create_error);
+    SKIP("Redis not available");
+    return;
+  }
+
+  INFO("Errors: " << errors);
+  REQUIRE(num_results == num_keys);
+}
+
+TEST_CASE("AsyncRedisClient coalesces identical in-flight reads", "[redis]") {
+  EventLoop loop;
+  loop.Start();
+
+  auto spec = make_redis_endpoint();
+
+  std::atomic<bool> done{false};
+  constexpr int num_keys = 20;
+  std::vector<AsyncRedisClient::Result<std::vector<std::string>>> lists;
+  uint64_t coalesced = 0;
+  uint64_t coalesced_after = 0;
+  bool again_ok = false;
+  std::string create_error;
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 50);
+
+    // All commands are queued before any reply arrives: one leader, the rest
+    // join it
+    std::vector<std::string> keys(num_keys, "media:1");
+    lists = co_await client->LRangeBatch(std::move(keys), 0, 10);
+    coalesced = client->coalesced_count();
+
+    // A read issued after the leader completed goes to Redis again
+    auto again = co_await client->LRange("media:1", 0, 10);
+    again_ok = again.has_value();
+    coalesced_after = client->coalesced_count();
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+      FAIL("Timeout waiting for coalesced reads");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  if (!create_error.empty()) {
+    WARN("Could not connect to Redis: " << create_error);
+    SKIP("Redis not available");
+    return;
+  }
+
+  REQUIRE(lists.size() == num_keys);
+  REQUIRE(coalesced == num_keys - 1);
+  REQUIRE(again_ok);
+  REQUIRE(coalesced_after == coalesced);
+  for (const auto& list : lists) {
+    REQUIRE(list.has_value());
+    REQUIRE(*list == *lists[0]);
+  }
+}
+
+TEST_CASE("AsyncRedisClient micro-batches commands within the window", "[redis]") {
+  EventLoop loop;
+  loop.Start();
+
+  auto spec = make_redis_endpoint();
+  spec.policy.batch_window_us = 500;
+  spec.policy.batch_max_ops = 8;
+
+  std::atomic<bool> done{false};
+  constexpr int num_keys = 20;
+  std::vector<AsyncRedisClient::Result<std::vector<std::string>>> lists;
+  uint64_t flushes = 0;
+  uint64_t batched = 0;
+  std::string create_error;
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 50);
+
+    // Distinct keys so nothing is coalesced: two full windows of 8, then the
+    // remaining 4 go out when the window elapses
+    std::vector<std::string> keys;
+    for (int i = 0; i < num_keys; ++i) {
+      keys.push_back("media:" + std::to_string(i));
+    }
+    lists = co_await client->LRangeBatch(std::move(keys), 0, 10);
+    flushes = client->batch_flush_count();
+    batched = client->batched_command_count();
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+      FAIL("Timeout waiting for batched reads");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  if (!create_error.empty()) {
+    WARN("Could not connect to Redis: " << create_error);
+    SKIP("Redis not available");
+    return;
+  }
+
+  REQUIRE(lists.size() == num_keys);
+  for (const auto& list : lists) {
+    REQUIRE(list.has_value());
+  }
+  REQUIRE(batched == num_keys);
+  REQUIRE(flushes >= 3);
+  REQUIRE(flushes < num_keys);
+}
+
+TEST_CASE("AsyncRedisClient hedges slow reads to a replica", "[redis]") {
+  EventLoop loop;
+  loop.Start();
+
+  // The primary doubles as its own replica; a median hedge delay makes
+  // hedges frequent enough to exercise both reply orders
+  auto spec = make_redis_endpoint();
+  spec.replicas.push_back(spec.static_resolver);
+  spec.policy.hedge_percentile = 50;
+  spec.policy.hedge_budget_pct = 20;
+
+  std::atomic<bool> done{false};
+  constexpr int num_reads = 400;
+  int failures = 0;
+  uint64_t issued = 0;
+  uint64_t won = 0;
+  std::string create_error;
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 50);
+
+    for (int i = 0; i < num_reads; ++i) {
+      auto list = co_await client->LRange("media:" + std::to_string(i % 50), 0, 10);
+      failures += list.has_value() ? 0 : 1;
+    }
+    issued = client->hedges_issued();
+    won = client->hedges_won();
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(20)) {
+      FAIL("Timeout waiting for hedged reads");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  if (!create_error.empty()) {
+    WARN("Could not connect to Redis: " << create_error);
+    SKIP("Redis not available");
+    return;
+  }
+
+  REQUIRE(failures == 0);
+  REQUIRE(won <= issued);
+  // Budget: at most 20% of reads
+  REQUIRE(issued <= num_reads / 5);
+}
+
+// =============================================================================
+// Integration Tests: AsyncRedisClient against a stub server (no Redis required)
+// =============================================================================
+
+// Stand-in for a slow Redis: accepts one connection and answers each command
+// with `reply`, `delay` after it arrived. Commands are told apart by their
+// RESP array header, so command arguments must not start with '*'.
+class SlowRedisStub {
+ public:
+  SlowRedisStub(std::chrono::milliseconds delay, std::string reply)
+      : delay_(delay), reply_(std::move(reply)) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // Any free port
+    ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::listen(listen_fd_, 1);
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread([this]() { serve(); });
+  }
+
+  ~SlowRedisStub() {
+    stop_ = true;
+    thread_.join();
+    ::close(listen_fd_);
+  }
+
+  int port() const { return port_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void serve() {
+    int fd = -1;
+    std::deque<Clock::time_point> due;  // One entry per unanswered command
+    while (!stop_) {
+      int timeout_ms = 10;
+      if (!due.empty()) {
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(due.front() - Clock::now());
+        timeout_ms = std::clamp<int>(static_cast<int>(wait.count()), 0, 10);
+      }
+      pollfd pfd{fd >= 0 ? fd : listen_fd_, POLLIN, 0};
+      if (::poll(&pfd, 1, timeout_ms) > 0) {
+        if (fd < 0) {
+          fd = ::accept(listen_fd_, nullptr, nullptr);
+        } else {
+          char buf[4096];
+          ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+          if (n <= 0) break;
+          for (ssize_t i = 0; i < n; ++i) {
+            if (buf[i] == '*' && (i == 0 || buf[i - 1] == '\n')) {
+              due.push_back(Clock::now() + delay_);
+            }
+          }
+        }
+      }
+      while (!due.empty() && due.front() <= Clock::now()) {
+        ::send(fd, reply_.data(), reply_.size(), MSG_NOSIGNAL);
+        due.pop_front();
+      }
+    }
+    if (fd >= 0) ::close(fd);
+  }
+
+  std::chrono::milliseconds delay_;
+  std::string reply_;
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+using ListResult = AsyncRedisClient::Result<std::vector<std::string>>;
+
+// LRANGE media:1 issued `after_ms` in, recording how long after `start` it
+// completed
+Task<ListResult> TimedLRange(EventLoop& loop, AsyncRedisClient& client, CancellationToken cancel,
+                             uint64_t after_ms, std::chrono::steady_clock::time_point start,
+                             std::chrono::steady_clock::duration& took) {
+  if (after_ms > 0) {
+    co_await SleepMs(loop, after_ms);
+  }
+  auto list = co_await client.LRange("media:1", 0, 10, std::move(cancel));
+  took = std::chrono::steady_clock::now() - start;
+  co_return list;
+}
+
+Task<ListResult> CancelAfterMs(EventLoop& loop, CancellationSource& source, uint64_t ms) {
+  co_await SleepMs(loop, ms);
+  source.cancel();
+  co_return ListResult{};
+}
+
+TEST_CASE("AsyncRedisClient cancelled single-flight leader returns at once", "[redis]") {
+  SlowRedisStub redis(std::chrono::milliseconds(200), "*1\r\n$2\r\n42\r\n");
+
+  EventLoop loop;
+  loop.Start();
+
+  auto spec = make_redis_endpoint("127.0.0.1", redis.port());
+  spec.policy.request_timeout_ms = 2000;
+
+  using Clock = std::chrono::steady_clock;
+  std::atomic<bool> done{false};
+  std::string create_error;
+  std::vector<ListResult> results;
+  Clock::duration leader_took{};
+  Clock::duration follower_took{};
+  uint64_t coalesced = 0;
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 20);
+
+    // The leader is cancelled while the follower still waits for the reply
+    CancellationSource source;
+    auto start = Clock::now();
+    std::vector<Task<ListResult>> ops;
+    ops.push_back(TimedLRange(loop, *client, source.token(), 0, start, leader_took));
+    ops.push_back(TimedLRange(loop, *client, {}, 0, start, follower_took));
+    ops.push_back(CancelAfterMs(loop, source, 20));
+    results = co_await WhenAll(std::move(ops));
+    coalesced = client->coalesced_count();
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = Clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (Clock::now() - start > std::chrono::seconds(10)) {
+      FAIL("Timeout waiting for reads");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  REQUIRE(create_error.empty());
+  REQUIRE(results.size() == 3);
+  REQUIRE(coalesced == 1);
+  REQUIRE_FALSE(results[0].has_value());
+  REQUIRE(results[0].error().message == "Cancelled");
+  REQUIRE(leader_took < std::chrono::milliseconds(150));
+  // The follower still gets the reply of the command the leader issued
+  REQUIRE(results[1].has_value());
+  REQUIRE(*results[1] == std::vector<std::string>{"42"});
+  REQUIRE(follower_took >= std::chrono::milliseconds(150));
+}
+
+TEST_CASE("AsyncRedisClient single-flight follower keeps its own deadline", "[redis]") {
+  // Replies take 200ms against a 150ms timeout: the leader times out, while
+  // a read that joins 100ms later has until 250ms
+  SlowRedisStub redis(std::chrono::milliseconds(200), "*1\r\n$2\r\n42\r\n");
+
+  EventLoop loop;
+  loop.Start();
+
+  auto spec = make_redis_endpoint("127.0.0.1", redis.port());
+  spec.policy.request_timeout_ms = 150;
+
+  using Clock = std::chrono::steady_clock;
+  std::atomic<bool> done{false};
+  std::string create_error;
+  std::vector<ListResult> results;
+  Clock::duration leader_took{};
+  Clock::duration follower_took{};
+  uint64_t coalesced = 0;
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 20);
+
+    auto start = Clock::now();
+    std::vector<Task<ListResult>> ops;
+    ops.push_back(TimedLRange(loop, *client, {}, 0, start, leader_took));
+    ops.push_back(TimedLRange(loop, *client, {}, 100, start, follower_took));
+    results = co_await WhenAll(std::move(ops));
+    coalesced = client->coalesced_count();
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = Clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (Clock::now() - start > std::chrono::seconds(10)) {
+      FAIL("Timeout waiting for reads");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  REQUIRE(create_error.empty());
+  REQUIRE(results.size() == 2);
+  REQUIRE(coalesced == 1);
+  REQUIRE_FALSE(results[0].has_value());
+  REQUIRE(results[0].error().message == "Request timeout");
+  REQUIRE(leader_took < std::chrono::milliseconds(200));
+  REQUIRE(results[1].has_value());
+  REQUIRE(*results[1] == std::vector<std::string>{"42"});
+  REQUIRE(follower_took >= std::chrono::milliseconds(200));
+}
+
+using IdsResult = AsyncRedisClient::Result<AsyncRedisClient::IdList>;
+
+Task<IdsResult> IdsInto(AsyncRedisClient& client,
+                        std::shared_ptr<std::pmr::memory_resource> memory) {
+  co_return co_await client.LRangeIds("media:1", 0, 10, std::move(memory));
+}
+
+TEST_CASE("AsyncRedisClient LRangeIds decodes into each caller's memory", "[redis]") {
+  SlowRedisStub redis(std::chrono::milliseconds(50), "*3\r\n$2\r\n42\r\n$1\r\nx\r\n$1\r\n7\r\n");
+
+  EventLoop loop;
+  loop.Start();
+
+  auto spec = make_redis_endpoint("127.0.0.1", redis.port());
+  spec.policy.request_timeout_ms = 2000;
+
+  std::atomic<bool> done{false};
+  std::string create_error;
+  std::vector<IdsResult> results;
+  uint64_t coalesced = 0;
+  auto leader_arena = std::make_shared<rankd::RequestArena>();
+  auto follower_arena = std::make_shared<rankd::RequestArena>();
+
+  auto full_test = [&]() -> Task<void> {
+    auto result = AsyncRedisClient::Create(loop, spec);
+    if (!result) {
+      create_error = result.error();
+      done = true;
+      co_return;
+    }
+
+    auto& client = *result;
+    co_await SleepMs(loop, 20);
+
+    // The second read joins the first; each gets ids in its own arena
+    std::vector<Task<IdsResult>> ops;
+    ops.push_back(IdsInto(*client, leader_arena));
+    ops.push_back(IdsInto(*client, follower_arena));
+    results = co_await WhenAll(std::move(ops));
+    coalesced = client->coalesced_count();
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+      FAIL("Timeout waiting for reads");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  REQUIRE(create_error.empty());
+  REQUIRE(results.size() == 2);
+  REQUIRE(coalesced == 1);
+  REQUIRE(results[0].has_value());
+  REQUIRE(results[1].has_value());
+
+  const auto& leader_ids = *results[0]->ids;
+  const auto& follower_ids = *results[1]->ids;
+  REQUIRE(results[0]->bytes_received == 4);
+  // The non-id element is skipped and the column trimmed
+  REQUIRE(leader_ids.values == rankd::ColumnVector<int64_t>({42, 7}));
+  REQUIRE(leader_ids.valid.size() == 2);
+  REQUIRE(follower_ids.values == rankd::ColumnVector<int64_t>({42, 7}));
+  REQUIRE(leader_ids.values.get_allocator().resource() == leader_arena.get());
+  REQUIRE(follower_ids.values.get_allocator().resource() == follower_arena.get());
+  REQUIRE(leader_ids.values.data() != follower_ids.values.data());
+
+  // A batch adopts the decoded column as is
+  const int64_t* decoded = leader_ids.values.data();
+  rankd::ColumnBatch batch(results[0]->ids, nullptr, leader_arena);
+  REQUIRE(batch.size() == 2);
+  REQUIRE(batch.getId(1) == 7);
+  REQUIRE(batch.isIdValid(1));
+  REQUIRE(&leader_ids.values[0] == decoded);
+}
+
 TEST_CASE("AsyncIoClients caching", "[redis]") {
   EventLoop loop;
   loop.Start();
@@ -457,6 +1217,114 @@ TEST_CASE("AsyncIoClients caching", "[redis]") {
   loop.Stop();
 }
 
+// Registry holding just `spec`, loaded through a temp JSON file
+rankd::EndpointRegistry make_registry(const rankd::EndpointSpec& spec) {
+  nlohmann::json policy = {{"max_inflight", *spec.policy.max_inflight},
+                           {"connect_timeout_ms", *spec.policy.connect_timeout_ms},
+                           {"request_timeout_ms", *spec.policy.request_timeout_ms}};
+  if (spec.policy.pool_size) {
+    policy["pool_size"] = *spec.policy.pool_size;
+  }
+  std::vector<rankd::EndpointSpec> specs = {spec};
+  nlohmann::json j = {
+      {"schema_version", 1},
+      {"env", "test"},
+      {"registry_digest", rankd::compute_digest(rankd::registry_canonical_json(specs))},
+      {"config_digest", rankd::compute_digest(rankd::config_canonical_json(specs))},
+      {"endpoints",
+       nlohmann::json::array({{{"endpoint_id", spec.endpoint_id},
+                               {"name", spec.name},
+                               {"kind", "redis"},
+                               {"resolver",
+                                {{"type", "static"},
+                                 {"host", spec.static_resolver.host},
+                                 {"port", spec.static_resolver.port}}},
+                               {"policy", policy}}})}};
+
+  std::string path = "/tmp/async_redis_test_endpoints.json";
+  std::ofstream(path) << j.dump(2);
+  auto result = rankd::EndpointRegistry::LoadFromJson(path);
+  if (auto* error = std::get_if<std::string>(&result)) {
+    FAIL("Failed to load test registry: " << *error);
+  }
+  return std::get<rankd::EndpointRegistry>(std::move(result));
+}
+
+TEST_CASE("AsyncIoClients pools and reconnects Redis connections", "[redis]") {
+  EventLoop loop;
+  loop.Start();
+
+  // Nothing listens here: every connection fails shortly after it is opened
+  auto spec = make_redis_endpoint("127.0.0.1", 59999);
+  spec.policy.pool_size = 3;
+  auto registry = make_registry(spec);
+
+  AsyncIoClients clients;
+  std::atomic<bool> done{false};
+  std::string error;
+  size_t distinct = 0;
+  size_t opened = 0;
+  size_t open_after_failure = 0;
+  uint64_t reconnects = 0;
+  uint64_t reconnects_in_backoff = 0;
+
+  auto full_test = [&]() -> Task<void> {
+    // Round-robin across the idle pool
+    std::vector<AsyncRedisClient*> picked;
+    for (int i = 0; i < 3; ++i) {
+      auto client = clients.GetRedis(loop, registry, spec.endpoint_id);
+      if (!client) {
+        error = client.error();
+        done = true;
+        co_return;
+      }
+      if (std::find(picked.begin(), picked.end(), client->get()) == picked.end()) {
+        picked.push_back(client->get());
+      }
+    }
+    distinct = picked.size();
+    opened = clients.redis_connection_count();
+
+    co_await SleepMs(loop, 200);
+    open_after_failure = clients.redis_connection_count();
+
+    // Closed connections are replaced on the next use...
+    (void)clients.GetRedis(loop, registry, spec.endpoint_id);
+    reconnects = clients.redis_reconnects();
+
+    // ...but not again within the backoff
+    co_await SleepMs(loop, 20);
+    (void)clients.GetRedis(loop, registry, spec.endpoint_id);
+    reconnects_in_backoff = clients.redis_reconnects();
+
+    clients.Clear();
+    done = true;
+  };
+
+  auto task = full_test();
+  loop.Post([&]() { task.start(); });
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+      FAIL("Timeout waiting for pool test");
+      break;
+    }
+  }
+
+  loop.Stop();
+
+  INFO("Error: " << error);
+  REQUIRE(error.empty());
+  REQUIRE(clients.redis_count() == 0);
+  REQUIRE(distinct == 3);
+  REQUIRE(opened == 3);
+  REQUIRE(open_after_failure == 0);
+  REQUIRE(reconnects == 3);
+  REQUIRE(reconnects_in_backoff == 3);
+}
+
 // =============================================================================
 // Stress test (optional, for manual runs)
 // =============================================================================
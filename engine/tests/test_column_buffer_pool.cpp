@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "column_batch.h"
+#include "column_buffer_pool.h"
+#include "request_arena.h"
+
+#include <thread>
+
+using namespace rankd;
+
+TEST_CASE("ColumnBufferPool size classes", "[buffer_pool]") {
+  constexpr size_t kNone = ColumnBufferPool::kNumClasses;
+
+  REQUIRE(ColumnBufferPool::classIndex(4096, 8) == 0);
+  REQUIRE(ColumnBufferPool::classIndex(4097, 8) == 1);
+  REQUIRE(ColumnBufferPool::classIndex(8192, 8) == 1);
+  REQUIRE(ColumnBufferPool::classBytes(1) == 8192);
+  REQUIRE(ColumnBufferPool::classIndex(size_t{64} << 20, 8) == kNone - 1);
+
+  // Bypass: too small, too large, over-aligned
+  REQUIRE(ColumnBufferPool::classIndex(4095, 8) == kNone);
+  REQUIRE(ColumnBufferPool::classIndex((size_t{64} << 20) + 1, 8) == kNone);
+  REQUIRE(ColumnBufferPool::classIndex(8192, 128) == kNone);
+}
+
+TEST_CASE("ColumnBufferPool recycles freed buffers", "[buffer_pool]") {
+  auto &pool = ColumnBufferPool::instance();
+  pool.trim();
+  size_t saved_limit = pool.retainLimit();
+  pool.setRetainLimit(ColumnBufferPool::kDefaultRetainLimitBytes);
+
+  SECTION("same size class is served from the cache") {
+    void *a = pool.allocate(100 * 1000, 8);
+    pool.deallocate(a, 100 * 1000, 8);
+    REQUIRE(pool.retainedBytes() == 128 * 1024);
+
+    uint64_t hits = pool.hits();
+    void *b = pool.allocate(120 * 1000, 8); // same 128 KiB class
+    REQUIRE(b == a);
+    REQUIRE(pool.hits() == hits + 1);
+    REQUIRE(pool.retainedBytes() == 0);
+    pool.deallocate(b, 120 * 1000, 8);
+  }
+
+  SECTION("retained bytes are capped") {
+    pool.setRetainLimit(8 * 1024);
+    void *a = pool.allocate(8 * 1024, 8);
+    void *b = pool.allocate(8 * 1024, 8);
+    pool.deallocate(a, 8 * 1024, 8);
+    pool.deallocate(b, 8 * 1024, 8); // over the cap: released
+    REQUIRE(pool.retainedBytes() == 8 * 1024);
+  }
+
+  SECTION("buffers cached by an exited thread are reusable") {
+    std::thread([&] {
+      void *p = pool.allocate(16 * 1024, 8);
+      pool.deallocate(p, 16 * 1024, 8);
+    }).join();
+    REQUIRE(pool.retainedBytes() == 16 * 1024);
+
+    uint64_t hits = pool.hits();
+    void *q = pool.allocate(16 * 1024, 8);
+    REQUIRE(pool.hits() == hits + 1);
+    pool.deallocate(q, 16 * 1024, 8);
+  }
+
+  pool.trim();
+  REQUIRE(pool.retainedBytes() == 0);
+  pool.setRetainLimit(saved_limit);
+}
+
+TEST_CASE("Request arenas reuse pooled chunks across requests", "[buffer_pool][arena]") {
+  auto &pool = ColumnBufferPool::instance();
+  pool.trim();
+
+  auto run_request = [] {
+    auto arena = std::make_shared<RequestArena>();
+    ColumnBatch batch(10000, nullptr, arena, ColumnInit::Uninitialized);
+    FloatColumn col(10000, ColumnInit::Uninitialized, batch.resource());
+    REQUIRE(col.valid[9999] == 0);
+    return arena->highWaterBytes();
+  };
+
+  run_request();
+  REQUIRE(pool.retainedBytes() > 0);
+
+  uint64_t misses = pool.misses();
+  run_request();
+  REQUIRE(pool.misses() == misses);
+
+  pool.trim();
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "critical_path.h"
+#include "task_registry.h"
+
+#include <vector>
+
+using namespace rankd;
+
+TEST_CASE("compute_critical_path ranks by longest remaining path",
+          "[critical_path]") {
+  // 0 -> 1 -> 2       (chain, 10 + 10 + 10)
+  // 0 -> 3            (side branch, 10 + 5)
+  std::vector<double> cost = {10, 10, 10, 5};
+  std::vector<std::vector<size_t>> successors = {{1, 3}, {2}, {}, {}};
+  std::vector<size_t> topo_order = {0, 1, 3, 2};
+
+  auto priority = compute_critical_path(cost, successors, topo_order);
+  REQUIRE(priority == std::vector<double>{30, 20, 10, 5});
+}
+
+TEST_CASE("ReadyQueue pops highest priority first, ties in push order",
+          "[critical_path]") {
+  ReadyQueue queue;
+  queue.setPriorities({1.0, 5.0, 5.0, 3.0});
+  queue.push(0);
+  queue.push(2);
+  queue.push(3);
+  queue.push(1);
+
+  REQUIRE(queue.size() == 4);
+  REQUIRE(queue.pop() == 2);
+  REQUIRE(queue.pop() == 1);
+  REQUIRE(queue.pop() == 3);
+  REQUIRE(queue.pop() == 0);
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("ReadyQueue without priorities is FIFO", "[critical_path]") {
+  ReadyQueue queue;
+  for (size_t i : {4, 1, 3, 0}) {
+    queue.push(i);
+  }
+  std::vector<size_t> order;
+  while (!queue.empty()) {
+    order.push_back(queue.pop());
+  }
+  REQUIRE(order == std::vector<size_t>{4, 1, 3, 0});
+}
+
+TEST_CASE("NodeCostModel prefers history over the op's static model",
+          "[critical_path]") {
+  auto &model = NodeCostModel::instance();
+  model.clear();
+  const auto &registry = TaskRegistry::instance();
+
+  Plan plan;
+  plan.plan_name = "test_cost_model";
+  Node busy;
+  busy.node_id = "busy";
+  busy.op = "test::busy_cpu";
+  busy.params = nlohmann::json::object();
+  busy.params["busy_wait_ms"] = 3;
+  Node take;
+  take.node_id = "take";
+  take.op = "core::take";
+  take.params = nlohmann::json::object();
+  take.params["count"] = 10;
+
+  // Static models: busy_cpu from its params, take from the CPU default
+  const auto &busy_spec = registry.get_spec(busy.op);
+  REQUIRE(model.estimateUs(plan, busy, busy_spec) == 3000.0);
+  REQUIRE(model.estimateUs(plan, take, registry.get_spec(take.op)) ==
+          NodeCostModel::kDefaultCpuCostUs);
+
+  // History: first sample is taken as is, later ones fold into the EWMA
+  model.record(plan, busy, 1000.0);
+  REQUIRE(model.estimateUs(plan, busy, busy_spec) == 1000.0);
+  model.record(plan, busy, 2000.0);
+  REQUIRE(model.estimateUs(plan, busy, busy_spec) ==
+          1000.0 + NodeCostModel::kEwmaAlpha * 1000.0);
+  REQUIRE(model.size() == 1);
+
+  // Nothing is recorded while disabled
+  model.setEnabled(false);
+  model.record(plan, take, 500.0);
+  model.setEnabled(true);
+  REQUIRE(model.size() == 1);
+
+  model.clear();
+}
+
+TEST_CASE("NodeCostModel records through a validated node's slot",
+          "[critical_path]") {
+  auto &model = NodeCostModel::instance();
+  model.clear();
+  const auto &spec = TaskRegistry::instance().get_spec("test::busy_cpu");
+
+  Plan plan;
+  plan.plan_name = "test_cost_slot";
+  Node busy;
+  busy.node_id = "busy";
+  busy.op = "test::busy_cpu";
+  busy.params = nlohmann::json::object();
+  busy.params["busy_wait_ms"] = 3;
+
+  // What validate_plan does: one slot per (plan_name, node_id)
+  Node validated = busy;
+  validated.cost_slot = model.slot(plan, validated);
+  REQUIRE(validated.cost_slot != nullptr);
+  REQUIRE(model.slot(plan, busy) == validated.cost_slot);
+  REQUIRE(model.size() == 0);
+
+  // Samples through the slot are seen by key lookups, and vice versa
+  model.record(plan, validated, 1000.0);
+  REQUIRE(model.estimateUs(plan, busy, spec) == 1000.0);
+  model.record(plan, busy, 2000.0);
+  REQUIRE(model.estimateUs(plan, validated, spec) ==
+          1000.0 + NodeCostModel::kEwmaAlpha * 1000.0);
+  REQUIRE(model.size() == 1);
+
+  // clear() keeps the slot but drops its history
+  model.clear();
+  REQUIRE(model.size() == 0);
+  REQUIRE(model.estimateUs(plan, validated, spec) == 3000.0);
+  REQUIRE(model.slot(plan, busy) == validated.cost_slot);
+}
@@ -5,6 +5,7 @@
 #include "async_io_clients.h"
 #include "column_batch.h"
 #include "cpu_pool.h"
+#include "critical_path.h"
 #include "dag_scheduler.h"
 #include "endpoint_registry.h"
 #include "event_loop.h"
@@ -301,6 +302,87 @@ TEST_CASE("parallel scheduler produces same results as sequential",
   }
 }
 
+// Helper to create a plan whose critical path is listed last:
+// source -> side_0..side_{width-1} (sleep each)
+//        -> chain_0 -> ... -> chain_{depth-1} (sleep each)
+// With busy_cpu set, every side/chain node is a busy_cpu spin instead of a
+// sleep, so it takes a CPU slot in the async scheduler.
+static Plan create_side_branches_and_chain_plan(int width, int depth, int sleep_ms,
+                                                bool busy_cpu = false) {
+  const std::string op = busy_cpu ? "test::busy_cpu" : "test::sleep";
+  const std::string duration_param = busy_cpu ? "busy_wait_ms" : "duration_ms";
+
+  Plan plan;
+  plan.schema_version = 1;
+  plan.plan_name = "test_critical_path";
+
+  Node source;
+  source.node_id = "source";
+  source.op = "test::fixed_source";
+  source.params = nlohmann::json::object();
+  plan.nodes.push_back(source);
+
+  for (int i = 0; i < width; ++i) {
+    Node side;
+    side.node_id = "side_" + std::to_string(i);
+    side.op = op;
+    side.inputs = {"source"};
+    side.params = nlohmann::json::object();
+    side.params[duration_param] = sleep_ms;
+    plan.nodes.push_back(side);
+    plan.outputs.push_back(side.node_id);
+  }
+
+  std::string prev = "source";
+  for (int i = 0; i < depth; ++i) {
+    Node chain;
+    chain.node_id = "chain_" + std::to_string(i);
+    chain.op = op;
+    chain.inputs = {prev};
+    chain.params = nlohmann::json::object();
+    chain.params[duration_param] = sleep_ms;
+    plan.nodes.push_back(chain);
+    prev = chain.node_id;
+  }
+  plan.outputs.push_back(prev);
+  return plan;
+}
+
+TEST_CASE("parallel scheduler dispatches the critical path first",
+          "[dag_scheduler][parallel][critical_path]") {
+  // 2 slots, 4 side branches and a 3-node chain, 40ms each.
+  // FIFO: sides take both slots for two rounds, then the chain runs alone
+  //       (2 + 3 rounds = 200ms).
+  // Critical path: the chain runs from round one alongside the sides
+  //       (4 rounds = 160ms).
+  constexpr int kSleepMs = 40;
+  Plan plan = create_side_branches_and_chain_plan(4, 3, kSleepMs);
+  validate_plan(plan, nullptr);
+
+  ParamTable params;
+  RequestContext request_ctx;
+  request_ctx.user_id = 1;
+  request_ctx.request_id = "test_critical_path";
+
+  ExecCtx ctx;
+  ctx.params = &params;
+  ctx.expr_table = &plan.expr_table;
+  ctx.pred_table = &plan.pred_table;
+  ctx.request = &request_ctx;
+  ctx.parallel = true;
+
+  REQUIRE(NodeCostModel::instance().enabled());
+  auto start = std::chrono::steady_clock::now();
+  auto result = execute_plan_parallel(plan, ctx, 2);
+  double elapsed_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+  INFO("Elapsed time: " << elapsed_ms << "ms");
+  REQUIRE(result.outputs.size() == 5);
+  REQUIRE(elapsed_ms < 4.5 * kSleepMs);
+}
+
 TEST_CASE("sleep task identity behavior", "[sleep][task]") {
   auto &registry = TaskRegistry::instance();
 
@@ -499,7 +581,7 @@ TEST_CASE("async scheduler: fault injection - no deadlock or UAF on error",
           "[async_scheduler][fault_injection]") {
   // Two parallel branches: one succeeds (100ms), one fails after 20ms
   // The failing branch should trigger error without deadlock
-  // And the successful branch should complete without UAF
+  // And cancel the other branch, which must unwind without UAF
   Plan plan = create_fault_injection_plan(100, 20);
   validate_plan(plan, &get_test_endpoint_registry());
 
@@ -539,11 +621,11 @@ TEST_CASE("async scheduler: fault injection - no deadlock or UAF on error",
   REQUIRE_THAT(error_message,
                Catch::Matchers::ContainsSubstring("intentional failure"));
 
-  // Verify timing: should complete after ~100ms (waiting for all inflight)
-  // not immediately after 20ms (would indicate premature return)
+  // Verify timing: the failure cancels the 100ms sleep, which wakes early
+  // and unwinds before the scheduler returns, so this completes at ~20ms
   INFO("Elapsed time: " << elapsed_ms << "ms");
-  REQUIRE(elapsed_ms >= 90.0);   // Wait for 100ms branch to complete
-  REQUIRE(elapsed_ms < 200.0);   // But not hung/deadlocked
+  REQUIRE(elapsed_ms >= 15.0);   // Failing branch ran its 20ms
+  REQUIRE(elapsed_ms < 90.0);    // Sibling was cancelled, not waited out
 
   // If we get here without crash/hang, no UAF or deadlock occurred!
 }
@@ -764,12 +846,14 @@ struct AsyncExecResult {
   bool caught_error = false;
   std::string error_message;
   double elapsed_ms = 0.0;
+  ExecutionResult exec;  // set on success
 };
 
 static AsyncExecResult run_async_with_deadline(
     Plan& plan,
     ranking::OptionalDeadline deadline,
-    std::optional<std::chrono::milliseconds> node_timeout) {
+    std::optional<std::chrono::milliseconds> node_timeout,
+    int max_nodes_inflight = 0) {
 
   AsyncExecResult result;
 
@@ -785,10 +869,10 @@ static AsyncExecResult run_async_with_deadline(
   auto start = std::chrono::steady_clock::now();
 
   try {
-    ranking::execute_plan_async_blocking(
+    result.exec = ranking::execute_plan_async_blocking(
         plan, loop, async_clients, params, plan.expr_table, plan.pred_table,
         get_test_endpoint_registry(), request_ctx, nullptr,
-        deadline, node_timeout);
+        deadline, node_timeout, nullptr, max_nodes_inflight);
     result.success = true;
   } catch (const std::exception& e) {
     result.caught_error = true;
@@ -1339,3 +1423,170 @@ TEST_CASE("async scheduler: parallel async tasks both respect deadline",
   INFO("Elapsed time: " << result.elapsed_ms << "ms");
   REQUIRE(result.elapsed_ms < 150.0);
 }
+
+// ============================================================================
+// CPU pool scaling
+// ============================================================================
+
+// Helper to create a CPU fan-out plan: fixed_source -> width x busy_cpu
+static Plan create_busy_cpu_fanout_plan(int width, int busy_wait_ms) {
+  Plan plan;
+  plan.schema_version = 1;
+  plan.plan_name = "test_busy_cpu_fanout";
+
+  Node source;
+  source.node_id = "source";
+  source.op = "test::fixed_source";
+  source.params = nlohmann::json::object();
+  source.params["row_count"] = 1;
+  plan.nodes.push_back(source);
+
+  for (int i = 0; i < width; ++i) {
+    Node busy;
+    busy.node_id = "busy_" + std::to_string(i);
+    busy.op = "test::busy_cpu";
+    busy.inputs = {"source"};
+    busy.params = nlohmann::json::object();
+    busy.params["busy_wait_ms"] = busy_wait_ms;
+    plan.nodes.push_back(busy);
+    plan.outputs.push_back(busy.node_id);
+  }
+  return plan;
+}
+
+TEST_CASE("async scheduler: busy_cpu fan-out spreads across CPU workers",
+          "[async_scheduler][cpu_pool]") {
+  // Two waves of busy_cpu(40ms) on the 4-worker pool
+  constexpr int kWidth = 8;
+  constexpr int kBusyMs = 40;
+  Plan plan = create_busy_cpu_fanout_plan(kWidth, kBusyMs);
+  validate_plan(plan, nullptr);
+
+  auto result = run_async_with_deadline(plan, std::nullopt, std::nullopt);
+  REQUIRE(result.success);
+
+  // Serial execution would take kWidth * kBusyMs. Only check the speedup
+  // when the machine has cores for every worker.
+  INFO("Elapsed time: " << result.elapsed_ms << "ms");
+  if (std::thread::hardware_concurrency() >= GetCPUThreadPool().size()) {
+    REQUIRE(result.elapsed_ms < kWidth * kBusyMs * 0.75);
+  }
+}
+
+TEST_CASE("async scheduler: max_nodes_inflight caps running CPU nodes, critical path first",
+          "[async_scheduler][critical_path]") {
+  // Same shape as the parallel scheduler test, with busy_cpu nodes: 2 CPU
+  // slots, 4 side branches and a 3-node chain, 40ms each. Uncapped,
+  // everything overlaps (3 rounds); capped at 2 with the chain first,
+  // 4 rounds; FIFO would need 5.
+  constexpr int kBusyMs = 40;
+  Plan plan = create_side_branches_and_chain_plan(4, 3, kBusyMs, true);
+  validate_plan(plan, nullptr);
+
+  REQUIRE(NodeCostModel::instance().enabled());
+  auto result = run_async_with_deadline(plan, std::nullopt, std::nullopt, 2);
+  REQUIRE(result.success);
+  REQUIRE(result.exec.outputs.size() == 5);
+
+  INFO("Elapsed time: " << result.elapsed_ms << "ms");
+  REQUIRE(result.elapsed_ms >= 3.9 * kBusyMs);
+  if (std::thread::hardware_concurrency() >= 2) {
+    REQUIRE(result.elapsed_ms < 4.5 * kBusyMs);
+  }
+}
+
+TEST_CASE("async scheduler: max_nodes_inflight does not cap IO fan-out",
+          "[async_scheduler][critical_path]") {
+  // 8 sleep nodes hold no CPU slot: with a cap of 2 they still overlap in
+  // one round instead of running in 4 waves
+  constexpr int kSleepMs = 40;
+  Plan plan = create_side_branches_and_chain_plan(8, 1, kSleepMs);
+  validate_plan(plan, nullptr);
+
+  auto result = run_async_with_deadline(plan, std::nullopt, std::nullopt, 2);
+  REQUIRE(result.success);
+  REQUIRE(result.exec.outputs.size() == 9);
+
+  INFO("Elapsed time: " << result.elapsed_ms << "ms");
+  REQUIRE(result.elapsed_ms < 2.0 * kSleepMs);
+}
+
+// ============================================================================
+// Inline execution of trivial nodes
+// ============================================================================
+
+// Helper: fixed_source(row_count) -> take(count) -> busy_cpu(0ms)
+static Plan create_take_plan(int row_count) {
+  Plan plan;
+  plan.schema_version = 1;
+  plan.plan_name = "test_inline_take";
+
+  Node source;
+  source.node_id = "source";
+  source.op = "test::fixed_source";
+  source.params = nlohmann::json::object();
+  source.params["row_count"] = row_count;
+  plan.nodes.push_back(source);
+
+  Node take;
+  take.node_id = "take";
+  take.op = "core::take";
+  take.inputs = {"source"};
+  take.params = nlohmann::json::object();
+  take.params["count"] = 5;
+  plan.nodes.push_back(take);
+
+  // No inline cost: always offloaded
+  Node busy;
+  busy.node_id = "busy";
+  busy.op = "test::busy_cpu";
+  busy.inputs = {"take"};
+  busy.params = nlohmann::json::object();
+  busy.params["busy_wait_ms"] = 0;
+  plan.nodes.push_back(busy);
+
+  plan.outputs = {"busy"};
+  return plan;
+}
+
+TEST_CASE("async scheduler: trivial nodes run inline on the loop thread",
+          "[async_scheduler][inline]") {
+  auto &model = NodeCostModel::instance();
+  double saved_threshold = model.inlineThresholdUs();
+  model.setInlineThresholdUs(20.0);
+
+  SECTION("small input is inlined") {
+    Plan plan = create_take_plan(10);
+    validate_plan(plan, nullptr);
+
+    auto result = run_async_with_deadline(plan, std::nullopt, std::nullopt);
+    REQUIRE(result.success);
+    REQUIRE(result.exec.outputs[0].logicalSize() == 5);
+    REQUIRE(result.exec.nodes_inlined == 1);
+    REQUIRE(result.exec.nodes_offloaded == 1);
+  }
+
+  SECTION("input above the threshold is offloaded") {
+    // take costs 1ns/row: 20us covers 20000 rows
+    Plan plan = create_take_plan(50000);
+    validate_plan(plan, nullptr);
+
+    auto result = run_async_with_deadline(plan, std::nullopt, std::nullopt);
+    REQUIRE(result.success);
+    REQUIRE(result.exec.nodes_inlined == 0);
+    REQUIRE(result.exec.nodes_offloaded == 2);
+  }
+
+  SECTION("threshold 0 disables inlining") {
+    model.setInlineThresholdUs(0);
+    Plan plan = create_take_plan(10);
+    validate_plan(plan, nullptr);
+
+    auto result = run_async_with_deadline(plan, std::nullopt, std::nullopt);
+    REQUIRE(result.success);
+    REQUIRE(result.exec.nodes_inlined == 0);
+    REQUIRE(result.exec.nodes_offloaded == 2);
+  }
+
+  model.setInlineThresholdUs(saved_threshold);
+}
@@ -41,6 +41,12 @@ static void add_endpoint_digests(nlohmann::json& j) {
       spec.resolver_type = *resolver_type_opt;
       spec.static_resolver.host = resolver.at("host").get<std::string>();
       spec.static_resolver.port = resolver.at("port").get<int>();
+      if (resolver.contains("replicas")) {
+        for (const auto& replica : resolver.at("replicas")) {
+          spec.replicas.push_back(
+              {replica.at("host").get<std::string>(), replica.at("port").get<int>()});
+        }
+      }
 
       if (ep.contains("policy")) {
         const auto& policy = ep.at("policy");
@@ -53,6 +59,12 @@ static void add_endpoint_digests(nlohmann::json& j) {
         if (policy.contains("request_timeout_ms")) {
           spec.policy.request_timeout_ms = policy.at("request_timeout_ms").get<int>();
         }
+        if (policy.contains("hedge_percentile")) {
+          spec.policy.hedge_percentile = policy.at("hedge_percentile").get<int>();
+        }
+        if (policy.contains("hedge_budget_pct")) {
+          spec.policy.hedge_budget_pct = policy.at("hedge_budget_pct").get<int>();
+        }
       }
 
       specs.push_back(std::move(spec));
@@ -305,6 +317,53 @@ TEST_CASE("EndpointRegistry rejects invalid endpoint_id format", "[endpoint_regi
   }
 }
 
+TEST_CASE("EndpointRegistry loads read replicas and hedge policy", "[endpoint_registry]") {
+  nlohmann::json j = {
+    {"schema_version", 1},
+    {"env", "dev"},
+    {"endpoints", nlohmann::json::array({
+      {{"endpoint_id", "ep_0001"}, {"name", "redis"}, {"kind", "redis"},
+       {"resolver", {{"type", "static"}, {"host", "10.0.0.1"}, {"port", 6379},
+                     {"replicas", nlohmann::json::array({
+                       {{"host", "10.0.0.2"}, {"port", 6379}},
+                       {{"host", "10.0.0.3"}, {"port", 6380}}})}}},
+       {"policy", {{"hedge_percentile", 95}, {"hedge_budget_pct", 5}}}}
+    })}
+  };
+
+  SECTION("replicas and hedge settings are parsed") {
+    add_endpoint_digests(j);
+    std::string path = write_temp_json(j, "replicas");
+    auto result = EndpointRegistry::LoadFromJson(path);
+    REQUIRE(std::holds_alternative<EndpointRegistry>(result));
+
+    const auto* ep = std::get<EndpointRegistry>(result).by_id("ep_0001");
+    REQUIRE(ep->replicas.size() == 2);
+    REQUIRE(ep->replicas[1].host == "10.0.0.3");
+    REQUIRE(ep->replicas[1].port == 6380);
+    REQUIRE(ep->policy.hedge_percentile == 95);
+    REQUIRE(ep->policy.hedge_budget_pct == 5);
+  }
+
+  SECTION("replicas are part of the config digest") {
+    add_endpoint_digests(j);
+    j["endpoints"][0]["resolver"]["replicas"][0]["port"] = 6381;
+    std::string path = write_temp_json(j, "replicas_digest");
+    auto result = EndpointRegistry::LoadFromJson(path);
+    REQUIRE(std::holds_alternative<std::string>(result));
+    REQUIRE(std::get<std::string>(result).find("config_digest mismatch") != std::string::npos);
+  }
+
+  SECTION("replica ports are validated") {
+    j["endpoints"][0]["resolver"]["replicas"][0]["port"] = 0;
+    add_endpoint_digests(j);
+    std::string path = write_temp_json(j, "replicas_port");
+    auto result = EndpointRegistry::LoadFromJson(path);
+    REQUIRE(std::holds_alternative<std::string>(result));
+    REQUIRE(std::get<std::string>(result).find("invalid replica port") != std::string::npos);
+  }
+}
+
 TEST_CASE("EndpointRegistry rejects env mismatch", "[endpoint_registry]") {
   nlohmann::json j = {
     {"schema_version", 1},
@@ -1,11 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <future>
+#include <memory>
 #include <thread>
 #include <vector>
 
+#include "cancellation.h"
 #include "coro_task.h"
 #include "event_loop.h"
 #include "uv_sleep.h"
@@ -76,6 +79,36 @@ TEST_CASE("EventLoop basic post", "[event_loop]") {
   loop.Stop();
 }
 
+TEST_CASE("Post accepts move-only and oversized callables", "[event_loop]") {
+  EventLoop loop;
+  loop.Start();
+
+  std::promise<int> small_done;
+  std::promise<int> large_done;
+  auto small_f = small_done.get_future();
+  auto large_f = large_done.get_future();
+
+  // Move-only capture, stored inline
+  auto value = std::make_unique<int>(7);
+  REQUIRE(loop.Post([&small_done, value = std::move(value)]() { small_done.set_value(*value); }));
+
+  // Captures larger than PostCallback::kInlineBytes go to the heap
+  std::array<int, 32> big{};
+  big[31] = 9;
+  REQUIRE(loop.Post([&large_done, big]() { large_done.set_value(big[31]); }));
+
+  REQUIRE(small_f.get() == 7);
+  REQUIRE(large_f.get() == 9);
+
+  loop.Stop();
+
+  // A rejected callable is destroyed without running
+  auto owned = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = owned;
+  REQUIRE_FALSE(loop.Post([owned = std::move(owned)]() { *owned = 1; }));
+  REQUIRE(weak.expired());
+}
+
 TEST_CASE("EventLoop multiple posts", "[event_loop]") {
   EventLoop loop;
   loop.Start();
@@ -216,6 +249,70 @@ TEST_CASE("Exception propagation in coroutine", "[event_loop][coroutine]") {
   loop.Stop();
 }
 
+TEST_CASE("CancellationSource runs callbacks once, in order", "[event_loop][cancel]") {
+  CancellationSource source;
+  CancellationToken token = source.token();
+  std::vector<int> order;
+
+  auto first = token.on_cancel([&] { order.push_back(1); });
+  auto dropped = token.on_cancel([&] { order.push_back(2); });
+  CancellationToken::Registration late;
+  // A callback may drop a later registration and register nothing new
+  auto third = token.on_cancel([&] {
+    order.push_back(3);
+    late = token.on_cancel([&] { order.push_back(4); });
+  });
+  dropped.reset();
+
+  REQUIRE_FALSE(token.cancelled());
+  source.cancel();
+  source.cancel();
+  REQUIRE(token.cancelled());
+  REQUIRE(order == std::vector<int>{1, 3});
+
+  // Default tokens never cancel
+  CancellationToken none;
+  REQUIRE_FALSE(none.can_cancel());
+  auto reg = none.on_cancel([&] { order.push_back(5); });
+  REQUIRE(order.size() == 2);
+}
+
+TEST_CASE("Cancelled SleepMs wakes early", "[event_loop][coroutine][cancel]") {
+  EventLoop loop;
+  loop.Start();
+  CancellationSource source;
+
+  auto sleeper = [&]() -> Task<int> {
+    co_await SleepMs(loop, 5000, source.token());
+    // Sleeping on an already cancelled token does not suspend
+    co_await SleepMs(loop, 5000, source.token());
+    co_return 7;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  loop.Post([&] {
+    // Fires after the sleeper has registered its timer
+    auto* timer = new uv_timer_t;
+    uv_timer_init(loop.RawLoop(), timer);
+    timer->data = &source;
+    uv_timer_start(
+        timer,
+        [](uv_timer_t* t) {
+          static_cast<CancellationSource*>(t->data)->cancel();
+          uv_close(reinterpret_cast<uv_handle_t*>(t),
+                   [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
+        },
+        20, 0);
+  });
+  int result = blockingWaitValue(loop, sleeper());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  REQUIRE(result == 7);
+  REQUIRE(elapsed < std::chrono::milliseconds(1000));
+
+  loop.Stop();
+}
+
 TEST_CASE("Zero sleep completes immediately", "[event_loop][coroutine]") {
   EventLoop loop;
   loop.Start();
@@ -746,6 +843,136 @@ TEST_CASE("Rapid timer creation and cancellation", "[event_loop][stress][corouti
   loop.Stop();
 }
 
+// Timer wheel entries fired so far, in order
+struct WheelProbe {
+  std::vector<int> fired;
+  std::promise<void> done;
+  size_t expected = 0;
+  TimerWheel::Entry entries[5];
+};
+
+static void OnWheelProbe(TimerWheel::Entry* e) {
+  auto* probe = static_cast<WheelProbe*>(e->data);
+  probe->fired.push_back(static_cast<int>(e - probe->entries));
+  if (probe->fired.size() == probe->expected) {
+    probe->done.set_value();
+  }
+}
+
+TEST_CASE("TimerWheel fires by expiry and skips cancelled entries", "[event_loop][timer_wheel]") {
+  EventLoop loop;
+  loop.Start();
+
+  WheelProbe probe;
+  probe.expected = 3;
+  auto done_future = probe.done.get_future();
+  for (auto& entry : probe.entries) {
+    entry.data = &probe;
+  }
+
+  size_t armed = 0;
+  loop.Post([&]() {
+    auto& timers = loop.Timers();
+    timers.schedule(probe.entries[0], 30, OnWheelProbe);
+    timers.schedule(probe.entries[1], 10, OnWheelProbe);
+    timers.schedule(probe.entries[2], 20, OnWheelProbe);
+    timers.schedule(probe.entries[3], 15, OnWheelProbe);
+    timers.schedule(probe.entries[4], 60'000, OnWheelProbe);  // Many laps out
+    probe.entries[3].cancel();
+    probe.entries[3].cancel();  // Idempotent
+    armed = timers.size();
+  });
+
+  REQUIRE(done_future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+  std::promise<size_t> remaining;
+  auto remaining_future = remaining.get_future();
+  loop.Post([&]() {
+    size_t left = loop.Timers().size();
+    probe.entries[4].cancel();
+    remaining.set_value(left);
+  });
+
+  REQUIRE(armed == 4);
+  REQUIRE(probe.fired == std::vector<int>{1, 2, 0});
+  REQUIRE(remaining_future.get() == 1);  // Only the far entry is still armed
+  REQUIRE_FALSE(probe.entries[3].armed());
+  loop.Stop();
+}
+
+// Re-arms its entry from the callback until `remaining` runs out
+struct WheelRearm {
+  EventLoop* loop;
+  TimerWheel::Entry entry;
+  int remaining = 3;
+  std::promise<void> done;
+};
+
+static void OnWheelRearm(TimerWheel::Entry* e) {
+  auto* rearm = static_cast<WheelRearm*>(e->data);
+  if (--rearm->remaining > 0) {
+    rearm->loop->Timers().schedule(rearm->entry, 0, OnWheelRearm);  // Next tick
+  } else {
+    rearm->done.set_value();
+  }
+}
+
+TEST_CASE("TimerWheel re-arms from its own callback", "[event_loop][timer_wheel]") {
+  EventLoop loop;
+  loop.Start();
+
+  WheelRearm rearm{&loop};
+  rearm.entry.data = &rearm;
+  auto done_future = rearm.done.get_future();
+  loop.Post([&]() { loop.Timers().schedule(rearm.entry, 0, OnWheelRearm); });
+
+  REQUIRE(done_future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+  REQUIRE(rearm.remaining == 0);
+  REQUIRE_FALSE(rearm.entry.armed());
+  loop.Stop();
+}
+
+TEST_CASE("TimerWheel wakes only when an entry is due", "[event_loop][timer_wheel]") {
+  EventLoop loop;
+  loop.Start();
+
+  WheelProbe probe;
+  probe.expected = 1;
+  auto done_future = probe.done.get_future();
+  for (auto& entry : probe.entries) {
+    entry.data = &probe;
+  }
+
+  // Only a far-future entry: the loop should not wake for it
+  uint64_t ticks_start = 0;
+  loop.Post([&]() {
+    ticks_start = loop.Timers().ticks();
+    loop.Timers().schedule(probe.entries[0], 60'000, OnWheelProbe);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // A nearer entry moves the wakeup forward
+  std::promise<uint64_t> idle_ticks;
+  auto idle_future = idle_ticks.get_future();
+  loop.Post([&]() {
+    idle_ticks.set_value(loop.Timers().ticks() - ticks_start);
+    loop.Timers().schedule(probe.entries[1], 20, OnWheelProbe);
+  });
+  REQUIRE(done_future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+  std::promise<uint64_t> fired_ticks;
+  auto fired_future = fired_ticks.get_future();
+  loop.Post([&]() {
+    fired_ticks.set_value(loop.Timers().ticks() - ticks_start);
+    probe.entries[0].cancel();
+  });
+
+  REQUIRE(idle_future.get() == 0);
+  REQUIRE(probe.fired == std::vector<int>{1});
+  REQUIRE(fired_future.get() <= 2);  // Not one per millisecond
+  loop.Stop();
+}
+
 TEST_CASE("Nested Post from callback", "[event_loop][edge_case]") {
   EventLoop loop;
   loop.Start();
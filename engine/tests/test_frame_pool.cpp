@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "coro_task.h"
+#include "frame_pool.h"
+
+#include <memory>
+#include <thread>
+
+using namespace ranking;
+
+namespace {
+
+Task<int> frame_pool_leaf(int x) { co_return x + 1; }
+
+Task<int> frame_pool_parent(int x) { co_return co_await frame_pool_leaf(x) * 2; }
+
+} // namespace
+
+TEST_CASE("FramePool size classes", "[frame_pool]") {
+  constexpr size_t kNone = FramePool::kNumClasses;
+
+  REQUIRE(FramePool::classIndex(1) == 0);
+  REQUIRE(FramePool::classIndex(64) == 0);
+  REQUIRE(FramePool::classIndex(65) == 1);
+  REQUIRE(FramePool::classBytes(1) == 128);
+  REQUIRE(FramePool::classIndex(8192) == kNone - 1);
+
+  // Bypass: too large
+  REQUIRE(FramePool::classIndex(8193) == kNone);
+}
+
+TEST_CASE("FramePool recycles freed blocks", "[frame_pool]") {
+  auto &pool = FramePool::instance();
+  pool.trim();
+  size_t saved_limit = pool.threadCacheLimit();
+  pool.setThreadCacheLimit(FramePool::kDefaultThreadCacheBlocks);
+
+  SECTION("same size class is served from the thread cache") {
+    void *a = pool.allocate(300);
+    pool.deallocate(a, 300);
+
+    uint64_t system = pool.systemAllocations();
+    void *b = pool.allocate(400); // same 512 B class
+    REQUIRE(b == a);
+    REQUIRE(pool.systemAllocations() == system);
+    pool.deallocate(b, 400);
+  }
+
+  SECTION("a zero limit disables pooling") {
+    pool.setThreadCacheLimit(0);
+    void *a = pool.allocate(300);
+    pool.deallocate(a, 300); // released
+
+    uint64_t system = pool.systemAllocations();
+    void *b = pool.allocate(300);
+    REQUIRE(pool.systemAllocations() == system + 1);
+    pool.deallocate(b, 300);
+  }
+
+  SECTION("blocks freed on another thread stay usable") {
+    void *a = pool.allocate(200);
+    std::thread([&] { pool.deallocate(a, 200); }).join();
+    void *b = pool.allocate(200);
+    pool.deallocate(b, 200);
+  }
+
+  pool.trim();
+  pool.setThreadCacheLimit(saved_limit);
+}
+
+TEST_CASE("Task frames and pooled states come from FramePool",
+          "[frame_pool]") {
+  auto &pool = FramePool::instance();
+  pool.trim();
+  size_t saved_limit = pool.threadCacheLimit();
+  pool.setThreadCacheLimit(FramePool::kDefaultThreadCacheBlocks);
+
+  auto run = [] {
+    auto task = frame_pool_parent(20);
+    task.start();
+    return task.result();
+  };
+
+  uint64_t allocs = pool.allocations();
+  REQUIRE(run() == 42);
+  // Parent and leaf frames (the compiler may elide the leaf's)
+  REQUIRE(pool.allocations() >= allocs + 1);
+
+  // Warm cache: the second run reuses both frames
+  uint64_t system = pool.systemAllocations();
+  REQUIRE(run() == 42);
+  REQUIRE(pool.systemAllocations() == system);
+
+  struct State {
+    int value = 7;
+  };
+  allocs = pool.allocations();
+  auto state = make_pooled_shared<State>();
+  REQUIRE(state->value == 7);
+  REQUIRE(pool.allocations() == allocs + 1); // control block + state
+  state.reset();
+
+  pool.trim();
+  pool.setThreadCacheLimit(saved_limit);
+}
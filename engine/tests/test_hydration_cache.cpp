@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "hydration_cache.h"
+
+#include <thread>
+
+using namespace rankd;
+
+namespace {
+
+// Restores the process-wide cache configuration after each test
+struct CacheScope {
+  HydrationCache &cache = HydrationCache::instance();
+  size_t saved_capacity = cache.capacity();
+  std::chrono::milliseconds saved_ttl = cache.ttl();
+
+  CacheScope() { cache.clear(); }
+  ~CacheScope() {
+    cache.clear();
+    cache.setCapacity(saved_capacity);
+    cache.setTtl(saved_ttl);
+  }
+};
+
+constexpr uint32_t kCountry = 3001;
+constexpr std::string_view kEndpoint = "ep_0001";
+
+} // namespace
+
+TEST_CASE("HydrationCache hits, misses and negative entries", "[hydration_cache]") {
+  CacheScope scope;
+  auto &cache = scope.cache;
+  cache.setCapacity(1000);
+  cache.setTtl(std::chrono::seconds(60));
+
+  std::optional<std::string> value;
+  uint64_t misses = cache.misses();
+  REQUIRE_FALSE(cache.lookup(kEndpoint, 1, kCountry, value));
+  REQUIRE(cache.misses() == misses + 1);
+
+  cache.insert(kEndpoint, 1, kCountry, "US");
+  cache.insert(kEndpoint, 2, kCountry, std::nullopt); // missing user
+
+  uint64_t hits = cache.hits();
+  REQUIRE(cache.lookup(kEndpoint, 1, kCountry, value));
+  REQUIRE(value == "US");
+
+  uint64_t negative_hits = cache.negativeHits();
+  value = "stale";
+  REQUIRE(cache.lookup(kEndpoint, 2, kCountry, value));
+  REQUIRE_FALSE(value.has_value());
+  REQUIRE(cache.hits() == hits + 2);
+  REQUIRE(cache.negativeHits() == negative_hits + 1);
+
+  SECTION("lookupMany returns the missed indices") {
+    std::vector<int64_t> ids = {1, 3, 2, 4};
+    std::vector<std::optional<std::string>> values(ids.size());
+    auto missed = cache.lookupMany(kEndpoint, ids, kCountry, values);
+    REQUIRE(missed == std::vector<size_t>{1, 3});
+    REQUIRE(values[0] == "US");
+    REQUIRE_FALSE(values[2].has_value());
+  }
+
+  SECTION("disabled cache misses everything") {
+    cache.setCapacity(0);
+    std::vector<int64_t> ids = {1, 2};
+    std::vector<std::optional<std::string>> values(ids.size());
+    REQUIRE(cache.lookupMany(kEndpoint, ids, kCountry, values).size() == 2);
+    cache.insert(kEndpoint, 5, kCountry, "FR");
+    cache.setCapacity(1000);
+    REQUIRE_FALSE(cache.lookup(kEndpoint, 5, kCountry, value));
+  }
+}
+
+TEST_CASE("HydrationCache is off by default and keyed by endpoint",
+          "[hydration_cache]") {
+  STATIC_REQUIRE(HydrationCache::kDefaultCapacity == 0);
+
+  CacheScope scope;
+  auto &cache = scope.cache;
+  cache.setCapacity(1000);
+  cache.setTtl(std::chrono::seconds(60));
+
+  cache.insert("ep_0001", 1, kCountry, "US");
+  cache.insert("ep_0002", 2, kCountry, std::nullopt);
+
+  std::optional<std::string> value;
+  REQUIRE(cache.lookup("ep_0001", 1, kCountry, value));
+  REQUIRE(value == "US");
+  REQUIRE_FALSE(cache.lookup("ep_0002", 1, kCountry, value));
+  REQUIRE_FALSE(cache.lookup("ep_0001", 2, kCountry, value));
+
+  std::vector<int64_t> ids = {1, 2};
+  std::vector<std::optional<std::string>> values(ids.size());
+  REQUIRE(cache.lookupMany("ep_0002", ids, kCountry, values) ==
+          std::vector<size_t>{0});
+}
+
+TEST_CASE("HydrationCache expires entries after the TTL", "[hydration_cache]") {
+  CacheScope scope;
+  auto &cache = scope.cache;
+  cache.setCapacity(1000);
+  cache.setTtl(std::chrono::milliseconds(20));
+
+  cache.insert(kEndpoint, 1, kCountry, "US");
+  std::optional<std::string> value;
+  REQUIRE(cache.lookup(kEndpoint, 1, kCountry, value));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  REQUIRE_FALSE(cache.lookup(kEndpoint, 1, kCountry, value));
+
+  uint64_t expirations = cache.expirations();
+  cache.insert(kEndpoint, 1, kCountry, "CA");
+  REQUIRE(cache.expirations() == expirations + 1);
+  REQUIRE(cache.lookup(kEndpoint, 1, kCountry, value));
+  REQUIRE(value == "CA");
+}
+
+TEST_CASE("HydrationCache stays within capacity", "[hydration_cache]") {
+  CacheScope scope;
+  auto &cache = scope.cache;
+  cache.setCapacity(HydrationCache::kNumShards * 4);
+  cache.setTtl(std::chrono::seconds(60));
+
+  uint64_t evictions = cache.evictions();
+  for (int64_t id = 0; id < 1000; ++id) {
+    cache.insert(kEndpoint, id, kCountry, "US");
+  }
+  REQUIRE(cache.size() <= cache.capacity());
+  REQUIRE(cache.evictions() - evictions == 1000 - cache.size());
+}
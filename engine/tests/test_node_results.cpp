@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "node_results.h"
+
+#include <memory>
+#include <vector>
+
+using namespace rankd;
+
+namespace {
+
+// Bytes of a batch's buffers (just the id column for a fresh batch)
+size_t batchBytes(const ColumnBatch &batch) {
+  size_t bytes = 0;
+  batch.forEachBuffer([&](const void *, size_t b) { bytes += b; });
+  return bytes;
+}
+
+} // namespace
+
+TEST_CASE("NodeResults releases a result after its last consumer",
+          "[node_results]") {
+  // 0 -> 1 -> 3 (output)
+  // 0 -> 2 -> 3
+  NodeResults results(4);
+  results.addEdge(0, 1);
+  results.addEdge(0, 2);
+  results.addEdge(1, 3);
+  results.addEdge(2, 3);
+  results.addOutput(3);
+
+  auto batch = std::make_shared<const ColumnBatch>(1000);
+  std::weak_ptr<const ColumnBatch> source_batch = batch;
+  size_t id_bytes = batchBytes(*batch);
+
+  results.complete(0, RowSet(std::move(batch)));
+  REQUIRE(results.workingSetBytes() == id_bytes);
+
+  // Same batch, new selection: the shared id column is counted once
+  results.complete(1, results.get(0).withSelection(SelectionVector{1, 2, 3}));
+  REQUIRE(results.has(0));
+  REQUIRE(results.workingSetBytes() == id_bytes + 3 * sizeof(RowIndex));
+
+  // Fresh batch: node 0's last consumer finishes and it is dropped
+  results.complete(2, RowSet(std::make_shared<const ColumnBatch>(10)));
+  REQUIRE_FALSE(results.has(0));
+  REQUIRE(results.has(1));
+
+  results.complete(3, RowSet(std::make_shared<const ColumnBatch>(10)));
+  REQUIRE_FALSE(results.has(1));
+  REQUIRE_FALSE(results.has(2));
+  REQUIRE(results.has(3)); // Plan output
+  REQUIRE(results.peakWorkingSetBytes() >= id_bytes + 3 * sizeof(RowIndex));
+  REQUIRE(source_batch.expired());
+}
+
+TEST_CASE("NodeResults drops results nobody reads", "[node_results]") {
+  // 0 -> 1 (output), 0 -> 2 (dead end)
+  NodeResults results(3);
+  results.addEdge(0, 1);
+  results.addEdge(0, 2);
+  results.addOutput(1);
+
+  results.complete(0, RowSet(std::make_shared<const ColumnBatch>(100)));
+  results.complete(2, RowSet(std::make_shared<const ColumnBatch>(100)));
+  REQUIRE_FALSE(results.has(2));
+  REQUIRE(results.has(0)); // Node 1 has not run yet
+
+  results.complete(1, RowSet(std::make_shared<const ColumnBatch>(100)));
+  REQUIRE_FALSE(results.has(0));
+  REQUIRE(results.has(1));
+  REQUIRE(results.workingSetBytes() == batchBytes(results.get(1).batch()));
+}
@@ -158,3 +158,31 @@ TEST_CASE("writes_eval keys are always sorted and unique", "[writes_eval][plan_i
     }
   }
 }
+
+TEST_CASE("live_keys drive source field projection", "[live_keys][plan_info]") {
+  Plan plan = parse_plan("engine/tests/fixtures/plan_info/vm_and_row_ops.plan.json");
+
+  // Unvalidated plans treat every key as live
+  for (const auto& node : plan.nodes) {
+    REQUIRE(node.live_keys == nullptr);
+  }
+
+  validate_plan(plan, &get_test_endpoint_registry());
+
+  SECTION("viewer feeding only follow needs no hydrated fields") {
+    // follow builds a fresh batch from the viewer's IDs and reads no keys
+    const Node* viewer = find_node_by_op(plan, "core::viewer");
+    REQUIRE(viewer != nullptr);
+    REQUIRE(viewer->live_keys != nullptr);
+    REQUIRE(viewer->live_keys->empty());
+  }
+
+  SECTION("nodes whose columns reach the output keep every key live") {
+    for (const char* op : {"core::follow", "core::vm", "core::filter", "core::take"}) {
+      const Node* node = find_node_by_op(plan, op);
+      INFO("Checking op: " << op);
+      REQUIRE(node != nullptr);
+      REQUIRE(node->live_keys == nullptr);
+    }
+  }
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "redis_connection_pool.h"
+
+using namespace rankd;
+
+namespace {
+
+EndpointSpec make_endpoint(int port) {
+  EndpointSpec spec;
+  spec.endpoint_id = "ep_pool_test";
+  spec.name = "pool_test";
+  spec.kind = EndpointKind::Redis;
+  spec.resolver_type = ResolverType::Static;
+  spec.static_resolver.host = "127.0.0.1";
+  spec.static_resolver.port = port;
+  spec.policy.connect_timeout_ms = 100;
+  spec.policy.request_timeout_ms = 100;
+  return spec;
+}
+
+// Restores the process-wide pool configuration after each test
+struct PoolScope {
+  RedisConnectionPool &pool = RedisConnectionPool::instance();
+  size_t saved_max_idle = pool.maxIdle();
+
+  PoolScope() { pool.clear(); }
+  ~PoolScope() {
+    pool.clear();
+    pool.setMaxIdle(saved_max_idle);
+  }
+};
+
+} // namespace
+
+TEST_CASE("RedisConnectionPool drops unusable connections", "[redis_pool]") {
+  PoolScope scope;
+  auto &pool = scope.pool;
+  auto endpoint = make_endpoint(59999); // Nothing listens here
+
+  uint64_t creates = pool.creates();
+  auto client = pool.checkout(endpoint);
+  REQUIRE(client);
+  REQUIRE(pool.creates() == creates + 1);
+
+  // Never connected: not kept
+  pool.checkin(endpoint, std::move(client));
+  REQUIRE(pool.idleCount() == 0);
+
+  // Failed health check leaves the client disconnected: not kept
+  client = pool.checkout(endpoint);
+  REQUIRE_FALSE(client->ping());
+  pool.checkin(endpoint, std::move(client));
+  REQUIRE(pool.idleCount() == 0);
+}
+
+TEST_CASE("RedisConnectionPool reuses open connections", "[redis_pool][redis]") {
+  PoolScope scope;
+  auto &pool = scope.pool;
+  pool.setMaxIdle(1);
+  auto endpoint = make_endpoint(6379);
+
+  auto a = pool.checkout(endpoint);
+  auto b = pool.checkout(endpoint);
+  if (!a->ping() || !b->ping()) {
+    WARN("Redis not available: " << a->last_error());
+    return;
+  }
+
+  RedisClient *first = a.get();
+  pool.checkin(endpoint, std::move(a));
+  pool.checkin(endpoint, std::move(b)); // Over maxIdle: closed
+  REQUIRE(pool.idleCount() == 1);
+
+  uint64_t reuses = pool.reuses();
+  auto again = pool.checkout(endpoint);
+  REQUIRE(again.get() == first);
+  REQUIRE(again->connected());
+  REQUIRE(pool.reuses() == reuses + 1);
+  REQUIRE(pool.idleCount() == 0);
+
+  SECTION("a different address never shares connections") {
+    pool.checkin(endpoint, std::move(again));
+    auto other = pool.checkout(make_endpoint(6380));
+    REQUIRE(other.get() != first);
+    REQUIRE(pool.idleCount() == 1);
+  }
+
+  SECTION("disabled pool always creates") {
+    pool.setMaxIdle(0);
+    pool.checkin(endpoint, std::move(again));
+    REQUIRE(pool.idleCount() == 0);
+  }
+}
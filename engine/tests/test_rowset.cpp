@@ -1,7 +1,10 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "column_batch.h"
+#include "output_contract.h"
 #include "param_table.h"
+#include "plan.h"
+#include "request_arena.h"
 #include "rowset.h"
 #include "task_registry.h"
 
@@ -216,3 +219,341 @@ TEST_CASE("RowSet truncateTo works correctly", "[rowset]") {
     REQUIRE(truncated.batchPtr().get() == rs.batchPtr().get());
   }
 }
+
+TEST_CASE("RowSet copies share selection and order buffers", "[rowset]") {
+  auto batch = std::make_shared<ColumnBatch>(10);
+
+  SECTION("copy shares buffers instead of copying indices") {
+    RowSet rs = RowSet(batch)
+                    .withSelection(SelectionVector{1, 3, 5, 7})
+                    .withOrder(Permutation{7, 5, 3, 1});
+    RowSet copy = rs;
+
+    REQUIRE(copy.selectionBuffer().get() == rs.selectionBuffer().get());
+    REQUIRE(copy.orderBuffer().get() == rs.orderBuffer().get());
+    REQUIRE(copy.materializeIndexViewForOutput(100) ==
+            rs.materializeIndexViewForOutput(100));
+  }
+
+  SECTION("builders take ownership without copying") {
+    SelectionVector sel{0, 2, 4};
+    const RowIndex *data = sel.data();
+    RowSet rs = RowSet(batch).withSelection(std::move(sel));
+
+    REQUIRE(rs.selectionBuffer()->data() == data);
+  }
+
+  SECTION("builders share the buffer they do not replace") {
+    RowSet rs = RowSet(batch).withSelection(SelectionVector{0, 2, 4});
+    RowSet ordered = rs.withOrder(Permutation{4, 2, 0});
+    RowSet rebatched = ordered.withBatch(std::make_shared<ColumnBatch>(10));
+
+    REQUIRE(ordered.selectionBuffer().get() == rs.selectionBuffer().get());
+    REQUIRE(rebatched.selectionBuffer().get() == rs.selectionBuffer().get());
+    REQUIRE(rebatched.orderBuffer().get() == ordered.orderBuffer().get());
+  }
+
+  SECTION("withSelectionClearOrder drops the order buffer") {
+    RowSet rs = RowSet(batch).withOrder(Permutation{2, 1, 0});
+    RowSet filtered = rs.withSelectionClearOrder(SelectionVector{0, 1});
+
+    REQUIRE_FALSE(filtered.hasOrder());
+    REQUIRE(filtered.orderBuffer() == nullptr);
+    REQUIRE(rs.hasOrder());
+  }
+}
+
+TEST_CASE("RowSet caches the composed selection+order view", "[rowset]") {
+  auto batch = std::make_shared<ColumnBatch>(10);
+  RowSet rs = RowSet(batch)
+                  .withSelection(SelectionVector{0, 2, 4, 6, 8})
+                  .withOrder(Permutation{9, 8, 7, 6, 5, 4, 3, 2, 1, 0});
+
+  SECTION("composed view is built once and reused") {
+    const auto *first = rs.activeRows().indices();
+    REQUIRE(first != nullptr);
+    REQUIRE(*first == std::vector<RowIndex>{8, 6, 4, 2, 0});
+    REQUIRE(rs.logicalSize() == 5);
+    REQUIRE(rs.activeRows().indices() == first);
+  }
+
+  SECTION("copies and rebatching share the composed view") {
+    RowSet copy = rs;
+    RowSet rebatched = rs.withBatch(std::make_shared<ColumnBatch>(10));
+    REQUIRE(copy.activeRows().indices() == rs.activeRows().indices());
+    REQUIRE(rebatched.activeRows().indices() == rs.activeRows().indices());
+  }
+
+  SECTION("replacing selection or order recomposes") {
+    RowSet narrowed = rs.withSelection(SelectionVector{4, 6});
+    REQUIRE(narrowed.materializeIndexViewForOutput(100) == std::vector<RowIndex>{6, 4});
+    RowSet reordered = rs.withOrder(Permutation{0, 2, 4, 6, 8});
+    REQUIRE(reordered.materializeIndexViewForOutput(100) ==
+            std::vector<RowIndex>{0, 2, 4, 6, 8});
+    REQUIRE(rs.materializeIndexViewForOutput(100) == std::vector<RowIndex>{8, 6, 4, 2, 0});
+  }
+
+  SECTION("truncateTo within limit shares the selection buffer") {
+    RowSet filtered = RowSet(batch).withSelection(SelectionVector{1, 3, 5});
+    RowSet truncated = filtered.truncateTo(10);
+    REQUIRE(truncated.selectionBuffer().get() == filtered.selectionBuffer().get());
+  }
+}
+
+TEST_CASE("SelectionBitmap selection representation", "[rowset]") {
+  auto batch = std::make_shared<ColumnBatch>(130);
+
+  SECTION("bitmap iterates set rows in ascending order") {
+    SelectionBitmap bits(130);
+    bits.set(129);
+    bits.set(0);
+    bits.set(64);
+    bits.set(64); // idempotent
+    RowSet rs = RowSet(batch).withSelection(std::move(bits));
+
+    REQUIRE(rs.hasSelection());
+    REQUIRE(rs.selectionBuffer() == nullptr);
+    REQUIRE(rs.logicalSize() == 3);
+    REQUIRE(rs.materializeIndexViewForOutput(100) == std::vector<RowIndex>{0, 64, 129});
+    REQUIRE(rs.materializeIndexViewForOutput(2) == std::vector<RowIndex>{0, 64});
+  }
+
+  SECTION("order composes with bitmap membership") {
+    auto bits = SelectionBitmap::fromIndices({1, 3, 5}, 130);
+    RowSet rs = RowSet(batch).withSelection(std::move(bits)).withOrder(
+        Permutation{6, 5, 4, 3, 2, 1, 0});
+
+    REQUIRE(rs.selectionBitmap() != nullptr);
+    REQUIRE(rs.materializeIndexViewForOutput(100) == std::vector<RowIndex>{5, 3, 1});
+    REQUIRE(rs.logicalSize() == 3);
+  }
+
+  SECTION("truncateTo turns a bitmap prefix into an index selection") {
+    auto bits = SelectionBitmap::fromIndices({2, 4, 6, 8}, 130);
+    RowSet rs = RowSet(batch).withSelectionClearOrder(std::move(bits));
+
+    RowSet truncated = rs.truncateTo(2);
+    REQUIRE(truncated.selectionBitmap() == nullptr);
+    REQUIRE(truncated.materializeIndexViewForOutput(100) == std::vector<RowIndex>{2, 4});
+    REQUIRE(rs.truncateTo(4).selectionBitmap() == rs.selectionBitmap());
+  }
+
+  SECTION("density threshold") {
+    REQUIRE(preferSelectionBitmap(32, 1024));
+    REQUIRE_FALSE(preferSelectionBitmap(31, 1024));
+  }
+}
+
+TEST_CASE("filter picks selection representation by density", "[rowset][task]") {
+  auto &registry = TaskRegistry::instance();
+
+  const size_t n = 1000;
+  auto batch = std::make_shared<ColumnBatch>(n);
+  for (size_t i = 0; i < n; ++i) {
+    batch->setId(i, static_cast<int64_t>(i));
+  }
+
+  // id < threshold
+  auto make_pred = [](double threshold) {
+    auto id_ref = std::make_shared<ExprNode>();
+    id_ref->op = "key_ref";
+    id_ref->key_id = 1;
+    auto limit = std::make_shared<ExprNode>();
+    limit->op = "const_number";
+    limit->const_value = threshold;
+    auto pred = std::make_shared<PredNode>();
+    pred->op = "cmp";
+    pred->cmp_op = "<";
+    pred->value_a = id_ref;
+    pred->value_b = limit;
+    return pred;
+  };
+
+  std::unordered_map<std::string, PredNodePtr> preds{{"dense", make_pred(900)},
+                                                     {"sparse", make_pred(10)}};
+  ExecCtx ctx;
+  ctx.pred_table = &preds;
+
+  auto run_filter = [&](const RowSet &input, const std::string &pred_id) {
+    nlohmann::json params_json;
+    params_json["pred_id"] = pred_id;
+    auto params = registry.validate_params("core::filter", params_json);
+    RowSet out = registry.execute("core::filter", {input}, params, ctx);
+    validateTaskOutput("n1", "core::filter", OutputPattern::StableFilter, {input}, params, out);
+    return out;
+  };
+
+  SECTION("high selectivity keeps a bitmap") {
+    RowSet out = run_filter(RowSet(batch), "dense");
+    REQUIRE(out.selectionBitmap() != nullptr);
+    REQUIRE(out.logicalSize() == 900);
+  }
+
+  SECTION("low selectivity keeps an index vector") {
+    RowSet out = run_filter(RowSet(batch), "sparse");
+    REQUIRE(out.selectionBuffer() != nullptr);
+    REQUIRE(out.materializeIndexViewForOutput(100) ==
+            std::vector<RowIndex>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+  }
+
+  SECTION("refining a bitmap selection") {
+    RowSet dense = run_filter(RowSet(batch), "dense");
+    RowSet out = run_filter(dense, "sparse");
+    REQUIRE(out.selectionBuffer() != nullptr);
+    REQUIRE(out.logicalSize() == 10);
+  }
+
+  SECTION("ordered input keeps iteration order") {
+    Permutation reversed(n);
+    for (size_t i = 0; i < n; ++i) {
+      reversed[i] = static_cast<RowIndex>(n - 1 - i);
+    }
+    RowSet out = run_filter(RowSet(batch).withOrder(std::move(reversed)), "sparse");
+    REQUIRE(out.materializeIndexViewForOutput(3) == std::vector<RowIndex>{9, 8, 7});
+  }
+}
+
+TEST_CASE("Structural output validation uses builder provenance", "[rowset][contract]") {
+  auto batch = std::make_shared<ColumnBatch>(8);
+  RowSet input = RowSet(batch).withSelection(SelectionVector{1, 3, 5, 7});
+  ValidatedParams params;
+  params.int_params["count"] = 2;
+  auto &validation = OutputValidation::instance();
+  uint64_t fallbacks = validation.structuralFallbacks();
+
+  SECTION("refinement builder outputs are accepted without the full check") {
+    RowSet filtered = input.filterActive([](RowIndex idx) { return idx == 3 || idx == 7; });
+    RowSet sorted = input.sortActive([](RowIndex a, RowIndex b) { return a > b; });
+    RowSet prefix = input.truncateTo(2);
+    REQUIRE(filtered.derivedFrom(input));
+    REQUIRE_FALSE(filtered.derivedFrom(RowSet(batch)));
+    REQUIRE(filtered.materializeIndexViewForOutput(8) == std::vector<RowIndex>{3, 7});
+    REQUIRE(sorted.materializeIndexViewForOutput(8) == std::vector<RowIndex>{7, 5, 3, 1});
+
+    validateTaskOutput("n1", "core::filter", OutputPattern::StableFilter, {input}, params,
+                       filtered, false);
+    validateTaskOutput("n1", "core::filter", OutputPattern::StableFilter, {input}, params,
+                       prefix, false);
+    validateTaskOutput("n1", "core::sort", OutputPattern::PermutationOfInput, {input}, params,
+                       sorted, false);
+    validateTaskOutput("n1", "core::sort", OutputPattern::PermutationOfInput, {input}, params,
+                       input, false);
+    validateTaskOutput("n1", "core::take", OutputPattern::PrefixOfInput, {input}, params,
+                       prefix, false);
+    REQUIRE(validation.structuralFallbacks() == fallbacks);
+  }
+
+  SECTION("bad outputs built from the input itself are rejected") {
+    // withSelection*/withOrder take any indices: rows 0 and 2 were never
+    // active in input, and row 1 is duplicated in place of row 3
+    RowSet not_subset = input.withSelectionClearOrder(SelectionVector{0, 2});
+    RowSet reordered = input.withSelectionClearOrder(SelectionVector{7, 1});
+    RowSet duplicate = input.withOrder(Permutation{1, 1, 5, 7});
+    REQUIRE(not_subset.derivation() == RowSet::Derivation::None);
+    REQUIRE(duplicate.derivation() == RowSet::Derivation::None);
+
+    REQUIRE_THROWS(validateTaskOutput("n1", "core::filter", OutputPattern::StableFilter,
+                                      {input}, params, not_subset, false));
+    REQUIRE_THROWS(validateTaskOutput("n1", "core::filter", OutputPattern::StableFilter,
+                                      {input}, params, reordered, false));
+    REQUIRE_THROWS(validateTaskOutput("n1", "core::sort", OutputPattern::PermutationOfInput,
+                                      {input}, params, duplicate, false));
+    // A truncateTo of the wrong length is not the expected prefix
+    REQUIRE_THROWS(validateTaskOutput("n1", "core::take", OutputPattern::PrefixOfInput,
+                                      {input}, params, input.truncateTo(3), false));
+    REQUIRE(validation.structuralFallbacks() == fallbacks + 4);
+  }
+
+  SECTION("unproven outputs fall back to the full check") {
+    // Built from another view: rows 0 and 2 were never active in input
+    RowSet foreign = RowSet(batch).filterActive([](RowIndex idx) { return idx == 0 || idx == 2; });
+    REQUIRE_THROWS(validateTaskOutput("n1", "core::filter", OutputPattern::StableFilter,
+                                      {input}, params, foreign, false));
+
+    // Valid, but withSelection proves nothing
+    RowSet valid = input.withSelectionClearOrder(SelectionVector{1, 5});
+    validateTaskOutput("n1", "core::filter", OutputPattern::StableFilter, {input}, params,
+                       valid, false);
+    REQUIRE(validation.structuralFallbacks() == fallbacks + 2);
+  }
+
+  SECTION("sampled level runs full checks on 1 in N requests") {
+    ValidationLevel saved_level = validation.level();
+    uint64_t saved_every = validation.sampleEvery();
+
+    validation.setLevel(ValidationLevel::Sampled);
+    validation.setSampleEvery(4);
+    int full = 0;
+    for (int i = 0; i < 8; ++i) {
+      full += validation.beginRequest() ? 1 : 0;
+    }
+    REQUIRE(full == 2);
+
+    validation.setLevel(ValidationLevel::Structural);
+    REQUIRE_FALSE(validation.beginRequest());
+    validation.setLevel(ValidationLevel::Full);
+    REQUIRE(validation.beginRequest());
+
+    validation.setLevel(saved_level);
+    validation.setSampleEvery(saved_every);
+  }
+}
+
+TEST_CASE("RequestArena backs request column and selection storage", "[rowset][arena]") {
+  auto &registry = TaskRegistry::instance();
+
+  auto arena = std::make_shared<RequestArena>();
+  std::weak_ptr<RequestArena> arena_ref = arena;
+
+  const size_t n = 256;
+  auto batch = std::make_shared<ColumnBatch>(n, nullptr, arena);
+  for (size_t i = 0; i < n; ++i) {
+    batch->setId(i, static_cast<int64_t>(i));
+  }
+  REQUIRE(batch->resource() == arena.get());
+  REQUIRE(arena->highWaterBytes() >= n * (sizeof(int64_t) + sizeof(uint8_t)));
+
+  // vm: out = id * 2
+  auto id_ref = std::make_shared<ExprNode>();
+  id_ref->op = "key_ref";
+  id_ref->key_id = 1;
+  auto two = std::make_shared<ExprNode>();
+  two->op = "const_number";
+  two->const_value = 2.0;
+  auto mul = std::make_shared<ExprNode>();
+  mul->op = "mul";
+  mul->a = id_ref;
+  mul->b = two;
+  std::unordered_map<std::string, ExprNodePtr> exprs{{"e", mul}};
+
+  ExecCtx ctx;
+  ctx.expr_table = &exprs;
+  ctx.arena = arena;
+
+  nlohmann::json params_json;
+  params_json["out_key"] = static_cast<int>(KeyId::final_score);
+  params_json["expr_id"] = "e";
+  auto params = registry.validate_params("core::vm", params_json);
+
+  size_t before = arena->highWaterBytes();
+  RowSet out = registry.execute("core::vm", {RowSet(batch)}, params, ctx);
+  REQUIRE(arena->highWaterBytes() >= before + n * (sizeof(double) + sizeof(uint8_t)));
+  REQUIRE(out.batch().resource() == arena.get());
+  REQUIRE(out.batch().getFloatCol(static_cast<uint32_t>(KeyId::final_score))->values[10] == 20.0);
+
+  SECTION("batches keep the arena alive after the request drops it") {
+    batch.reset();
+    ctx.arena.reset();
+    arena.reset();
+    REQUIRE_FALSE(arena_ref.expired());
+    REQUIRE(out.batch().getId(255) == 255);
+
+    out = RowSet(std::make_shared<ColumnBatch>(1));
+    REQUIRE(arena_ref.expired());
+  }
+
+  SECTION("default batches stay on the heap") {
+    ColumnBatch heap_batch(4);
+    REQUIRE(heap_batch.resource() == std::pmr::get_default_resource());
+  }
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "work_stealing_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace rankd;
+
+TEST_CASE("WorkStealingPool runs every posted job", "[work_stealing_pool]") {
+  WorkStealingPool pool(4);
+  std::atomic<int> ran{0};
+
+  constexpr int kProducers = 4;
+  constexpr int kJobsPerProducer = 5000;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&] {
+      for (int i = 0; i < kJobsPerProducer; ++i) {
+        pool.post([&ran] { ran.fetch_add(1); });
+      }
+    });
+  }
+  for (auto &t : producers) {
+    t.join();
+  }
+
+  pool.wait_idle();
+  REQUIRE(ran.load() == kProducers * kJobsPerProducer);
+  REQUIRE(pool.in_flight() == 0);
+}
+
+TEST_CASE("WorkStealingPool submit returns results and exceptions",
+          "[work_stealing_pool]") {
+  WorkStealingPool pool(2);
+
+  auto value = pool.submit([] { return 42; });
+  auto failure = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+
+  REQUIRE(value.get() == 42);
+  REQUIRE_THROWS_AS(failure.get(), std::runtime_error);
+}
+
+TEST_CASE("WorkStealingPool survives posted jobs that throw",
+          "[work_stealing_pool]") {
+  WorkStealingPool pool(2);
+  std::atomic<int> ran{0};
+
+  for (int i = 0; i < 100; ++i) {
+    pool.post([&ran, i] {
+      if (i % 2 == 0) {
+        throw std::runtime_error("boom");
+      }
+      ran.fetch_add(1);
+    });
+  }
+
+  // Throwing jobs still count as done, and the workers keep running
+  pool.wait_idle();
+  REQUIRE(pool.in_flight() == 0);
+  REQUIRE(ran.load() == 50);
+
+  auto value = pool.submit([] { return 7; });
+  REQUIRE(value.get() == 7);
+}
+
+TEST_CASE("WorkStealingPool idle workers steal nested jobs",
+          "[work_stealing_pool]") {
+  WorkStealingPool pool(4);
+  std::atomic<int> ran{0};
+  constexpr int kChildren = 64;
+
+  // Children land on the parent's own deque; the other workers must steal
+  // them for the fan-out to finish
+  pool.post([&] {
+    for (int i = 0; i < kChildren; ++i) {
+      pool.post([&ran] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ran.fetch_add(1);
+      });
+    }
+  });
+
+  pool.wait_idle();
+  REQUIRE(ran.load() == kChildren);
+  REQUIRE(pool.steals() > 0);
+}
+
+TEST_CASE("WorkStealingPool destruction runs queued jobs",
+          "[work_stealing_pool]") {
+  std::atomic<int> ran{0};
+  {
+    WorkStealingPool pool(1);
+    pool.post([] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+    for (int i = 0; i < 100; ++i) {
+      pool.post([&ran] { ran.fetch_add(1); });
+    }
+  }
+  REQUIRE(ran.load() == 100);
+}